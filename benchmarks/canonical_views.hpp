@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include <benchmark/benchmark.h>
+
+#include "fixed_point.hpp"
+#include "mandelbrot_fractal_utils.hpp"
+#include "types.hpp"
+#include "zoom_path.hpp"
+
+// Набор видов, на которых сравниваются замеры до и после изменений производительности.
+// Виды и их параметры не меняются: иначе числа разных версий несопоставимы.
+
+struct CanonicalView {
+    std::string_view name;
+    // Центр — десятичная запись любой длины (см. FixedPoint::FromString)
+    std::string_view center_real;
+    std::string_view center_imag;
+    // Ширина вида; высота — по соотношению сторон кадра
+    double span;
+    std::uint32_t max_iterations;
+};
+
+inline constexpr std::array CANONICAL_VIEWS{
+    // Исходный вид приложения: всё множество, много быстро убегающих и внутренних точек
+    CanonicalView{"home", "-0.5", "0.0", 3.5, 500},
+    // Долина морских коньков: граница множества, длинные орбиты
+    CanonicalView{"seahorse", "-0.743643887037151", "0.131825904205330", 5e-3, 2000},
+    // Долина слонов
+    CanonicalView{"elephant", "0.2850", "0.0110", 1e-2, 2000},
+    // Мини-копия периода 12 на вещественной оси у -2 размером около 2e-13: шаг пикселя — в double-double
+    CanonicalView{"deep_minibrot", "-1.999999117587260825033350728580647136085801336409809113465", "0.0", 6e-13, 3000},
+};
+
+// Кадры всех замеров; небольшие, чтобы глубокий вид считался за разумное время
+const constexpr std::uint32_t BENCH_WIDTH{512};
+const constexpr std::uint32_t BENCH_HEIGHT{384};
+
+[[nodiscard]] inline mandelbrot::ViewPort MakeCanonicalViewPort(const CanonicalView &view, std::uint32_t width,
+                                                                std::uint32_t height) {
+    const mandelbrot::FixedPointComplex center{mandelbrot::FixedPoint::FromString(view.center_real),
+                                               mandelbrot::FixedPoint::FromString(view.center_imag)};
+    return CenteredViewPort(center, view.span, width, height);
+}
+
+[[nodiscard]] inline RenderSettings MakeCanonicalSettings(const CanonicalView &view, std::uint32_t width,
+                                                          std::uint32_t height) {
+    return RenderSettings{
+        .width = width, .height = height, .max_iterations = view.max_iterations, .escape_radius = 2.0};
+}
+
+// Сумма итераций кадра: вместе с числом пикселей даёт пропускную способность в итерациях
+[[nodiscard]] inline std::uint64_t TotalIterations(const PixelMatrix &pixels) {
+    std::uint64_t total = 0;
+    for (std::uint32_t y = 0; y < pixels.height(); ++y) {
+        for (const auto iterations : pixels[y]) {
+            total += iterations;
+        }
+    }
+    return total;
+}
+
+// Счётчики Mpixels/s и iterations/s (итераций орбит, не замера) по объёму работы одной итерации замера;
+// iterations == 0 — замер без вычисления орбит. Вызывается после цикла замера.
+inline void SetThroughputCounters(benchmark::State &state, std::uint64_t pixels, std::uint64_t iterations) {
+    state.counters["Mpixels"] =
+        benchmark::Counter(static_cast<double>(pixels) / 1e6, benchmark::Counter::kIsIterationInvariantRate);
+    if (iterations != 0) {
+        state.counters["iterations"] =
+            benchmark::Counter(static_cast<double>(iterations), benchmark::Counter::kIsIterationInvariantRate);
+    }
+}
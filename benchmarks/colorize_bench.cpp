@@ -0,0 +1,62 @@
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+#include "canonical_views.hpp"
+#include "mandelbrot_fractal_utils.hpp"
+#include "mandelbrot_sender.hpp"
+#include "palette.hpp"
+#include "types.hpp"
+
+// Раскраска итераций: формула на пиксель (IterationsToColor) и таблица палитры с векторной выборкой
+
+namespace {
+
+// Итерации исходного вида: раскраска зависит только от них
+[[nodiscard]] PixelMatrix HomeIterations(RenderSettings &settings) {
+    const auto &view = CANONICAL_VIEWS[0];
+    settings = MakeCanonicalSettings(view, BENCH_WIDTH, BENCH_HEIGHT);
+    PixelMatrix pixels(BENCH_WIDTH, BENCH_HEIGHT);
+    RenderRegion(mandelbrot::Flattened(MakeCanonicalViewPort(view, BENCH_WIDTH, BENCH_HEIGHT)), settings,
+                 PixelRegion{.start_row = 0, .end_row = BENCH_HEIGHT, .start_col = 0, .end_col = BENCH_WIDTH},
+                 RenderTarget{pixels.View(), {}});
+    return pixels;
+}
+
+void BM_IterationsToColor(benchmark::State &state) {
+    RenderSettings settings;
+    const auto pixels = HomeIterations(settings);
+    ColorMatrix colors(BENCH_WIDTH, BENCH_HEIGHT);
+
+    for (auto _ : state) {
+        for (std::uint32_t y = 0; y < BENCH_HEIGHT; ++y) {
+            const auto source = pixels[y];
+            const auto target = colors[y];
+            for (std::uint32_t x = 0; x < BENCH_WIDTH; ++x) {
+                target[x] = mandelbrot::IterationsToColor(source[x], settings.max_iterations);
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+    SetThroughputCounters(state, std::uint64_t{BENCH_WIDTH} * BENCH_HEIGHT, 0);
+}
+BENCHMARK(BM_IterationsToColor);
+
+// Путь рендерера: таблица строится один раз (см. CachedPalette), строки раскрашиваются Palette::Colorize
+void BM_PaletteColorize(benchmark::State &state) {
+    RenderSettings settings;
+    const auto pixels = HomeIterations(settings);
+    ColorMatrix colors(BENCH_WIDTH, BENCH_HEIGHT);
+
+    for (auto _ : state) {
+        const auto &palette = mandelbrot::CachedPalette(settings);
+        for (std::uint32_t y = 0; y < BENCH_HEIGHT; ++y) {
+            palette.Colorize(pixels[y], colors[y]);
+        }
+        benchmark::ClobberMemory();
+    }
+    SetThroughputCounters(state, std::uint64_t{BENCH_WIDTH} * BENCH_HEIGHT, 0);
+}
+BENCHMARK(BM_PaletteColorize);
+
+}  // namespace
@@ -0,0 +1,78 @@
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "canonical_views.hpp"
+#include "mandelbrot_fractal_utils.hpp"
+#include "mandelbrot_sender.hpp"
+#include "types.hpp"
+
+// Ядро итераций: скалярная функция на точку и векторный проход по кадру в одном потоке
+
+namespace {
+
+// Классы точек с разной длиной орбиты
+struct PointClass {
+    const char *name;
+    mandelbrot::Complex point;
+};
+
+const std::array POINT_CLASSES{
+    // Внутри главной кардиоиды: все max_iterations итераций
+    PointClass{"interior", {-0.1, 0.1}},
+    // Граница в долине морских коньков: длинная орбита, которая всё же убегает
+    PointClass{"boundary", {-0.743643887037151, 0.131825904205330}},
+    // Далеко вне множества: убегает за пару итераций
+    PointClass{"fast_escape", {1.5, 1.5}},
+};
+
+const constexpr std::uint32_t POINT_MAX_ITERATIONS{10000};
+
+void BM_CalculateIterationsForPoint(benchmark::State &state) {
+    const auto &point_class = POINT_CLASSES[static_cast<std::size_t>(state.range(0))];
+    state.SetLabel(point_class.name);
+
+    const auto iterations = mandelbrot::CalculateIterationsForPoint(point_class.point, POINT_MAX_ITERATIONS, 2.0);
+    for (auto _ : state) {
+        auto point = point_class.point;
+        benchmark::DoNotOptimize(point);
+        benchmark::DoNotOptimize(mandelbrot::CalculateIterationsForPoint(point, POINT_MAX_ITERATIONS, 2.0));
+    }
+    SetThroughputCounters(state, 1, iterations);
+}
+BENCHMARK(BM_CalculateIterationsForPoint)->DenseRange(0, POINT_CLASSES.size() - 1);
+
+// Кадр канонического вида в одном потоке через RenderRegion, как одна плитка рендерера
+void BM_RenderRegion(benchmark::State &state) {
+    const auto &view = CANONICAL_VIEWS[static_cast<std::size_t>(state.range(0))];
+    // Второй аргумент включает ядро float на неглубоких видах (A/B с чистым double)
+    auto settings = MakeCanonicalSettings(view, BENCH_WIDTH, BENCH_HEIGHT);
+    settings.float_kernel = state.range(1) != 0;
+    state.SetLabel(std::string{view.name} + (settings.float_kernel ? "/float" : "/double"));
+
+    auto viewport = MakeCanonicalViewPort(view, BENCH_WIDTH, BENCH_HEIGHT);
+    // Как в MandelbrotRenderer::RenderAsync; метод возмущений в RenderRegion не входит
+    const auto precision = mandelbrot::SelectPrecision(viewport, BENCH_WIDTH, BENCH_HEIGHT);
+    if (precision == mandelbrot::Precision::PERTURBATION) {
+        state.SkipWithError("view needs perturbation");
+        return;
+    }
+    if (precision == mandelbrot::Precision::DOUBLE) {
+        viewport = mandelbrot::Flattened(viewport);
+    }
+
+    const PixelRegion frame{.start_row = 0, .end_row = BENCH_HEIGHT, .start_col = 0, .end_col = BENCH_WIDTH};
+    PixelMatrix pixels(BENCH_WIDTH, BENCH_HEIGHT);
+    for (auto _ : state) {
+        RenderRegion(viewport, settings, frame, RenderTarget{pixels.View(), {}}, precision);
+        benchmark::ClobberMemory();
+    }
+    SetThroughputCounters(state, std::uint64_t{BENCH_WIDTH} * BENCH_HEIGHT, TotalIterations(pixels));
+}
+BENCHMARK(BM_RenderRegion)
+    ->ArgsProduct({benchmark::CreateDenseRange(0, CANONICAL_VIEWS.size() - 1, 1), {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
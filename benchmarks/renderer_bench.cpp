@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+#include <stdexec/execution.hpp>
+
+#include "canonical_views.hpp"
+#include "frame_reuse.hpp"
+#include "mandelbrot_renderer.hpp"
+#include "types.hpp"
+
+// Рендерер целиком: масштабирование RenderAsync по числу потоков и сборка кадра из прошлого при сдвиге
+
+namespace {
+
+// Виды x потоки: 1, 2, 4, ... и число аппаратных потоков
+void RenderAsyncArguments(benchmark::internal::Benchmark *benchmark) {
+    const auto hardware_threads = static_cast<std::int64_t>(std::max(std::thread::hardware_concurrency(), 1u));
+    for (std::int64_t view = 0; view < static_cast<std::int64_t>(CANONICAL_VIEWS.size()); ++view) {
+        for (std::int64_t threads = 1; threads < hardware_threads; threads *= 2) {
+            benchmark->Args({view, threads});
+        }
+        benchmark->Args({view, hardware_threads});
+    }
+}
+
+void BM_RenderAsync(benchmark::State &state) {
+    const auto &view = CANONICAL_VIEWS[static_cast<std::size_t>(state.range(0))];
+    const auto threads = static_cast<std::uint32_t>(state.range(1));
+    state.SetLabel(std::string{view.name});
+
+    const auto settings = MakeCanonicalSettings(view, BENCH_WIDTH, BENCH_HEIGHT);
+    const auto viewport = MakeCanonicalViewPort(view, BENCH_WIDTH, BENCH_HEIGHT);
+    MandelbrotRenderer renderer{threads};
+    // Каждый замер считает кадр целиком: кэш плиток вернул бы повторный вид без вычислений
+    renderer.Cache().SetMaxBytes(0);
+
+    std::uint64_t iterations = 0;
+    for (auto _ : state) {
+        auto result = stdexec::sync_wait(renderer.RenderAsync(viewport, settings));
+        if (!result) {
+            state.SkipWithError("render cancelled");
+            return;
+        }
+        iterations = TotalIterations(std::get<0>(*result).pixel_data);
+    }
+    SetThroughputCounters(state, std::uint64_t{BENCH_WIDTH} * BENCH_HEIGHT, iterations);
+}
+BENCHMARK(BM_RenderAsync)->Apply(RenderAsyncArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Сборка кадра при сдвиге вида: перенос пикселей прошлого кадра в новый (см. ShiftPreviousFrame)
+void BM_ShiftPreviousFrame(benchmark::State &state) {
+    const RenderSettings settings{.width = 1920, .height = 1080, .max_iterations = 500, .escape_radius = 2.0};
+    const RenderResult previous{.pixel_data = PixelMatrix(settings.width, settings.height),
+                                .color_data = ColorMatrix{},
+                                .viewport = mandelbrot::ViewPort{},
+                                .settings = settings};
+    PixelMatrix pixels(settings.width, settings.height);
+    const FrameShift shift{.dx = 40, .dy = -40};
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ShiftPreviousFrame(previous, shift, RenderTarget{pixels.View(), {}}));
+        benchmark::ClobberMemory();
+    }
+    SetThroughputCounters(state, std::uint64_t{settings.width} * settings.height, 0);
+}
+BENCHMARK(BM_ShiftPreviousFrame);
+
+}  // namespace
@@ -0,0 +1,31 @@
+#include <cstdint>
+
+#include <SFML/Graphics.hpp>
+#include <benchmark/benchmark.h>
+
+#include "canonical_views.hpp"
+#include "types.hpp"
+
+// Загрузка кадра в текстуру, как в SFMLRender: буфер RGBA8 одним вызовом sf::Texture::update.
+// Нужен контекст OpenGL; без дисплея замер пропускается.
+
+namespace {
+
+void BM_TextureUpload(benchmark::State &state) {
+    const auto width = static_cast<std::uint32_t>(state.range(0));
+    const auto height = static_cast<std::uint32_t>(state.range(1));
+    const ColorMatrix colors(width, height);
+
+    sf::Texture texture;
+    if (!texture.create(width, height)) {
+        state.SkipWithError("cannot create texture: no OpenGL context");
+        return;
+    }
+    for (auto _ : state) {
+        texture.update(reinterpret_cast<const sf::Uint8 *>(colors.data()), width, height, 0, 0);
+    }
+    SetThroughputCounters(state, std::uint64_t{width} * height, 0);
+}
+BENCHMARK(BM_TextureUpload)->Args({800, 600})->Args({1920, 1080})->Args({3840, 2160});
+
+}  // namespace
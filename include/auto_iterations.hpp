@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+
+#include "mandelbrot_fractal_utils.hpp"
+#include "types.hpp"
+
+// Автоматический лимит итераций: база растёт с глубиной приближения, а гистограмма убегания прошлого кадра
+// поднимает лимит, пока новые итерации ещё меняют заметную долю пикселей, или опускает его до реально
+// используемого. По времени прошлого кадра лимит ограничивается бюджетом кадра, но не ниже min_iterations.
+
+// Ширина исходного вида: глубина приближения отсчитывается от неё в октавах (удвоениях масштаба)
+const constexpr double AUTO_ITERATIONS_HOME_SPAN{4.0};
+
+struct AutoIterationSettings {
+    // Лимит исходного вида и прибавка за каждую октаву приближения
+    std::uint32_t min_iterations{100};
+    std::uint32_t iterations_per_octave{50};
+    std::uint32_t max_iterations{1U << 20};
+    // Доля пикселей, поздно убежавших в прошлом кадре, при которой лимит удваивается: примерно столько
+    // пикселей изменится от удвоения
+    double min_gain{1e-3};
+    // Бюджет времени кадра: время считается пропорциональным лимиту (оценка сверху)
+    std::chrono::milliseconds time_budget{250};
+};
+
+// Отклик готового кадра для выбора следующего лимита
+struct IterationFeedback {
+    std::uint32_t max_iterations{0};
+    std::uint64_t pixels{0};
+    std::uint64_t late_escaped_pixels{0};
+    std::uint32_t max_escape_iterations{0};
+    std::chrono::milliseconds render_time{};
+};
+
+[[nodiscard]] inline IterationFeedback MakeIterationFeedback(const RenderResult &frame) noexcept {
+    return IterationFeedback{.max_iterations = frame.settings.max_iterations,
+                             .pixels = frame.stats.escaped_pixels + frame.stats.interior_pixels,
+                             .late_escaped_pixels = frame.stats.late_escaped_pixels,
+                             .max_escape_iterations = frame.stats.max_escape_iterations,
+                             .render_time = frame.render_time};
+}
+
+// Округление вниз до четверти октавы: мелкие колебания лимита не сбрасывают перенос кадра и кэш плиток,
+// которые требуют совпадения max_iterations
+[[nodiscard]] inline std::uint32_t RoundIterations(std::uint32_t iterations) noexcept {
+    const std::uint32_t step = std::max<std::uint32_t>(std::bit_floor(iterations) / 4, 1);
+    return iterations / step * step;
+}
+
+// Лимит по глубине приближения вида
+[[nodiscard]] inline std::uint32_t DepthIterations(const AutoIterationSettings &settings,
+                                                   const mandelbrot::ViewPort &viewport) noexcept {
+    const double octaves = std::max(0.0, std::log2(AUTO_ITERATIONS_HOME_SPAN / std::abs(viewport.width())));
+    const double iterations = settings.min_iterations + settings.iterations_per_octave * octaves;
+    return static_cast<std::uint32_t>(std::min<double>(iterations, settings.max_iterations));
+}
+
+// Лимит итераций следующего кадра вида viewport по глубине и отклику прошлого кадра previous
+[[nodiscard]] inline std::uint32_t ChooseMaxIterations(const AutoIterationSettings &settings,
+                                                       const mandelbrot::ViewPort &viewport,
+                                                       const std::optional<IterationFeedback> &previous) noexcept {
+    const std::uint32_t depth = DepthIterations(settings, viewport);
+    std::uint64_t target = depth;
+    if (previous && previous->pixels > 0) {
+        const std::uint64_t current = previous->max_iterations;
+        const double late_share =
+            static_cast<double>(previous->late_escaped_pixels) / static_cast<double>(previous->pixels);
+        if (late_share >= settings.min_gain) {
+            // Много пикселей убегает у самого лимита: удвоение заметно изменит кадр
+            target = std::max(target, current * 2);
+        } else if (std::uint64_t{previous->max_escape_iterations} * 4 < current) {
+            // Лимит намного выше самого долгого убегания: его снижение кадр не меняет
+            target = std::max(target, std::uint64_t{previous->max_escape_iterations} * 2);
+        } else {
+            target = std::max(target, current);
+        }
+
+        // Время кадра растёт не быстрее лимита: лимит, при котором прошлый кадр уложился бы в бюджет
+        if (previous->render_time.count() > 0) {
+            const std::uint64_t affordable = current * static_cast<std::uint64_t>(settings.time_budget.count()) /
+                                             static_cast<std::uint64_t>(previous->render_time.count());
+            target = std::min(target, affordable);
+        }
+    }
+    const auto rounded = RoundIterations(static_cast<std::uint32_t>(std::min<std::uint64_t>(target, UINT32_MAX)));
+    return std::clamp(rounded, settings.min_iterations, std::max(settings.min_iterations, settings.max_iterations));
+}
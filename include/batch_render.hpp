@@ -0,0 +1,283 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <exec/static_thread_pool.hpp>
+#include <stdexec/execution.hpp>
+
+#include "fixed_point.hpp"
+#include "mandelbrot_renderer.hpp"
+#include "supersampling.hpp"
+#include "types.hpp"
+#include "video_writer.hpp"
+#include "zoom_animation.hpp"
+#include "zoom_path.hpp"
+
+// Пакетный рендеринг без окна: изображение любого размера считается горизонтальными полосами,
+// и каждая полоса сразу уходит на диск (см. RenderBands, PpmWriter). Анимация приближения пишется
+// потоком кадров (см. RenderZoomAnimation, VideoWriter).
+
+// Память на итерации и цвета одной полосы по умолчанию
+const constexpr std::size_t BATCH_BAND_BYTES{64 * 1024 * 1024};
+
+struct BatchOptions {
+    mandelbrot::ViewPort viewport;
+    RenderSettings settings;
+    // Строк в полосе; 0 — по BATCH_BAND_BYTES (см. BandRows)
+    std::uint32_t band_rows{0};
+    std::filesystem::path output{"mandelbrot.ppm"};
+    // Больше нуля — вместо одного изображения пирамида плиток из стольких уровней в каталоге output
+    // (см. tile_pyramid.hpp); область тогда квадратная со стороной span
+    std::uint32_t pyramid_levels{0};
+    std::uint32_t pyramid_tile_size{256};
+    // Статистика каждой полосы или кадра строкой JSON в stdout (см. RenderStatsJson)
+    bool stats{false};
+
+    // Анимация приближения вместо изображения: frames кадров от начального вида к zoom_end
+    // или путь из файла ключевых кадров keyframes (см. zoom_path.hpp); по умолчанию пишется в stdout
+    std::uint32_t frames{0};
+    ZoomView zoom_end;
+    std::filesystem::path keyframes;
+    VideoFormat video_format{VideoFormat::Y4M};
+    std::uint32_t fps{30};
+    std::uint32_t frames_in_flight{ANIMATION_FRAMES_IN_FLIGHT};
+    bool auto_iterations{false};
+
+    [[nodiscard]] bool Animation() const noexcept { return frames > 0 || !keyframes.empty(); }
+};
+
+// Строк в полосе: заданное число или столько, чтобы полоса занимала не больше BATCH_BAND_BYTES
+[[nodiscard]] inline std::uint32_t BandRows(const BatchOptions &options) noexcept {
+    if (options.band_rows != 0) {
+        return options.band_rows;
+    }
+    const std::size_t row_bytes =
+        std::size_t{options.settings.width} * (sizeof(std::uint32_t) + sizeof(mandelbrot::RgbColor));
+    return static_cast<std::uint32_t>(std::max<std::size_t>(BATCH_BAND_BYTES / std::max<std::size_t>(row_bytes, 1), 1));
+}
+
+// Вид полосы строк [start_row, end_row) изображения высотой height: горизонтальные границы и origin общие
+[[nodiscard]] inline mandelbrot::ViewPort BandViewPort(const mandelbrot::ViewPort &viewport, std::uint32_t height,
+                                                       std::uint32_t start_row, std::uint32_t end_row) noexcept {
+    const double row_height = viewport.height() / height;
+    mandelbrot::ViewPort band = viewport;
+    band.y_min = viewport.y_min + start_row * row_height;
+    band.y_max = viewport.y_min + end_row * row_height;
+    return band;
+}
+
+// Разбор аргументов командной строки (без имени программы):
+//   --size WIDTHxHEIGHT   --iterations N   --center RE IM   --span WIDTH
+//   --band-rows N   --mode brute|mariani   --output PATH   --pyramid LEVELS   --tile-size N   --stats
+//   --frames N   --zoom-to RE IM SPAN   --keyframes PATH   --fps N   --format y4m|rgb   --frames-in-flight N
+//   --auto-iterations   --supersample GRID   --supersample-threshold N
+// Центр задаётся десятичной записью любой длины (см. FixedPoint::FromString).
+// Бросает std::invalid_argument на неизвестном ключе или некорректном значении.
+[[nodiscard]] inline BatchOptions ParseBatchOptions(std::span<const std::string_view> args) {
+    auto number = [](std::string_view text, auto &value) {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error != std::errc{} || end != text.data() + text.size()) {
+            throw std::invalid_argument{std::format("invalid number: {}", text)};
+        }
+    };
+
+    BatchOptions options;
+    options.settings = RenderSettings{.width = 1920, .height = 1080, .max_iterations = 500, .escape_radius = 2.0};
+    mandelbrot::FixedPointComplex center{mandelbrot::FixedPoint{-0.5}, mandelbrot::FixedPoint{0.0}};
+    double span = 3.5;
+    bool has_output = false;
+    bool has_zoom_end = false;
+
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        const auto key = args[i];
+        auto value = [&]() -> std::string_view {
+            if (++i >= args.size()) {
+                throw std::invalid_argument{std::format("missing value for {}", key)};
+            }
+            return args[i];
+        };
+
+        if (key == "--size") {
+            const auto size = value();
+            const auto separator = size.find('x');
+            if (separator == std::string_view::npos) {
+                throw std::invalid_argument{std::format("invalid size: {}", size)};
+            }
+            number(size.substr(0, separator), options.settings.width);
+            number(size.substr(separator + 1), options.settings.height);
+        } else if (key == "--iterations") {
+            number(value(), options.settings.max_iterations);
+        } else if (key == "--center") {
+            center.real = mandelbrot::FixedPoint::FromString(value());
+            center.imag = mandelbrot::FixedPoint::FromString(value());
+        } else if (key == "--span") {
+            number(value(), span);
+        } else if (key == "--band-rows") {
+            number(value(), options.band_rows);
+        } else if (key == "--mode") {
+            const auto mode = value();
+            if (mode == "brute") {
+                options.settings.mode = RenderMode::BRUTE_FORCE;
+            } else if (mode == "mariani") {
+                options.settings.mode = RenderMode::MARIANI_SILVER;
+            } else {
+                throw std::invalid_argument{std::format("unknown mode: {}", mode)};
+            }
+        } else if (key == "--pyramid") {
+            number(value(), options.pyramid_levels);
+        } else if (key == "--tile-size") {
+            number(value(), options.pyramid_tile_size);
+        } else if (key == "--stats") {
+            options.stats = true;
+        } else if (key == "--frames") {
+            number(value(), options.frames);
+        } else if (key == "--zoom-to") {
+            options.zoom_end.center.real = mandelbrot::FixedPoint::FromString(value());
+            options.zoom_end.center.imag = mandelbrot::FixedPoint::FromString(value());
+            number(value(), options.zoom_end.span);
+            has_zoom_end = true;
+        } else if (key == "--keyframes") {
+            options.keyframes = std::filesystem::path{std::string{value()}};
+        } else if (key == "--fps") {
+            number(value(), options.fps);
+        } else if (key == "--format") {
+            const auto format = value();
+            if (format == "y4m") {
+                options.video_format = VideoFormat::Y4M;
+            } else if (format == "rgb") {
+                options.video_format = VideoFormat::RAW_RGB;
+            } else {
+                throw std::invalid_argument{std::format("unknown format: {}", format)};
+            }
+        } else if (key == "--frames-in-flight") {
+            number(value(), options.frames_in_flight);
+        } else if (key == "--auto-iterations") {
+            options.auto_iterations = true;
+        } else if (key == "--supersample") {
+            number(value(), options.settings.supersampling.grid);
+        } else if (key == "--supersample-threshold") {
+            number(value(), options.settings.supersampling.threshold);
+        } else if (key == "--output") {
+            options.output = std::filesystem::path{std::string{value()}};
+            has_output = true;
+        } else {
+            throw std::invalid_argument{std::format("unknown option: {}", key)};
+        }
+    }
+
+    if (options.settings.width == 0 || options.settings.height == 0 || !(span > 0.0)) {
+        throw std::invalid_argument{"image size and span must be positive"};
+    }
+    if (options.frames > 0 && !options.keyframes.empty()) {
+        throw std::invalid_argument{"--frames and --keyframes are exclusive"};
+    }
+    if (options.settings.supersampling.grid > SUPERSAMPLING_MAX_GRID) {
+        throw std::invalid_argument{std::format("--supersample must not exceed {}", SUPERSAMPLING_MAX_GRID)};
+    }
+    if (has_zoom_end && options.frames == 0) {
+        throw std::invalid_argument{"--zoom-to needs --frames"};
+    }
+    if (options.Animation() && options.pyramid_levels > 0) {
+        throw std::invalid_argument{"an animation cannot be a pyramid"};
+    }
+    if (options.settings.supersampling.grid > 1 && options.pyramid_levels > 0) {
+        throw std::invalid_argument{"--supersample does not apply to a pyramid"};
+    }
+    if (options.Animation() && !has_output) {
+        options.output = "-";
+    }
+    if (!has_zoom_end) {
+        // Без --zoom-to кадры показывают начальный вид
+        options.zoom_end = ZoomView{.center = center, .span = span};
+    }
+    options.viewport = options.pyramid_levels > 0
+                           ? CenteredViewPort(center, span, 1, 1)
+                           : CenteredViewPort(center, span, options.settings.width, options.settings.height);
+    return options;
+}
+
+// Рендеринг изображения settings.width x settings.height полосами по band_rows строк на пуле renderer.
+// Готовые полосы по порядку передаются в sink(const RenderResult &band, std::uint32_t start_row)
+// в отдельном потоке ввода-вывода, пока пул считает следующую полосу. В памяти не больше двух полос
+// независимо от размера изображения: полосы считаются независимыми кадрами и не попадают ни в прошлый кадр
+// рендерера, ни в кэш плиток. При сглаживании полоса считается с соседними строками соседних полос, чтобы
+// границы на стыке полос находились так же, как в изображении целиком; лишние строки отбрасываются до sink,
+// но входят в статистику полосы. Ошибки рендеринга и sink пробрасываются вызывающему.
+template <typename Sink>
+void RenderBands(MandelbrotRenderer &renderer, const mandelbrot::ViewPort &viewport, const RenderSettings &settings,
+                 std::uint32_t band_rows, Sink sink) {
+    if (settings.height == 0) {
+        return;
+    }
+    band_rows = std::max<std::uint32_t>(band_rows, 1);
+
+    exec::static_thread_pool io_pool{1};
+    auto io = io_pool.get_scheduler();
+
+    // Строк перекрытия с каждой соседней полосой: сглаживанию нужны соседи пикселя по стороне
+    const std::uint32_t overlap = SupersamplingGrid(settings.supersampling) > 1 && settings.colorize ? 1 : 0;
+
+    // Полоса [start_row, end_row) вместе со строками перекрытия
+    auto render_band = [&](std::uint32_t start_row) {
+        const auto end_row =
+            static_cast<std::uint32_t>(std::min<std::uint64_t>(std::uint64_t{start_row} + band_rows, settings.height));
+        const std::uint32_t first_row = start_row - std::min(start_row, overlap);
+        const std::uint32_t last_row = std::min(end_row + overlap, settings.height);
+        RenderSettings band_settings = settings;
+        band_settings.height = last_row - first_row;
+        return renderer.RenderAsync(BandViewPort(viewport, settings.height, first_row, last_row), band_settings, 0,
+                                    FrameKind::INDEPENDENT);
+    };
+    // Готовая полоса без строк перекрытия
+    auto take = [&](auto result, std::uint32_t start_row) -> RenderResult {
+        if (!result) {
+            throw std::runtime_error{"RenderBands: render cancelled"};
+        }
+        RenderResult band = std::get<0>(std::move(*result));
+        const std::uint32_t rows = std::min(band_rows, settings.height - start_row);
+        const std::uint32_t top = std::min(start_row, overlap);
+        if (band.settings.height != rows) {
+            band.viewport = BandViewPort(band.viewport, band.settings.height, top, top + rows);
+            band.pixel_data.KeepRows(top, top + rows);
+            band.color_data.KeepRows(top, top + rows);
+            band.settings.height = rows;
+        }
+        return band;
+    };
+
+    RenderResult band = take(stdexec::sync_wait(render_band(0)), 0);
+    for (std::uint32_t start_row = 0;; start_row += band_rows) {
+        const std::uint64_t next_row = std::uint64_t{start_row} + band_rows;
+        if (next_row >= settings.height) {
+            sink(std::as_const(band), start_row);
+            return;
+        }
+
+        // Запись текущей полосы и вычисление следующей идут одновременно
+        auto write = stdexec::schedule(io) | stdexec::then([&sink, &band, start_row] {
+                         sink(std::as_const(band), start_row);
+                     });
+        band = take(stdexec::sync_wait(
+                        stdexec::when_all(render_band(static_cast<std::uint32_t>(next_row)), std::move(write))),
+                    static_cast<std::uint32_t>(next_row));
+    }
+}
+
+// Путь анимации из параметров: ключевые кадры из файла или options.frames кадров от начального вида
+// (центр и ширина options.viewport) к options.zoom_end
+[[nodiscard]] inline ZoomPath AnimationPath(const BatchOptions &options) {
+    if (!options.keyframes.empty()) {
+        return ReadKeyframes(options.keyframes);
+    }
+    return ZoomPath::Between(ZoomView{.center = options.viewport.origin, .span = options.viewport.width()},
+                             options.zoom_end, options.frames);
+}
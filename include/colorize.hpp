@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+#include "palette.hpp"
+#include "types.hpp"
+
+// Раскраска — отдельный этап после вычисления итераций: цвет пикселя зависит только от числа итераций
+// и настроек раскраски, поэтому смена палитры, сдвига или режима перекрашивает готовый кадр без пересчёта.
+
+// Раскрашивает строки [start_row, end_row) кадра по палитре; буфер цветов кадра уже выделен
+inline void ColorizeRows(RenderResult &frame, const mandelbrot::Palette &palette, std::uint32_t start_row,
+                         std::uint32_t end_row) noexcept {
+    for (std::uint32_t y = start_row; y < end_row; ++y) {
+        palette.Colorize(frame.pixel_data[y], frame.color_data[y]);
+    }
+}
+
+// Выделяет буфер цветов по размеру кадра, если его ещё нет, и раскрашивает кадр по frame.settings.coloring
+inline void ColorizeFrame(RenderResult &frame) {
+    const std::uint32_t width = frame.pixel_data.width();
+    const std::uint32_t height = frame.pixel_data.height();
+    if (frame.color_data.width() != width || frame.color_data.height() != height) {
+        frame.color_data = ColorMatrix(width, height);
+    }
+    ColorizeRows(frame, mandelbrot::CachedPalette(frame.settings), 0, height);
+}
+
+// Перекрашивает готовый кадр в раскраску coloring; итерации не пересчитываются
+inline void Recolor(RenderResult &frame, const ColorSettings &coloring) {
+    frame.settings.coloring = coloring;
+    frame.settings.colorize = true;
+    ColorizeFrame(frame);
+}
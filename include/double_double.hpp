@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+
+#include "fixed_point.hpp"
+#include "mandelbrot_fractal_utils.hpp"
+
+namespace mandelbrot {
+
+// Число double-double: непересекающаяся сумма hi + lo двух double, около 106 бит мантиссы.
+// Все операции без ветвлений и без FMA (произведение точно раскладывается делением Деккера),
+// поэтому векторное ядро (mandelbrot_simd_lanes.hpp) повторяет их операция в операцию
+// и даёт побитово тот же результат. Компилятор не должен сливать операции в FMA
+// (-ffp-contract=off в CMakeLists.txt), иначе точные TwoSum/TwoProd перестают быть точными.
+struct DoubleDouble {
+    double hi{0.0};
+    double lo{0.0};
+};
+
+struct DoubleDoubleComplex {
+    DoubleDouble real;
+    DoubleDouble imag;
+};
+
+namespace double_double {
+
+// 2^27 + 1: делит 53-битную мантиссу на две половины по 26 бит
+inline constexpr double SPLITTER = 134217729.0;
+
+// Точная сумма a + b = s + err
+[[nodiscard]] constexpr DoubleDouble TwoSum(double a, double b) noexcept {
+    const double s = a + b;
+    const double bb = s - a;
+    const double err = (a - (s - bb)) + (b - bb);
+    return {s, err};
+}
+
+// То же при |a| >= |b|
+[[nodiscard]] constexpr DoubleDouble QuickTwoSum(double a, double b) noexcept {
+    const double s = a + b;
+    const double err = b - (s - a);
+    return {s, err};
+}
+
+[[nodiscard]] constexpr DoubleDouble Split(double a) noexcept {
+    const double t = SPLITTER * a;
+    const double hi = t - (t - a);
+    const double lo = a - hi;
+    return {hi, lo};
+}
+
+// Точное произведение a * b = p + err
+[[nodiscard]] constexpr DoubleDouble TwoProd(double a, double b) noexcept {
+    const double p = a * b;
+    const auto [a_hi, a_lo] = Split(a);
+    const auto [b_hi, b_lo] = Split(b);
+    const double err = (((a_hi * b_hi - p) + a_hi * b_lo) + a_lo * b_hi) + a_lo * b_lo;
+    return {p, err};
+}
+
+[[nodiscard]] constexpr DoubleDouble Add(const DoubleDouble &a, const DoubleDouble &b) noexcept {
+    auto [s, e] = TwoSum(a.hi, b.hi);
+    const auto [t, f] = TwoSum(a.lo, b.lo);
+    e = e + t;
+    const auto [s2, e2] = QuickTwoSum(s, e);
+    return QuickTwoSum(s2, e2 + f);
+}
+
+[[nodiscard]] constexpr DoubleDouble Negate(const DoubleDouble &a) noexcept { return {0.0 - a.hi, 0.0 - a.lo}; }
+
+[[nodiscard]] constexpr DoubleDouble Twice(const DoubleDouble &a) noexcept { return {a.hi + a.hi, a.lo + a.lo}; }
+
+[[nodiscard]] constexpr DoubleDouble Mul(const DoubleDouble &a, const DoubleDouble &b) noexcept {
+    const auto [p, e] = TwoProd(a.hi, b.hi);
+    return QuickTwoSum(p, e + (a.hi * b.lo + a.lo * b.hi));
+}
+
+[[nodiscard]] constexpr DoubleDouble Square(const DoubleDouble &a) noexcept {
+    const auto [p, e] = TwoProd(a.hi, a.hi);
+    const double cross = a.hi * a.lo;
+    return QuickTwoSum(p, e + (cross + cross));
+}
+
+[[nodiscard]] inline DoubleDouble FromFixedPoint(const FixedPoint &value) noexcept {
+    const double hi = value.ToDouble();
+    return {hi, (value - FixedPoint{hi}).ToDouble()};
+}
+
+}  // namespace double_double
+
+// Координата пикселя в double-double: origin вида плюс смещение из Pixel2DToComplex
+[[nodiscard]] inline DoubleDoubleComplex Pixel2DToDoubleDouble(std::uint32_t x, std::uint32_t y,
+                                                               const ViewPort &viewport, std::uint32_t screen_width,
+                                                               std::uint32_t screen_height) noexcept {
+    const Complex offset = Pixel2DToComplex(x, y, viewport, screen_width, screen_height);
+    return {double_double::Add(double_double::FromFixedPoint(viewport.origin.real), DoubleDouble{offset.real(), 0.0}),
+            double_double::Add(double_double::FromFixedPoint(viewport.origin.imag), DoubleDouble{offset.imag(), 0.0})};
+}
+
+// То же по дробным координатам кадра (см. Subpixel2DToComplex)
+[[nodiscard]] inline DoubleDoubleComplex Subpixel2DToDoubleDouble(double x, double y, const ViewPort &viewport,
+                                                                  std::uint32_t screen_width,
+                                                                  std::uint32_t screen_height) noexcept {
+    const Complex offset = Subpixel2DToComplex(x, y, viewport, screen_width, screen_height);
+    return {double_double::Add(double_double::FromFixedPoint(viewport.origin.real), DoubleDouble{offset.real(), 0.0}),
+            double_double::Add(double_double::FromFixedPoint(viewport.origin.imag), DoubleDouble{offset.imag(), 0.0})};
+}
+
+// Эталонная скалярная версия ядра double-double; проверка убегания выполняется по старшим частям
+[[nodiscard]] constexpr std::uint32_t CalculateIterationsForPoint(const DoubleDoubleComplex &c,
+                                                                  std::uint32_t max_iterations,
+                                                                  double escape_radius) noexcept {
+    using namespace double_double;
+
+    DoubleDouble z_real;
+    DoubleDouble z_imag;
+    const double escape_radius_squared = escape_radius * escape_radius;
+
+    for (std::uint32_t i = 0; i < max_iterations; ++i) {
+        if (z_real.hi * z_real.hi + z_imag.hi * z_imag.hi > escape_radius_squared) {
+            return i;
+        }
+        const DoubleDouble real_squared = Square(z_real);
+        const DoubleDouble imag_squared = Square(z_imag);
+        const DoubleDouble real_imag = Mul(z_real, z_imag);
+        z_real = Add(Add(real_squared, Negate(imag_squared)), c.real);
+        z_imag = Add(Twice(real_imag), c.imag);
+    }
+    return max_iterations;
+}
+
+}  // namespace mandelbrot
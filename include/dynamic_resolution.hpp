@@ -0,0 +1,57 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+#include "types.hpp"
+
+// Динамическое разрешение при взаимодействии: пока зажата кнопка мыши, кадры считаются в 1/2 или 1/4
+// разрешения окна по каждой стороне и растягиваются на окно. Делитель выбирается по измеренному времени
+// готовых кадров так, чтобы кадр укладывался в бюджет; после ввода кадр пересчитывается в полном разрешении.
+
+// Наибольший делитель разрешения: кадр в 1/4 по каждой стороне, в 16 раз меньше пикселей
+const constexpr std::uint32_t MAX_RESOLUTION_DIVISOR{4};
+
+// Настройки кадра, уменьшенного в divisor раз по каждой стороне
+[[nodiscard]] inline RenderSettings ScaledSettings(const RenderSettings &settings, std::uint32_t divisor) noexcept {
+    RenderSettings scaled = settings;
+    scaled.width = std::max<std::uint32_t>(settings.width / divisor, 1);
+    scaled.height = std::max<std::uint32_t>(settings.height / divisor, 1);
+    return scaled;
+}
+
+// Регулятор разрешения: сглаженная оценка времени кадра в полном разрешении по времени кадров, посчитанных
+// с любым делителем (время пропорционально числу пикселей)
+class ResolutionController {
+public:
+    explicit ResolutionController(std::chrono::milliseconds budget) noexcept : budget_{budget} {}
+
+    // Время готового кадра, посчитанного с делителем divisor
+    void Observe(std::uint32_t divisor, std::chrono::milliseconds render_time) noexcept {
+        const double full_ms = static_cast<double>(render_time.count()) * divisor * divisor;
+        full_ms_ = has_estimate_ ? full_ms_ + SMOOTHING * (full_ms - full_ms_) : full_ms;
+        has_estimate_ = true;
+    }
+
+    // Делитель кадра при взаимодействии: наименьший, при котором оценка укладывается в бюджет
+    [[nodiscard]] std::uint32_t InteractiveDivisor() const noexcept {
+        std::uint32_t divisor = 1;
+        while (divisor < MAX_RESOLUTION_DIVISOR &&
+               full_ms_ / (divisor * divisor) > static_cast<double>(budget_.count())) {
+            divisor *= 2;
+        }
+        return divisor;
+    }
+
+    // Оценка времени кадра в полном разрешении, мс
+    [[nodiscard]] double FullResolutionMs() const noexcept { return full_ms_; }
+
+private:
+    // Вес нового измерения: одиночный кадр из кэша плиток или с переносом пикселей не сбрасывает оценку
+    static constexpr double SMOOTHING = 0.5;
+
+    std::chrono::milliseconds budget_;
+    double full_ms_{0.0};
+    bool has_estimate_{false};
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <stdexec/execution.hpp>
+#include <utility>
+
+#include "render_stop.hpp"
+
+// Параллельный запуск workers задач на планировщике с числом задач, заданным во время выполнения
+// (when_all требует число сендеров на этапе компиляции). Задача worker выполняет body(worker, should_stop)
+// и возвращает false, если прервана отменой; операция завершается вместе с последней задачей —
+// set_error с первым исключением задач, set_stopped, если хотя бы одна задача прервана, иначе set_value.
+// Исключение в задаче останавливает остальные задачи через should_stop.
+template <typename Scheduler, typename Body, typename Receiver>
+struct FanOutOperationState {
+    Receiver receiver_;
+    Scheduler scheduler_;
+    Body body_;
+    std::uint32_t workers_;
+    stdexec::inplace_stop_token stop_token_;
+    // Количество запущенных, но ещё не завершённых задач
+    std::atomic<std::uint32_t> pending_{0};
+    std::atomic<bool> stopped_{false};
+    // Исключение первой упавшей задачи; записывается один раз, читается последней задачей
+    std::atomic<bool> failed_{false};
+    std::exception_ptr error_;
+
+    template <typename R>
+    explicit FanOutOperationState(R &&r, Scheduler scheduler, Body body, std::uint32_t workers,
+                                  stdexec::inplace_stop_token stop_token)
+        : receiver_{std::forward<R>(r)}, scheduler_{scheduler}, body_{std::move(body)}, workers_{workers},
+          stop_token_{stop_token} {}
+
+    void start() noexcept {
+        if (workers_ == 0) {
+            stdexec::set_value(std::move(receiver_));
+            return;
+        }
+        // После запуска последней задачи операция может завершиться и быть разрушена: члены больше не читаем
+        const std::uint32_t workers = workers_;
+        pending_.store(workers, std::memory_order_relaxed);
+        for (std::uint32_t worker = 0; worker < workers; ++worker) {
+            try {
+                stdexec::start_detached(stdexec::schedule(scheduler_) | stdexec::then([this, worker] { Run(worker); }));
+            } catch (...) {
+                // Задачу не удалось запланировать: выполняем её в текущем потоке
+                Run(worker);
+            }
+        }
+    }
+
+    void Run(std::uint32_t worker) noexcept {
+        try {
+            if (!body_(worker, [this] {
+                    return failed_.load(std::memory_order_relaxed) || StopRequested(receiver_, stop_token_);
+                })) {
+                stopped_.store(true, std::memory_order_relaxed);
+            }
+        } catch (...) {
+            if (!failed_.exchange(true, std::memory_order_relaxed)) {
+                error_ = std::current_exception();
+            }
+        }
+
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            if (error_) {
+                stdexec::set_error(std::move(receiver_), std::move(error_));
+            } else if (stopped_.load(std::memory_order_relaxed)) {
+                stdexec::set_stopped(std::move(receiver_));
+            } else {
+                stdexec::set_value(std::move(receiver_));
+            }
+        }
+    }
+};
+
+template <typename Scheduler, typename Body>
+struct FanOutSender {
+    Scheduler scheduler_;
+    Body body_;
+    std::uint32_t workers_;
+    stdexec::inplace_stop_token stop_token_;
+
+    using completion_signatures =
+        stdexec::completion_signatures<stdexec::set_value_t(), stdexec::set_error_t(std::exception_ptr),
+                                       stdexec::set_stopped_t()>;
+
+    template <typename Env>
+    auto get_completion_signatures(Env) const -> completion_signatures {
+        return {};
+    }
+
+    template <typename R>
+    auto connect(R &&r) {
+        return FanOutOperationState<Scheduler, Body, std::decay_t<R>>{std::forward<R>(r), scheduler_, body_, workers_,
+                                                                      stop_token_};
+    }
+};
+
+// body вызывается как bool(std::uint32_t worker, ShouldStop should_stop), где should_stop() проверяет отмену
+// по токену получателя и токену кадра stop_token
+template <typename Scheduler, typename Body>
+[[nodiscard]] auto MakeFanOutSender(Scheduler scheduler, std::uint32_t workers, Body body,
+                                    stdexec::inplace_stop_token stop_token = {}) {
+    return FanOutSender<Scheduler, Body>{scheduler, std::move(body), workers, stop_token};
+}
+
+namespace stdexec {
+template <typename Scheduler, typename Body>
+inline constexpr bool enable_sender<FanOutSender<Scheduler, Body>> = true;
+}
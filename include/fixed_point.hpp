@@ -0,0 +1,217 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+namespace mandelbrot {
+
+// Число повышенной точности с фиксированной точкой для глубокого приближения.
+// Хранится в дополнительном коде в LIMBS 64-битных словах (младшее слово первое):
+// старшее слово — целая часть со знаком, остальные FRACTION_LIMBS слов — дробная часть.
+// Дробных бит 448, то есть шаг около 1e-135; целая часть ограничена диапазоном int64.
+class FixedPoint {
+public:
+    static constexpr std::size_t LIMBS = 8;
+    static constexpr std::size_t FRACTION_LIMBS = LIMBS - 1;
+    static constexpr int FRACTION_BITS = 64 * static_cast<int>(FRACTION_LIMBS);
+
+    constexpr FixedPoint() = default;
+
+    // Точное преобразование, если |value| < 2^63 и младшие биты value не меньше 2^-448;
+    // иначе дробная часть усекается. NaN и бесконечности дают ноль.
+    explicit constexpr FixedPoint(double value) noexcept {
+        const auto bits = std::bit_cast<std::uint64_t>(value);
+        const int biased_exponent = static_cast<int>((bits >> 52) & 0x7ff);
+        if (biased_exponent == 0x7ff) {
+            return;
+        }
+
+        std::uint64_t mantissa = bits & ((std::uint64_t{1} << 52) - 1);
+        int exponent = biased_exponent - 1075;
+        if (biased_exponent != 0) {
+            mantissa |= std::uint64_t{1} << 52;
+        } else {
+            exponent = -1074;
+        }
+
+        // value = mantissa * 2^exponent, в словах: mantissa * 2^(exponent + FRACTION_BITS)
+        const int shift = exponent + FRACTION_BITS;
+        if (shift >= 0) {
+            const auto limb = static_cast<std::size_t>(shift / 64);
+            const int offset = shift % 64;
+            if (limb < LIMBS) {
+                limbs_[limb] = mantissa << offset;
+            }
+            if (offset != 0 && limb + 1 < LIMBS) {
+                limbs_[limb + 1] = mantissa >> (64 - offset);
+            }
+        } else if (shift > -64) {
+            limbs_[0] = mantissa >> -shift;
+        }
+
+        if ((bits >> 63) != 0) {
+            Negate();
+        }
+    }
+
+    // Разбор десятичной записи вида "-0.743643887037158704752191506114774"
+    // (без экспоненты). Бросает std::invalid_argument на некорректной строке.
+    [[nodiscard]] static FixedPoint FromString(std::string_view text) {
+        bool negative = false;
+        if (!text.empty() && (text.front() == '-' || text.front() == '+')) {
+            negative = text.front() == '-';
+            text.remove_prefix(1);
+        }
+
+        const auto point = text.find('.');
+        const auto integer_digits = text.substr(0, point);
+        const auto fraction_digits = point == std::string_view::npos ? std::string_view{} : text.substr(point + 1);
+        if (integer_digits.empty() && fraction_digits.empty()) {
+            throw std::invalid_argument("FixedPoint: empty number");
+        }
+
+        FixedPoint result;
+        // Дробная часть по схеме Горнера с конца: x = (x + digit) / 10
+        for (auto it = fraction_digits.rbegin(); it != fraction_digits.rend(); ++it) {
+            result.limbs_[FRACTION_LIMBS] += static_cast<std::uint64_t>(Digit(*it));
+            result.DivideMagnitude(10);
+        }
+
+        std::uint64_t integer = 0;
+        for (const char c : integer_digits) {
+            integer = integer * 10 + static_cast<std::uint64_t>(Digit(c));
+        }
+        result.limbs_[FRACTION_LIMBS] = integer;
+
+        if (negative) {
+            result.Negate();
+        }
+        return result;
+    }
+
+    [[nodiscard]] double ToDouble() const noexcept {
+        FixedPoint magnitude = *this;
+        const bool negative = IsNegative();
+        if (negative) {
+            magnitude.Negate();
+        }
+
+        // Трёх старших ненулевых слов достаточно для 53 бит мантиссы
+        std::size_t top = LIMBS;
+        while (top > 0 && magnitude.limbs_[top - 1] == 0) {
+            --top;
+        }
+        double result = 0.0;
+        for (std::size_t i = top; i > 0 && i + 3 > top; --i) {
+            result += std::ldexp(static_cast<double>(magnitude.limbs_[i - 1]),
+                                 64 * static_cast<int>(i - 1) - FRACTION_BITS);
+        }
+        return negative ? -result : result;
+    }
+
+    [[nodiscard]] constexpr bool IsNegative() const noexcept { return (limbs_[LIMBS - 1] >> 63) != 0; }
+
+    [[nodiscard]] constexpr FixedPoint operator-() const noexcept {
+        FixedPoint result = *this;
+        result.Negate();
+        return result;
+    }
+
+    constexpr FixedPoint &operator+=(const FixedPoint &other) noexcept {
+        unsigned __int128 carry = 0;
+        for (std::size_t i = 0; i < LIMBS; ++i) {
+            carry += static_cast<unsigned __int128>(limbs_[i]) + other.limbs_[i];
+            limbs_[i] = static_cast<std::uint64_t>(carry);
+            carry >>= 64;
+        }
+        return *this;
+    }
+
+    constexpr FixedPoint &operator-=(const FixedPoint &other) noexcept { return *this += -other; }
+
+    // Произведение с усечением модуля; переполнение целой части не проверяется
+    constexpr FixedPoint &operator*=(const FixedPoint &other) noexcept {
+        const bool negative = IsNegative() != other.IsNegative();
+        FixedPoint a = *this;
+        FixedPoint b = other;
+        if (a.IsNegative()) {
+            a.Negate();
+        }
+        if (b.IsNegative()) {
+            b.Negate();
+        }
+
+        // Полное произведение модулей; результат — слова [FRACTION_LIMBS, FRACTION_LIMBS + LIMBS)
+        std::array<std::uint64_t, 2 * LIMBS> product{};
+        for (std::size_t i = 0; i < LIMBS; ++i) {
+            if (a.limbs_[i] == 0) {
+                continue;
+            }
+            unsigned __int128 carry = 0;
+            for (std::size_t j = 0; j < LIMBS; ++j) {
+                carry += static_cast<unsigned __int128>(a.limbs_[i]) * b.limbs_[j] + product[i + j];
+                product[i + j] = static_cast<std::uint64_t>(carry);
+                carry >>= 64;
+            }
+            product[i + LIMBS] = static_cast<std::uint64_t>(carry);
+        }
+
+        for (std::size_t i = 0; i < LIMBS; ++i) {
+            limbs_[i] = product[i + FRACTION_LIMBS];
+        }
+        if (negative) {
+            Negate();
+        }
+        return *this;
+    }
+
+    [[nodiscard]] friend constexpr FixedPoint operator+(FixedPoint a, const FixedPoint &b) noexcept { return a += b; }
+    [[nodiscard]] friend constexpr FixedPoint operator-(FixedPoint a, const FixedPoint &b) noexcept { return a -= b; }
+    [[nodiscard]] friend constexpr FixedPoint operator*(FixedPoint a, const FixedPoint &b) noexcept { return a *= b; }
+    [[nodiscard]] friend constexpr bool operator==(const FixedPoint &, const FixedPoint &) noexcept = default;
+
+private:
+    static int Digit(char c) {
+        if (c < '0' || c > '9') {
+            throw std::invalid_argument("FixedPoint: unexpected character in number");
+        }
+        return c - '0';
+    }
+
+    constexpr void Negate() noexcept {
+        unsigned __int128 carry = 1;
+        for (auto &limb : limbs_) {
+            carry += static_cast<std::uint64_t>(~limb);
+            limb = static_cast<std::uint64_t>(carry);
+            carry >>= 64;
+        }
+    }
+
+    // Деление неотрицательного числа на небольшое целое с усечением
+    constexpr void DivideMagnitude(std::uint64_t divisor) noexcept {
+        unsigned __int128 remainder = 0;
+        for (std::size_t i = LIMBS; i > 0; --i) {
+            const unsigned __int128 current = (remainder << 64) | limbs_[i - 1];
+            limbs_[i - 1] = static_cast<std::uint64_t>(current / divisor);
+            remainder = current % divisor;
+        }
+    }
+
+    std::array<std::uint64_t, LIMBS> limbs_{};
+};
+
+// Комплексное число повышенной точности
+struct FixedPointComplex {
+    FixedPoint real;
+    FixedPoint imag;
+
+    [[nodiscard]] friend constexpr bool operator==(const FixedPointComplex &, const FixedPointComplex &) noexcept =
+        default;
+};
+
+}  // namespace mandelbrot
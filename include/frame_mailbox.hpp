@@ -0,0 +1,91 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include "types.hpp"
+
+// Передача кадров из потоков пула в поток окна: SFML рисует только в потоке, создавшем окно.
+// Двойная буферизация: окно показывает последний принятый кадр, а в ящике лежит не больше одного
+// следующего; непоказанный промежуточный проход заменяется более новым.
+// Рендеринги нумеруются (см. Begin): вытесненный рендеринг дорабатывает до ближайшей проверки отмены,
+// и его кадры и ошибки отбрасываются.
+class FrameMailbox {
+public:
+    // Начинает новый рендеринг и возвращает его номер; непоказанный кадр прежнего рендеринга отбрасывается
+    [[nodiscard]] std::uint64_t Begin() {
+        const std::lock_guard lock{mutex_};
+        ++current_;
+        ++active_;
+        pending_.reset();
+        finished_ = false;
+        error_ = nullptr;
+        return current_;
+    }
+
+    // Кладёт кадр рендеринга render; вызывается из любого потока
+    void Post(std::uint64_t render, RenderResult frame) {
+        const std::lock_guard lock{mutex_};
+        if (render != current_) {
+            return;
+        }
+        pending_ = std::move(frame);
+        ready_.notify_all();
+    }
+
+    // Отмечает конец рендеринга render, в том числе отменённого; error передаётся потоку окна.
+    // Уведомление под блокировкой: дождавшись WaitIdle, владелец уничтожает ящик, и переменная условия
+    // не должна использоваться после снятия блокировки
+    void Finish(std::uint64_t render, std::exception_ptr error = nullptr) {
+        const std::lock_guard lock{mutex_};
+        --active_;
+        if (render == current_) {
+            finished_ = true;
+            error_ = std::move(error);
+        }
+        ready_.notify_all();
+    }
+
+    // Забирает готовый кадр без ожидания: поток окна продолжает обрабатывать ввод, пока кадр считается.
+    // Ошибка текущего рендеринга пробрасывается после его последнего кадра.
+    [[nodiscard]] std::optional<RenderResult> TryTake() {
+        const std::lock_guard lock{mutex_};
+        return TakeLocked();
+    }
+
+    // Ждёт следующий кадр текущего рендеринга; std::nullopt, если рендеринг завершён
+    [[nodiscard]] std::optional<RenderResult> Wait() {
+        std::unique_lock lock{mutex_};
+        ready_.wait(lock, [this] { return pending_.has_value() || finished_; });
+        return TakeLocked();
+    }
+
+    // Ждёт завершения всех начатых рендерингов, включая вытесненные: их операции ссылаются на ящик
+    void WaitIdle() {
+        std::unique_lock lock{mutex_};
+        ready_.wait(lock, [this] { return active_ == 0; });
+    }
+
+private:
+    [[nodiscard]] std::optional<RenderResult> TakeLocked() {
+        if (pending_) {
+            return std::exchange(pending_, std::nullopt);
+        }
+        if (error_) {
+            std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+        return std::nullopt;
+    }
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::optional<RenderResult> pending_;
+    std::uint64_t current_{0};
+    std::uint64_t active_{0};
+    bool finished_{true};
+    std::exception_ptr error_;
+};
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "mandelbrot_fractal_utils.hpp"
+#include "types.hpp"
+
+// Переиспользование предыдущего кадра при смене вида: при сдвиге на целое число пикселей
+// готовые пиксели переносятся и пересчитываются только открывшиеся полосы, при масштабировании
+// из предыдущего кадра строится превью до окончания полного расчёта.
+// Цвета переносятся, только если они есть и у previous, и у target; иначе раскраска — отдельный этап
+// (см. colorize.hpp).
+
+// Допустимое расхождение масштаба и сдвига в долях пикселя, при котором пиксели переносятся
+const constexpr double FRAME_REUSE_TOLERANCE{1e-3};
+
+// Сдвиг вида в пикселях: пиксель (x, y) нового кадра совпадает с пикселем (x + dx, y + dy) предыдущего
+struct FrameShift {
+    std::int64_t dx{0};
+    std::int64_t dy{0};
+};
+
+// Смещение левого верхнего угла вида viewport относительно угла вида previous
+[[nodiscard]] inline mandelbrot::Complex CornerOffset(const mandelbrot::ViewPort &previous,
+                                                      const mandelbrot::ViewPort &viewport) noexcept {
+    return {(viewport.origin.real - previous.origin.real).ToDouble() + (viewport.x_min - previous.x_min),
+            (viewport.origin.imag - previous.origin.imag).ToDouble() + (viewport.y_min - previous.y_min)};
+}
+
+// Сдвиг, если новый вид получен из вида previous переносом на ненулевое целое число пикселей
+// без изменения масштаба и настроек, влияющих на число итераций; иначе std::nullopt.
+// Повторный запрос того же вида считается явной перерисовкой и пиксели не переносит.
+[[nodiscard]] inline std::optional<FrameShift> FindFrameShift(const RenderResult &previous,
+                                                              const mandelbrot::ViewPort &viewport,
+                                                              const RenderSettings &settings) noexcept {
+    const RenderSettings &old = previous.settings;
+    // Проверки внутренних точек и ядро float могут иначе классифицировать точки у границы
+    if (old.width != settings.width || old.height != settings.height || old.max_iterations != settings.max_iterations ||
+        old.escape_radius != settings.escape_radius || old.interior_checks != settings.interior_checks ||
+        old.float_kernel != settings.float_kernel || settings.width == 0 || settings.height == 0) {
+        return std::nullopt;
+    }
+
+    const double pixel_width = viewport.width() / settings.width;
+    const double pixel_height = viewport.height() / settings.height;
+    if (std::abs(viewport.width() - previous.viewport.width()) > FRAME_REUSE_TOLERANCE * pixel_width ||
+        std::abs(viewport.height() - previous.viewport.height()) > FRAME_REUSE_TOLERANCE * pixel_height) {
+        return std::nullopt;
+    }
+
+    const auto offset = CornerOffset(previous.viewport, viewport);
+    const double dx = offset.real() / pixel_width;
+    const double dy = offset.imag() / pixel_height;
+    const double rounded_dx = std::round(dx);
+    const double rounded_dy = std::round(dy);
+    if (std::abs(dx - rounded_dx) > FRAME_REUSE_TOLERANCE || std::abs(dy - rounded_dy) > FRAME_REUSE_TOLERANCE ||
+        std::abs(rounded_dx) >= settings.width || std::abs(rounded_dy) >= settings.height ||
+        (rounded_dx == 0.0 && rounded_dy == 0.0)) {
+        return std::nullopt;
+    }
+    return FrameShift{static_cast<std::int64_t>(rounded_dx), static_cast<std::int64_t>(rounded_dy)};
+}
+
+// Переносит пиксели кадра previous со сдвигом shift в target (весь новый кадр)
+// и возвращает открывшиеся области, которые осталось вычислить
+[[nodiscard]] inline std::vector<PixelRegion> ShiftPreviousFrame(const RenderResult &previous, FrameShift shift,
+                                                                 const RenderTarget &target) {
+    const auto width = static_cast<std::int64_t>(target.pixels.width());
+    const auto height = static_cast<std::int64_t>(target.pixels.height());
+
+    // Строки и столбцы нового кадра, для которых есть пиксели в предыдущем
+    const auto row_begin = static_cast<std::uint32_t>(std::max<std::int64_t>(0, -shift.dy));
+    const auto row_end = static_cast<std::uint32_t>(std::min(height, height - shift.dy));
+    const auto col_begin = static_cast<std::uint32_t>(std::max<std::int64_t>(0, -shift.dx));
+    const auto col_end = static_cast<std::uint32_t>(std::min(width, width - shift.dx));
+
+    const bool copy_colors = target.HasColors() && !previous.color_data.empty();
+    for (std::uint32_t y = row_begin; y < row_end; ++y) {
+        const auto source_row = static_cast<std::size_t>(y + shift.dy);
+        const auto source_col = static_cast<std::size_t>(col_begin + shift.dx);
+        const auto pixels = previous.pixel_data[source_row].subspan(source_col, col_end - col_begin);
+        std::ranges::copy(pixels, target.pixels[y].begin() + col_begin);
+        if (copy_colors) {
+            const auto colors = previous.color_data[source_row].subspan(source_col, col_end - col_begin);
+            std::ranges::copy(colors, target.colors[y].begin() + col_begin);
+        }
+    }
+
+    std::vector<PixelRegion> exposed;
+    const auto full_width = static_cast<std::uint32_t>(width);
+    const auto full_height = static_cast<std::uint32_t>(height);
+    if (row_begin > 0) {
+        exposed.push_back(PixelRegion{.start_row = 0, .end_row = row_begin, .start_col = 0, .end_col = full_width});
+    }
+    if (row_end < full_height) {
+        exposed.push_back(
+            PixelRegion{.start_row = row_end, .end_row = full_height, .start_col = 0, .end_col = full_width});
+    }
+    if (col_begin > 0) {
+        exposed.push_back(
+            PixelRegion{.start_row = row_begin, .end_row = row_end, .start_col = 0, .end_col = col_begin});
+    }
+    if (col_end < full_width) {
+        exposed.push_back(
+            PixelRegion{.start_row = row_begin, .end_row = row_end, .start_col = col_end, .end_col = full_width});
+    }
+    return exposed;
+}
+
+// Превью нового вида из кадра previous методом ближайшего соседа: каждый пиксель берётся из ближайшего
+// пикселя предыдущего кадра, за его границами — из крайнего. Возвращает false, если виды не пересекаются.
+[[nodiscard]] inline bool ResamplePreviousFrame(const RenderResult &previous, const mandelbrot::ViewPort &viewport,
+                                                const RenderSettings &settings, const RenderTarget &target) {
+    const std::uint32_t old_width = previous.pixel_data.width();
+    const std::uint32_t old_height = previous.pixel_data.height();
+    if (old_width == 0 || old_height == 0 || settings.width == 0 || settings.height == 0) {
+        return false;
+    }
+
+    const auto offset = CornerOffset(previous.viewport, viewport);
+    if (offset.real() >= previous.viewport.width() || offset.real() + viewport.width() <= 0.0 ||
+        offset.imag() >= previous.viewport.height() || offset.imag() + viewport.height() <= 0.0) {
+        return false;
+    }
+
+    // Номер ближайшего пикселя предыдущего кадра по координате относительно его угла
+    auto nearest = [](double position, double old_pixel, std::uint32_t old_size) {
+        const double index = std::round(position / old_pixel);
+        return static_cast<std::uint32_t>(std::clamp(index, 0.0, static_cast<double>(old_size - 1)));
+    };
+
+    const double old_pixel_width = previous.viewport.width() / old_width;
+    const double old_pixel_height = previous.viewport.height() / old_height;
+    std::vector<std::uint32_t> source_cols(settings.width);
+    for (std::uint32_t x = 0; x < settings.width; ++x) {
+        const double position = offset.real() + static_cast<double>(x) / settings.width * viewport.width();
+        source_cols[x] = nearest(position, old_pixel_width, old_width);
+    }
+
+    const bool copy_colors = target.HasColors() && !previous.color_data.empty();
+    for (std::uint32_t y = 0; y < settings.height; ++y) {
+        const double position = offset.imag() + static_cast<double>(y) / settings.height * viewport.height();
+        const std::uint32_t source_row = nearest(position, old_pixel_height, old_height);
+        const auto pixels = previous.pixel_data[source_row];
+        const auto pixel_row = target.pixels[y];
+        for (std::uint32_t x = 0; x < settings.width; ++x) {
+            pixel_row[x] = pixels[source_cols[x]];
+        }
+        if (copy_colors) {
+            const auto colors = previous.color_data[source_row];
+            const auto color_row = target.colors[y];
+            for (std::uint32_t x = 0; x < settings.width; ++x) {
+                color_row[x] = colors[source_cols[x]];
+            }
+        }
+    }
+    return true;
+}
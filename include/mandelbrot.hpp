@@ -1,6 +1,9 @@
 #pragma once
 
+#include <memory>
+
 #include "mandelbrot_renderer.hpp"
+#include "render_stop.hpp"
 
 class CalculateMandelbrotAsyncSender {
 public:
@@ -14,16 +17,48 @@ public:
 
     template <typename Receiver>
     struct OperationState {
+        // Получатель кадра от RenderAsync: пересылает завершение внешнему получателю, а через get_env —
+        // его окружение, чтобы внешняя отмена дошла до рабочих потоков рендеринга
+        struct RenderReceiver {
+            using receiver_concept = stdexec::receiver_t;
+            OperationState *self_;
+
+            void set_value(RenderResult result) && noexcept {
+                self_->state_.need_rerender = false;  // Сбрасываем флаг после рендеринга
+                stdexec::set_value(std::move(self_->receiver_), std::move(result));
+            }
+
+            void set_error(std::exception_ptr error) && noexcept {
+                stdexec::set_error(std::move(self_->receiver_), std::move(error));
+            }
+
+            void set_stopped() && noexcept { stdexec::set_stopped(std::move(self_->receiver_)); }
+
+            [[nodiscard]] auto get_env() const noexcept { return stdexec::get_env(self_->receiver_); }
+        };
+
+        using RenderSender = decltype(std::declval<MandelbrotRenderer &>().RenderAsync(
+            std::declval<mandelbrot::ViewPort>(), std::declval<RenderSettings>()));
+        using RenderOperation = stdexec::connect_result_t<RenderSender, RenderReceiver>;
+
         Receiver receiver_;
         AppState &state_;
         RenderSettings render_settings_;
         MandelbrotRenderer &renderer_;
+        // Операция рендеринга должна жить до её завершения, а не до выхода из start()
+        std::unique_ptr<RenderOperation> operation_;
 
         template <typename R>
         explicit OperationState(R &&r, AppState &state, RenderSettings render_settings, MandelbrotRenderer &renderer)
             : receiver_{std::forward<R>(r)}, state_{state}, render_settings_{render_settings}, renderer_{renderer} {}
 
         void start() noexcept {
+            // Кадр, отменённый до запуска, не считается
+            if (StopRequested(receiver_)) {
+                stdexec::set_stopped(std::move(receiver_));
+                return;
+            }
+
             try {
                 // Проверяем, нужен ли рендеринг
                 if (!state_.need_rerender) {
@@ -38,15 +73,11 @@ public:
                 }
 
                 // Запускаем асинхронный рендеринг
-                auto render_sender = renderer_.RenderAsync<THREAD_POOL_SIZE>(state_.viewport, render_settings_);
+                auto render_sender = renderer_.RenderAsync(state_.viewport, render_settings_);
 
                 // Подключаем получателя к сендеру рендеринга
-                auto operation = stdexec::connect(std::move(render_sender), [this](RenderResult result) {
-                    state_.need_rerender = false;  // Сбрасываем флаг после рендеринга
-                    stdexec::set_value(std::move(receiver_), std::move(result));
-                });
-
-                stdexec::start(operation);
+                operation_.reset(new RenderOperation(stdexec::connect(std::move(render_sender), RenderReceiver{this})));
+                stdexec::start(*operation_);
             } catch (...) {
                 stdexec::set_error(std::move(receiver_), std::current_exception());
             }
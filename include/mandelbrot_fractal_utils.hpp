@@ -1,7 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
 #include <complex>
 #include <cstdint>
+#include <limits>
+
+#include "fixed_point.hpp"
 
 namespace mandelbrot {
 
@@ -12,16 +17,119 @@ struct ViewPort {
     double x_max{1.5};
     double y_min{-2.0};
     double y_max{2.0};
+    // Начало координат в повышенной точности: границы x_min..y_max отсчитываются от него.
+    // При глубоком приближении центр вида переносится сюда (см. Rebased), и границы остаются
+    // небольшими числами с полной относительной точностью double.
+    FixedPointComplex origin{};
 
     [[nodiscard]] constexpr double width() const noexcept { return x_max - x_min; }
     [[nodiscard]] constexpr double height() const noexcept { return y_max - y_min; }
 };
 
+// Во сколько раз смещение центра от начала координат может превышать ширину вида до переноса
+const constexpr double VIEWPORT_REBASE_RATIO{1e3};
+
+// Переносит центр вида в origin, если границы стали слишком малы относительно своего смещения
+// и double перестаёт различать соседние пиксели. Изображение при этом не меняется.
+[[nodiscard]] inline ViewPort Rebased(const ViewPort &viewport) noexcept {
+    const double center_x = (viewport.x_min + viewport.x_max) / 2.0;
+    const double center_y = (viewport.y_min + viewport.y_max) / 2.0;
+    if (std::max(std::abs(center_x), std::abs(center_y)) <=
+        std::max(viewport.width(), viewport.height()) * VIEWPORT_REBASE_RATIO) {
+        return viewport;
+    }
+
+    ViewPort result = viewport;
+    result.origin.real += FixedPoint{center_x};
+    result.origin.imag += FixedPoint{center_y};
+    result.x_min -= center_x;
+    result.x_max -= center_x;
+    result.y_min -= center_y;
+    result.y_max -= center_y;
+    return result;
+}
+
+// Тот же вид с нулевым origin: границы в абсолютных координатах (с точностью double)
+[[nodiscard]] inline ViewPort Flattened(const ViewPort &viewport) noexcept {
+    if (viewport.origin == FixedPointComplex{}) {
+        return viewport;
+    }
+    const double origin_x = viewport.origin.real.ToDouble();
+    const double origin_y = viewport.origin.imag.ToDouble();
+    return ViewPort{.x_min = viewport.x_min + origin_x,
+                    .x_max = viewport.x_max + origin_x,
+                    .y_min = viewport.y_min + origin_y,
+                    .y_max = viewport.y_max + origin_y};
+}
+
+// Вид заданного размера с центром center, заданным в повышенной точности
+[[nodiscard]] inline ViewPort MakeViewPort(const FixedPointComplex &center, double width, double height) noexcept {
+    return ViewPort{.x_min = -width / 2.0,
+                    .x_max = width / 2.0,
+                    .y_min = -height / 2.0,
+                    .y_max = height / 2.0,
+                    .origin = center};
+}
+
+// Точность вычисления кадра
+enum class Precision {
+    // Каждая точка итерируется в double
+    DOUBLE,
+    // Каждая точка итерируется в double-double, около 106 бит мантиссы (см. double_double.hpp)
+    DOUBLE_DOUBLE,
+    // Опорная орбита в повышенной точности и отклонения пикселей от неё в double
+    // (см. mandelbrot_perturbation.hpp)
+    PERTURBATION,
+};
+
+// Шаг между пикселями, ниже которого (относительно модуля точки, но не меньше 1)
+// double уже не различает соседние пиксели после нескольких итераций
+const constexpr double DOUBLE_MIN_PIXEL_SPACING{1e-14};
+// То же для double-double; глубже выгоднее возмущения
+const constexpr double DOUBLE_DOUBLE_MIN_PIXEL_SPACING{1e-28};
+
+// То же для float: не меньше этого шага вид можно считать ядром одинарной точности (см. FloatPrecisionSuffices)
+const constexpr double FLOAT_MIN_PIXEL_SPACING{1e-5};
+// Счётчик итераций float-ядра точен до 2^24
+const constexpr std::uint32_t FLOAT_MAX_ITERATIONS{1U << 24};
+
+// Шаг между пикселями вида относительно модуля его центра (но не меньше 1)
+[[nodiscard]] inline double RelativePixelSpacing(const ViewPort &viewport, std::uint32_t screen_width,
+                                                 std::uint32_t screen_height) noexcept {
+    const double spacing = std::min(viewport.width() / screen_width, viewport.height() / screen_height);
+    const double center_x = viewport.origin.real.ToDouble() + (viewport.x_min + viewport.x_max) / 2.0;
+    const double center_y = viewport.origin.imag.ToDouble() + (viewport.y_min + viewport.y_max) / 2.0;
+    return spacing / std::max({1.0, std::abs(center_x), std::abs(center_y)});
+}
+
+// Выбирает точность по шагу между пикселями вида
+[[nodiscard]] inline Precision SelectPrecision(const ViewPort &viewport, std::uint32_t screen_width,
+                                               std::uint32_t screen_height) noexcept {
+    const double spacing = RelativePixelSpacing(viewport, screen_width, screen_height);
+    if (spacing >= DOUBLE_MIN_PIXEL_SPACING) {
+        return Precision::DOUBLE;
+    }
+    return spacing >= DOUBLE_DOUBLE_MIN_PIXEL_SPACING ? Precision::DOUBLE_DOUBLE : Precision::PERTURBATION;
+}
+
+// Можно ли считать вид ядром одинарной точности: пиксели далеко от предела точности float.
+// Результат всё равно совпадает с double: сомнительные точки пересчитываются (см. CalculateIterationsForPointFloat).
+[[nodiscard]] inline bool FloatPrecisionSuffices(const ViewPort &viewport, std::uint32_t screen_width,
+                                                 std::uint32_t screen_height, std::uint32_t max_iterations) noexcept {
+    return max_iterations < FLOAT_MAX_ITERATIONS &&
+           RelativePixelSpacing(viewport, screen_width, screen_height) >= FLOAT_MIN_PIXEL_SPACING;
+}
+
+// Цвет пикселя в упакованном виде RGBA (байты r, g, b, a подряд), как пиксели текстуры SFML:
+// буфер цветов загружается в текстуру без преобразования, а таблица палитры выбирается
+// инструкциями gather по 32 бита на цвет
 struct RgbColor {
     std::uint8_t r;
     std::uint8_t g;
     std::uint8_t b;
+    std::uint8_t a{255};
 };
+static_assert(sizeof(RgbColor) == sizeof(std::uint32_t));
 
 struct RgbColors {
     RgbColors() = delete;
@@ -44,6 +152,148 @@ struct RgbColors {
     return max_iterations;
 }
 
+// Ускорения для точек внутри множества. Обе проверки дают ту же классификацию,
+// что и полный перебор (iterations == max_iterations), и включаются по отдельности для сравнения.
+struct InteriorChecks {
+    // Аналитическая проверка главной кардиоиды и круга периода 2
+    bool cardioid_bulb{false};
+    // Обнаружение цикла орбиты с контрольными точками на степенях двойки (метод Брента)
+    bool periodicity{false};
+    // Допуск, при котором точка орбиты считается совпавшей с контрольной
+    double periodicity_tolerance{1e-13};
+
+    // Проверки корректны только если внутренние орбиты не выходят за радиус убегания
+    [[nodiscard]] constexpr bool ApplicableFor(double escape_radius) const noexcept { return escape_radius >= 2.0; }
+
+    friend bool operator==(const InteriorChecks &, const InteriorChecks &) = default;
+};
+
+[[nodiscard]] constexpr bool IsInMainCardioidOrBulb(const Complex &c) noexcept {
+    const double x = c.real();
+    const double y2 = c.imag() * c.imag();
+
+    // Главная кардиоида
+    const double shifted_x = x - 0.25;
+    const double q = shifted_x * shifted_x + y2;
+    if (q * (q + shifted_x) <= 0.25 * y2) {
+        return true;
+    }
+
+    // Круг периода 2 с центром в -1 и радиусом 1/4
+    return (x + 1.0) * (x + 1.0) + y2 <= 0.0625;
+}
+
+[[nodiscard]] constexpr std::uint32_t CalculateIterationsForPoint(const Complex &c, std::uint32_t max_iterations,
+                                                                  double escape_radius,
+                                                                  const InteriorChecks &checks) noexcept {
+    if (!checks.ApplicableFor(escape_radius)) {
+        return CalculateIterationsForPoint(c, max_iterations, escape_radius);
+    }
+    if (checks.cardioid_bulb && IsInMainCardioidOrBulb(c)) {
+        return max_iterations;
+    }
+    if (!checks.periodicity) {
+        return CalculateIterationsForPoint(c, max_iterations, escape_radius);
+    }
+
+    Complex z{0.0, 0.0};
+    Complex checkpoint{0.0, 0.0};
+    std::uint64_t next_checkpoint = 1;
+    const double escape_radius_squared = escape_radius * escape_radius;
+
+    for (std::uint32_t i = 0; i < max_iterations; ++i) {
+        if (std::norm(z) > escape_radius_squared) {
+            return i;
+        }
+        z = z * z + c;
+
+        // Орбита вернулась к контрольной точке: она периодическая и никогда не убежит
+        if (std::abs(z.real() - checkpoint.real()) <= checks.periodicity_tolerance &&
+            std::abs(z.imag() - checkpoint.imag()) <= checks.periodicity_tolerance) {
+            return max_iterations;
+        }
+        if (i + 1 == next_checkpoint) {
+            checkpoint = z;
+            next_checkpoint *= 2;
+        }
+    }
+    return max_iterations;
+}
+
+// Результат float-ядра для точки, которую нужно пересчитать в double
+const constexpr std::uint32_t FLOAT_FALLBACK{std::numeric_limits<std::uint32_t>::max()};
+// Граница ошибки округления одной итерации в float относительно |z|^2 + |c|: восемь половин ulp
+// (с запасом на округление каждой операции и на ошибку самого double)
+const constexpr float FLOAT_ROUNDING_BOUND{8.0f * std::numeric_limits<float>::epsilon() / 2.0f};
+// Наименьшее расстояние до контрольной точки, при котором орбита float считается периодической
+const constexpr float FLOAT_PERIODICITY_TOLERANCE{1e-5f};
+
+// Итерации точки в float с оценкой сверху error расстояния до точной орбиты:
+// error' = error * (2|z| + error) + FLOAT_ROUNDING_BOUND * (|z|^2 + |c|), где |z| <= |re z| + |im z|.
+// Если на какой-то итерации точная орбита может оказаться по другую сторону радиуса убегания, чем орбита
+// float, или орбита с учётом ошибки могла совпасть с контрольной точкой (проверка периодичности в double),
+// возвращается FLOAT_FALLBACK: точку нужно посчитать в double.
+// Иначе результат совпадает с CalculateIterationsForPoint с теми же checks.
+[[nodiscard]] constexpr std::uint32_t CalculateIterationsForPointFloat(const Complex &c, std::uint32_t max_iterations,
+                                                                       double escape_radius,
+                                                                       const InteriorChecks &checks) noexcept {
+    const bool applicable = checks.ApplicableFor(escape_radius);
+    if (applicable && checks.cardioid_bulb && IsInMainCardioidOrBulb(c)) {
+        return max_iterations;
+    }
+    const bool periodicity = applicable && checks.periodicity;
+    const float tolerance = std::max(FLOAT_PERIODICITY_TOLERANCE, static_cast<float>(checks.periodicity_tolerance));
+
+    const float cr = static_cast<float>(c.real());
+    const float ci = static_cast<float>(c.imag());
+    const float c_magnitude = std::abs(cr) + std::abs(ci);
+    const float radius = static_cast<float>(escape_radius);
+    const float radius_squared = static_cast<float>(escape_radius * escape_radius);
+
+    float zr = 0.0f;
+    float zi = 0.0f;
+    float error = 0.0f;
+    float checkpoint_r = 0.0f;
+    float checkpoint_i = 0.0f;
+    float checkpoint_error = 0.0f;
+    std::uint64_t next_checkpoint = 1;
+
+    for (std::uint32_t i = 0; i < max_iterations; ++i) {
+        const float zr2 = zr * zr;
+        const float zi2 = zi * zi;
+        const float norm = zr2 + zi2;
+        const float low = radius - error;
+        const float high = radius + error;
+        if (error >= radius || (norm > low * low && norm <= high * high)) {
+            return FLOAT_FALLBACK;
+        }
+        if (norm > radius_squared) {
+            return i;
+        }
+
+        error = error * ((std::abs(zr) + std::abs(zi)) * 2.0f + error) + FLOAT_ROUNDING_BOUND * (norm + c_magnitude);
+        const float zrzi = zr * zi;
+        zr = zr2 - zi2 + cr;
+        zi = zrzi + zrzi + ci;
+
+        if (periodicity) {
+            // Периодичность в float не доказывает принадлежность множеству: точка уходит в double,
+            // а бесконечная ошибка завершает её на следующей итерации (как в векторном ядре)
+            const float match = tolerance + error + checkpoint_error;
+            if (std::abs(zr - checkpoint_r) <= match && std::abs(zi - checkpoint_i) <= match) {
+                error = std::numeric_limits<float>::infinity();
+            }
+            if (i + 1 == next_checkpoint) {
+                checkpoint_r = zr;
+                checkpoint_i = zi;
+                checkpoint_error = error;
+                next_checkpoint *= 2;
+            }
+        }
+    }
+    return max_iterations;
+}
+
 [[nodiscard]] constexpr Complex Pixel2DToComplex(std::uint32_t x, std::uint32_t y, const ViewPort &viewport,
                                                  const std::uint32_t screen_width,
                                                  const std::uint32_t screen_height) noexcept {
@@ -53,6 +303,16 @@ struct RgbColors {
     return Complex{real, imag};
 }
 
+// Точка по дробным координатам кадра (выборки сглаживания): пиксель x, y покрывает [x, x + 1) x [y, y + 1),
+// целые координаты дают ту же точку, что Pixel2DToComplex
+[[nodiscard]] constexpr Complex Subpixel2DToComplex(double x, double y, const ViewPort &viewport,
+                                                    const std::uint32_t screen_width,
+                                                    const std::uint32_t screen_height) noexcept {
+    const double real = viewport.x_min + (x / screen_width) * viewport.width();
+    const double imag = viewport.y_min + (y / screen_height) * viewport.height();
+    return Complex{real, imag};
+}
+
 [[nodiscard]] constexpr RgbColor IterationsToColor(std::uint32_t iterations, std::uint32_t max_iterations) noexcept {
 
     // Точка принадлежит множеству Мандельброта
@@ -0,0 +1,409 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <span>
+#include <stdexec/execution.hpp>
+#include <vector>
+
+#include "fixed_point.hpp"
+#include "mandelbrot_fractal_utils.hpp"
+#include "palette.hpp"
+#include "render_stop.hpp"
+#include "tile_queue.hpp"
+#include "types.hpp"
+
+namespace mandelbrot {
+
+// Пиксель считается глитчем, если |Z_n + dz_n| < GLITCH_TOLERANCE * |Z_n| (критерий Pauldelbrot):
+// в этот момент отклонение сравнимо с самой опорной орбитой и теряет точность
+const constexpr double PERTURBATION_GLITCH_TOLERANCE{1e-3};
+// Сколько раз кадр может выбрать новую опорную точку для оставшихся глитчей
+const constexpr std::uint32_t PERTURBATION_MAX_REFERENCES{16};
+
+// Опорная орбита Z_0..Z_k, посчитанная в повышенной точности и округлённая до double.
+// Если опорная точка убежала раньше max_iterations, орбита обрывается на первой точке за радиусом убегания.
+struct ReferenceOrbit {
+    // Смещение опорной точки от ViewPort::origin
+    Complex offset;
+    std::vector<Complex> points;
+};
+
+[[nodiscard]] inline ReferenceOrbit CalculateReferenceOrbit(const FixedPointComplex &origin, Complex offset,
+                                                            std::uint32_t max_iterations, double escape_radius) {
+    const FixedPoint c_real = origin.real + FixedPoint{offset.real()};
+    const FixedPoint c_imag = origin.imag + FixedPoint{offset.imag()};
+    const double escape_radius_squared = escape_radius * escape_radius;
+
+    ReferenceOrbit orbit{.offset = offset, .points = {}};
+    orbit.points.reserve(static_cast<std::size_t>(max_iterations) + 1);
+
+    FixedPoint z_real;
+    FixedPoint z_imag;
+    orbit.points.emplace_back(0.0, 0.0);
+    for (std::uint32_t i = 0; i < max_iterations; ++i) {
+        if (std::norm(orbit.points.back()) > escape_radius_squared) {
+            break;
+        }
+        const FixedPoint real_squared = z_real * z_real;
+        const FixedPoint imag_squared = z_imag * z_imag;
+        const FixedPoint real_imag = z_real * z_imag;
+        z_real = real_squared - imag_squared + c_real;
+        z_imag = real_imag + real_imag + c_imag;
+        orbit.points.emplace_back(z_real.ToDouble(), z_imag.ToDouble());
+    }
+    return orbit;
+}
+
+struct PerturbedIterations {
+    std::uint32_t iterations;
+    // Результат недостоверен: пиксель нужно пересчитать от другой опорной точки
+    bool glitched;
+};
+
+// Итерирует отклонение dz пикселя c = reference + delta_c от опорной орбиты:
+// dz_{n+1} = 2 * Z_n * dz_n + dz_n^2 + delta_c, z_n = Z_n + dz_n
+[[nodiscard]] inline PerturbedIterations CalculateIterationsPerturbed(const ReferenceOrbit &orbit,
+                                                                      const Complex &delta_c,
+                                                                      std::uint32_t max_iterations,
+                                                                      double escape_radius) noexcept {
+    const double escape_radius_squared = escape_radius * escape_radius;
+    const double glitch_tolerance_squared = PERTURBATION_GLITCH_TOLERANCE * PERTURBATION_GLITCH_TOLERANCE;
+    const std::size_t orbit_size = orbit.points.size();
+
+    double dz_real = 0.0;
+    double dz_imag = 0.0;
+    for (std::uint32_t i = 0; i < max_iterations; ++i) {
+        if (i >= orbit_size) {
+            // Опорная точка убежала раньше пикселя: продолжать не от чего
+            return {i, true};
+        }
+        const double reference_real = orbit.points[i].real();
+        const double reference_imag = orbit.points[i].imag();
+        const double z_real = reference_real + dz_real;
+        const double z_imag = reference_imag + dz_imag;
+        const double z_norm = z_real * z_real + z_imag * z_imag;
+
+        if (z_norm > escape_radius_squared) {
+            return {i, false};
+        }
+        if (z_norm < glitch_tolerance_squared * (reference_real * reference_real + reference_imag * reference_imag)) {
+            return {i, true};
+        }
+
+        const double next_real = 2.0 * (reference_real * dz_real - reference_imag * dz_imag) +
+                                 (dz_real * dz_real - dz_imag * dz_imag) + delta_c.real();
+        const double next_imag =
+            2.0 * (reference_real * dz_imag + reference_imag * dz_real) + 2.0 * dz_real * dz_imag + delta_c.imag();
+        dz_real = next_real;
+        dz_imag = next_imag;
+    }
+    return {max_iterations, false};
+}
+
+}  // namespace mandelbrot
+
+// Рендеринг глубокого приближения методом возмущений. Пиксели кадра итерируются в double как отклонения
+// от одной опорной орбиты; пиксели-глитчи собираются и пересчитываются от новой опорной точки,
+// выбранной среди них, пока глитчи не исчезнут или не кончится PERTURBATION_MAX_REFERENCES.
+// target покрывает весь кадр.
+class PerturbationRenderer {
+public:
+    PerturbationRenderer(mandelbrot::ViewPort viewport, RenderSettings settings, RenderTarget target) noexcept
+        : viewport_{viewport}, settings_{settings}, target_{target} {}
+
+    // Первая опорная точка — центр вида
+    [[nodiscard]] mandelbrot::Complex CenterOffset() const noexcept {
+        return {(viewport_.x_min + viewport_.x_max) / 2.0, (viewport_.y_min + viewport_.y_max) / 2.0};
+    }
+
+    void SetReference(mandelbrot::Complex offset) {
+        orbit_ = mandelbrot::CalculateReferenceOrbit(viewport_.origin, offset, settings_.max_iterations,
+                                                     settings_.escape_radius);
+    }
+
+    // Вычисляет пиксель от текущей опорной орбиты; возвращает true, если он оказался глитчем.
+    // Цвет записывается только для достоверных пикселей и только если у target есть буфер цветов.
+    bool RenderPixel(std::uint32_t x, std::uint32_t y, const mandelbrot::Palette &palette) const noexcept {
+        const auto delta_c =
+            mandelbrot::Pixel2DToComplex(x, y, viewport_, settings_.width, settings_.height) - orbit_.offset;
+        const auto [iterations, glitched] = mandelbrot::CalculateIterationsPerturbed(
+            orbit_, delta_c, settings_.max_iterations, settings_.escape_radius);
+
+        target_.pixels(x, y) = iterations;
+        if (!glitched && target_.HasColors()) {
+            target_.colors(x, y) = palette[iterations];
+        }
+        return glitched;
+    }
+
+    // Вычисляет область и дописывает номера пикселей-глитчей (y * width + x) в glitches
+    void RenderRegion(const PixelRegion &region, std::vector<std::uint32_t> &glitches) const {
+        const auto &palette = mandelbrot::CachedPalette(settings_);
+        for (std::uint32_t y = region.start_row; y < region.end_row; ++y) {
+            for (std::uint32_t x = region.start_col; x < region.end_col; ++x) {
+                if (RenderPixel(x, y, palette)) {
+                    glitches.push_back(y * settings_.width + x);
+                }
+            }
+        }
+    }
+
+    // Пересчитывает пиксели по номерам из pixels, глитчи снова дописываются в glitches
+    void RenderPixels(std::span<const std::uint32_t> pixels, std::vector<std::uint32_t> &glitches) const {
+        const auto &palette = mandelbrot::CachedPalette(settings_);
+        for (const auto index : pixels) {
+            if (RenderPixel(index % settings_.width, index / settings_.width, palette)) {
+                glitches.push_back(index);
+            }
+        }
+    }
+
+    // Новая опорная точка для оставшихся глитчей: средний из них в порядке строк,
+    // обычно лежит внутри самой крупной области глитчей
+    [[nodiscard]] mandelbrot::Complex PickReference(std::span<const std::uint32_t> glitches) const noexcept {
+        const auto index = glitches[glitches.size() / 2];
+        return mandelbrot::Pixel2DToComplex(index % settings_.width, index / settings_.width, viewport_,
+                                            settings_.width, settings_.height);
+    }
+
+    // Раскрашивает пиксели, которые остались глитчами после всех опорных точек
+    void Finalize(std::span<const std::uint32_t> glitches) const {
+        if (!target_.HasColors()) {
+            return;
+        }
+        const auto &palette = mandelbrot::CachedPalette(settings_);
+        for (const auto index : glitches) {
+            const std::uint32_t x = index % settings_.width;
+            const std::uint32_t y = index / settings_.width;
+            target_.colors(x, y) = palette[target_.pixels(x, y)];
+        }
+    }
+
+    // Последовательный рендеринг всего кадра в текущем потоке
+    void Render() {
+        std::vector<std::uint32_t> glitches;
+        SetReference(CenterOffset());
+        RenderRegion(PixelRegion{0, settings_.height, 0, settings_.width}, glitches);
+
+        for (std::uint32_t reference = 1; reference < mandelbrot::PERTURBATION_MAX_REFERENCES && !glitches.empty();
+             ++reference) {
+            SetReference(PickReference(glitches));
+            std::vector<std::uint32_t> remaining;
+            RenderPixels(glitches, remaining);
+            glitches = std::move(remaining);
+        }
+        Finalize(glitches);
+    }
+
+private:
+    mandelbrot::ViewPort viewport_;
+    RenderSettings settings_;
+    RenderTarget target_;
+    mandelbrot::ReferenceOrbit orbit_;
+};
+
+// Параллельный рендеринг методом возмущений. Каждый проход: опорная орбита считается в одной задаче,
+// затем workers задач пула разбирают работу (плитки на первом проходе, порции глитчей на следующих).
+// Последняя завершившаяся задача собирает глитчи и запускает следующий проход или завершает операцию.
+// Отмена проверяется перед каждой плиткой и порцией глитчей; прерванный проход завершает операцию set_stopped.
+// Исключение в задаче останавливает проход, и операция завершается set_error с первым из них.
+template <typename Scheduler, typename Receiver>
+struct PerturbationOperationState {
+    static constexpr std::uint32_t GLITCH_CHUNK_SIZE = 1024;
+
+    Receiver receiver_;
+    Scheduler scheduler_;
+    PerturbationRenderer renderer_;
+    RenderSettings settings_;
+    std::uint32_t workers_;
+    TileQueue tiles_;
+    stdexec::inplace_stop_token stop_token_;
+    std::uint32_t reference_{0};
+
+    // Глитчи текущего прохода и глитчи, найденные каждым рабочим
+    std::vector<std::uint32_t> glitches_;
+    std::vector<std::vector<std::uint32_t>> worker_glitches_;
+    std::atomic<std::uint32_t> next_chunk_{0};
+    std::atomic<std::uint32_t> active_workers_{0};
+    std::atomic<bool> stopped_{false};
+    // Первое исключение рабочих задач прохода
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+
+    template <typename R>
+    explicit PerturbationOperationState(R &&r, Scheduler scheduler, PerturbationRenderer renderer,
+                                        RenderSettings settings, std::uint32_t workers,
+                                        std::vector<PixelRegion> regions, stdexec::inplace_stop_token stop_token)
+        : receiver_{std::forward<R>(r)}, scheduler_{scheduler}, renderer_{std::move(renderer)}, settings_{settings},
+          workers_{std::max<std::uint32_t>(workers, 1)}, tiles_{std::move(regions), settings.tile_size},
+          stop_token_{stop_token} {}
+
+    void start() noexcept {
+        if (settings_.width == 0 || settings_.height == 0) {
+            stdexec::set_value(std::move(receiver_));
+            return;
+        }
+        Spawn([this] { BeginPass(); });
+    }
+
+    template <typename F>
+    void Spawn(F task) noexcept {
+        try {
+            stdexec::start_detached(stdexec::schedule(scheduler_) | stdexec::then(task));
+        } catch (...) {
+            // Задачу не удалось запланировать: выполняем её в текущем потоке
+            task();
+        }
+    }
+
+    [[nodiscard]] bool CheckStop() noexcept {
+        if (StopRequested(receiver_, stop_token_)) {
+            stopped_.store(true, std::memory_order_relaxed);
+        }
+        return stopped_.load(std::memory_order_relaxed);
+    }
+
+    void BeginPass() noexcept {
+        if (CheckStop()) {
+            stdexec::set_stopped(std::move(receiver_));
+            return;
+        }
+        try {
+            renderer_.SetReference(reference_ == 0 ? renderer_.CenterOffset() : renderer_.PickReference(glitches_));
+            worker_glitches_.assign(workers_, {});
+        } catch (...) {
+            stdexec::set_error(std::move(receiver_), std::current_exception());
+            return;
+        }
+
+        next_chunk_.store(0, std::memory_order_relaxed);
+        active_workers_.store(workers_, std::memory_order_relaxed);
+        for (std::uint32_t worker = 0; worker < workers_; ++worker) {
+            Spawn([this, worker] { Work(worker); });
+        }
+    }
+
+    void Work(std::uint32_t worker) noexcept {
+        auto &found = worker_glitches_[worker];
+        try {
+            if (reference_ == 0) {
+                while (!CheckStop()) {
+                    const auto tile = tiles_.Next();
+                    if (!tile) {
+                        break;
+                    }
+                    renderer_.RenderRegion(*tile, found);
+                }
+            } else {
+                const std::span<const std::uint32_t> glitches{glitches_};
+                for (std::size_t start = next_chunk_.fetch_add(1, std::memory_order_relaxed) * GLITCH_CHUNK_SIZE;
+                     start < glitches.size() && !CheckStop();
+                     start = next_chunk_.fetch_add(1, std::memory_order_relaxed) * GLITCH_CHUNK_SIZE) {
+                    renderer_.RenderPixels(glitches.subspan(start, std::min<std::size_t>(GLITCH_CHUNK_SIZE,
+                                                                                        glitches.size() - start)),
+                                           found);
+                }
+            }
+        } catch (...) {
+            // Например, не хватило памяти под список глитчей: часть пикселей прохода осталась без результата
+            const std::lock_guard lock{error_mutex_};
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+            stopped_.store(true, std::memory_order_relaxed);
+        }
+
+        if (active_workers_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            FinishPass();
+        }
+    }
+
+    void FinishPass() noexcept {
+        if (error_) {
+            stdexec::set_error(std::move(receiver_), std::move(error_));
+            return;
+        }
+        if (stopped_.load(std::memory_order_relaxed)) {
+            stdexec::set_stopped(std::move(receiver_));
+            return;
+        }
+        try {
+            glitches_.clear();
+            for (const auto &found : worker_glitches_) {
+                glitches_.insert(glitches_.end(), found.begin(), found.end());
+            }
+            // Порядок строк нужен для выбора следующей опорной точки (см. PickReference)
+            std::ranges::sort(glitches_);
+        } catch (...) {
+            stdexec::set_error(std::move(receiver_), std::current_exception());
+            return;
+        }
+
+        if (!glitches_.empty() && ++reference_ < mandelbrot::PERTURBATION_MAX_REFERENCES) {
+            BeginPass();
+            return;
+        }
+        try {
+            // Раскраска берёт палитру из CachedPalette, построение которой может бросить bad_alloc
+            renderer_.Finalize(glitches_);
+        } catch (...) {
+            stdexec::set_error(std::move(receiver_), std::current_exception());
+            return;
+        }
+        stdexec::set_value(std::move(receiver_));
+    }
+};
+
+template <typename Scheduler>
+struct PerturbationSender {
+    Scheduler scheduler_;
+    mandelbrot::ViewPort viewport_;
+    RenderSettings settings_;
+    RenderTarget target_;
+    std::uint32_t workers_;
+    std::vector<PixelRegion> regions_;
+    stdexec::inplace_stop_token stop_token_;
+
+    using completion_signatures =
+        stdexec::completion_signatures<stdexec::set_value_t(), stdexec::set_error_t(std::exception_ptr),
+                                       stdexec::set_stopped_t()>;
+
+    template <typename Env>
+    auto get_completion_signatures(Env) const -> completion_signatures {
+        return {};
+    }
+
+    template <typename R>
+    auto connect(R &&r) {
+        return PerturbationOperationState<Scheduler, std::decay_t<R>>{
+            std::forward<R>(r), scheduler_, PerturbationRenderer{viewport_, settings_, target_}, settings_, workers_,
+            regions_, stop_token_};
+    }
+};
+
+// target должен покрывать весь кадр settings.width x settings.height.
+// Вычисляются только области regions, остальные пиксели target не меняются.
+template <typename Scheduler>
+[[nodiscard]] auto MakePerturbationSender(Scheduler scheduler, mandelbrot::ViewPort viewport, RenderSettings settings,
+                                          RenderTarget target, std::uint32_t workers,
+                                          std::vector<PixelRegion> regions,
+                                          stdexec::inplace_stop_token stop_token = {}) {
+    return PerturbationSender<Scheduler>{
+        scheduler, viewport, settings, target, workers, std::move(regions), stop_token};
+}
+
+template <typename Scheduler>
+[[nodiscard]] auto MakePerturbationSender(Scheduler scheduler, mandelbrot::ViewPort viewport, RenderSettings settings,
+                                          RenderTarget target, std::uint32_t workers) {
+    const PixelRegion frame{.start_row = 0, .end_row = settings.height, .start_col = 0, .end_col = settings.width};
+    return MakePerturbationSender(scheduler, viewport, settings, target, workers, std::vector{frame});
+}
+
+namespace stdexec {
+template <typename Scheduler>
+inline constexpr bool enable_sender<PerturbationSender<Scheduler>> = true;
+}
@@ -1,79 +1,481 @@
 #pragma once
 
 #include <algorithm>
-#include <array>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
 #include <exec/static_thread_pool.hpp>
+#include <exec/variant_sender.hpp>
 #include <stdexec/execution.hpp>
 
+#include "colorize.hpp"
+#include "fan_out.hpp"
+#include "frame_reuse.hpp"
+#include "mandelbrot_perturbation.hpp"
 #include "mandelbrot_sender.hpp"
+#include "mariani_silver.hpp"
+#include "progressive_render.hpp"
+#include "render_stats.hpp"
+#include "supersampling.hpp"
+#include "tile_cache.hpp"
+#include "tile_queue.hpp"
 #include "types.hpp"
 
+// Как кадр делит рендерер с другими кадрами (см. MandelbrotRenderer::RenderAsync)
+enum class FrameKind {
+    // Кадр окна: вытесняет незаконченный кадр, переносит пиксели прошлого кадра и плитки из кэша
+    INTERACTIVE,
+    // Независимый кадр (полоса пакетного рендеринга, кадр анимации): не вытесняет другие кадры и не вытесняется
+    // ими, не использует и не запоминает прошлые кадры и кэш плиток. Несколько таких кадров считаются на пуле
+    // одновременно.
+    INDEPENDENT,
+};
+
 class MandelbrotRenderer {
 private:
+    std::uint32_t num_threads_;
     exec::static_thread_pool thread_pool_;
 
+    // Итерации последнего готового кадра: источник пикселей при сдвиге вида, превью при масштабировании
+    // и перекраски (см. RecolorLastFrame). Цвета не хранятся — они восстанавливаются из итераций.
+    mutable std::mutex last_frame_mutex_;
+    std::optional<RenderResult> last_frame_;
+
+    // Плитки итераций прошлых кадров на глобальной сетке (см. tile_cache.hpp): кадр в double, пиксели которого
+    // лежат на узлах сетки, берёт из кэша уже посчитанные плитки
+    TileCache tile_cache_;
+
+    // Источник отмены кадра, который считается сейчас. Кадр, начатый позже, вытесняет его (см. BeginFrame):
+    // при непрерывном масштабировании незаконченные кадры устаревших видов не занимают пул.
+    std::mutex frame_stop_mutex_;
+    std::shared_ptr<stdexec::inplace_stop_source> frame_stop_;
+
+    // Вызывается при запуске рендеринга кадра: запрашивает отмену предыдущего и возвращает источник отмены
+    // нового кадра. Источник живёт, пока его держит операция кадра.
+    [[nodiscard]] std::shared_ptr<stdexec::inplace_stop_source> BeginFrame() {
+        auto frame_stop = std::make_shared<stdexec::inplace_stop_source>();
+        const std::lock_guard lock{frame_stop_mutex_};
+        if (frame_stop_) {
+            frame_stop_->request_stop();
+        }
+        frame_stop_ = frame_stop;
+        return frame_stop;
+    }
+
+    // Переносит пиксели последнего кадра, если новый вид — его сдвиг на целое число пикселей.
+    // Возвращает открывшиеся области или std::nullopt, если кадр нужно считать целиком.
+    [[nodiscard]] std::optional<std::vector<PixelRegion>> ReuseLastFrame(const mandelbrot::ViewPort &viewport,
+                                                                         const RenderSettings &settings,
+                                                                         const RenderTarget &target) const {
+        const std::lock_guard lock{last_frame_mutex_};
+        if (!last_frame_) {
+            return std::nullopt;
+        }
+        const auto shift = FindFrameShift(*last_frame_, viewport, settings);
+        if (!shift) {
+            return std::nullopt;
+        }
+        return ShiftPreviousFrame(*last_frame_, *shift, target);
+    }
+
+    [[nodiscard]] bool CanReuseLastFrame(const mandelbrot::ViewPort &viewport, const RenderSettings &settings) const {
+        const std::lock_guard lock{last_frame_mutex_};
+        return last_frame_ && FindFrameShift(*last_frame_, viewport, settings).has_value();
+    }
+
+    // Есть ли в кэше плитки для кадра вида viewport
+    [[nodiscard]] bool HasCachedTiles(const mandelbrot::ViewPort &viewport, const RenderSettings &settings,
+                                      mandelbrot::Precision precision) const {
+        if (precision != mandelbrot::Precision::DOUBLE) {
+            return false;
+        }
+        const auto placement = PlaceOnTileGrid(mandelbrot::Flattened(viewport), settings);
+        return placement && tile_cache_.ContainsAny(*placement, settings);
+    }
+
+    // Запоминает итерации готового кадра; кадр на сетке кэша (placement) сохраняет и свои плитки
+    void RememberFrame(const RenderResult &frame, const std::optional<TileGridPlacement> &placement) {
+        if (placement) {
+            tile_cache_.Store(*placement, frame.settings, frame.pixel_data.View());
+        }
+        RenderResult copy{.pixel_data = frame.pixel_data,
+                          .color_data = ColorMatrix{},
+                          .viewport = frame.viewport,
+                          .settings = frame.settings,
+                          .render_time = frame.render_time,
+                          .stats = frame.stats};
+        const std::lock_guard lock{last_frame_mutex_};
+        last_frame_ = std::move(copy);
+    }
+
+    // Кадр для итераций; буфер цветов выделяется, только если кадр будет раскрашен
+    [[nodiscard]] static RenderResult AllocateFrame(const mandelbrot::ViewPort &viewport,
+                                                    const RenderSettings &settings) {
+        return RenderResult{.pixel_data = PixelMatrix(settings.width, settings.height),
+                            .color_data = settings.colorize ? ColorMatrix(settings.width, settings.height)
+                                                            : ColorMatrix{},
+                            .viewport = viewport,
+                            .settings = settings,
+                            .render_time = std::chrono::milliseconds{0}};
+    }
+
+    // Этап раскраски по готовым итерациям: partitions задач раскрашивают полосы строк кадра.
+    // Кадр без settings.colorize этап пропускает. Время задач добавляется к их занятости в stats.
+    template <typename Scheduler>
+    [[nodiscard]] static auto ColorizeAsync(Scheduler sched, std::uint32_t partitions, RenderResult &frame,
+                                            RenderStatsCollector &stats, stdexec::inplace_stop_token stop_token) {
+        const std::uint32_t height = frame.pixel_data.height();
+        const std::uint32_t workers = frame.settings.colorize ? std::min(partitions, height) : 0;
+        return MakeFanOutSender(
+            sched, workers,
+            [&frame, &stats, height, workers](std::uint32_t worker, auto should_stop) {
+                if (should_stop()) {
+                    return false;
+                }
+                const auto busy = stats.TrackBusy(worker);
+                const auto start_row = static_cast<std::uint32_t>(std::uint64_t{height} * worker / workers);
+                const auto end_row = static_cast<std::uint32_t>(std::uint64_t{height} * (worker + 1) / workers);
+                ColorizeRows(frame, mandelbrot::CachedPalette(frame.settings), start_row, end_row);
+                return true;
+            },
+            stop_token);
+    }
+
+    // Этап адаптивного сглаживания по готовым итерациям и цветам (см. supersampling.hpp): partitions задач
+    // разбирают плитки кадра и усредняют цвета пикселей-границ. Этап пропускается, если сглаживание к кадру
+    // не применяется (см. SupersamplingApplies).
+    template <typename Scheduler>
+    [[nodiscard]] static auto SupersampleAsync(Scheduler sched, std::uint32_t partitions, RenderResult &frame,
+                                               mandelbrot::Precision precision, RenderStatsCollector &stats,
+                                               stdexec::inplace_stop_token stop_token) {
+        const std::uint32_t workers = SupersamplingApplies(frame.settings, precision) ? partitions : 0;
+        return stdexec::let_value(
+            stdexec::just(TileQueue{frame.settings.width, frame.settings.height, frame.settings.tile_size}),
+            [sched, workers, precision, &frame, &stats, stop_token](TileQueue &queue) {
+                const AdaptiveSupersampler supersampler{frame.viewport, frame.settings, precision,
+                                                        std::as_const(frame.pixel_data).View(),
+                                                        frame.color_data.View()};
+                return MakeFanOutSender(
+                    sched, workers,
+                    [supersampler, &queue, &stats](std::uint32_t worker, auto should_stop) {
+                        const auto busy = stats.TrackBusy(worker);
+                        while (const auto tile = queue.Next()) {
+                            if (should_stop()) {
+                                return false;
+                            }
+                            stats.AddSupersampled(worker, supersampler.Render(*tile));
+                        }
+                        return true;
+                    },
+                    stop_token);
+            });
+    }
+
+    // Время рендеринга с момента started, занятость задач и счётчики пикселей готового кадра
+    static void FinishStats(RenderResult &frame, const RenderStatsCollector &collector,
+                            std::chrono::steady_clock::time_point started, std::uint64_t reused_pixels) {
+        frame.render_time =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+        collector.MergeInto(frame.stats);
+        CountPixels(frame.stats, frame.pixel_data, frame.settings.max_iterations);
+        frame.stats.reused_pixels = reused_pixels;
+    }
+
+    // Число рабочих задач кадра: по умолчанию (0) — по числу потоков пула
+    [[nodiscard]] std::uint32_t Partitions(std::uint32_t partitions) const noexcept {
+        return partitions == 0 ? num_threads_ : partitions;
+    }
+
+    // Один проход прогрессивного рендеринга: partitions рабочих задач разбирают плитки всего кадра
+    template <typename Scheduler>
+    [[nodiscard]] static auto RenderPassAsync(Scheduler sched, std::uint32_t partitions, mandelbrot::ViewPort viewport,
+                                              RenderSettings settings, RenderTarget target,
+                                              mandelbrot::Precision precision, std::uint32_t pass,
+                                              RenderStatsCollector &stats, stdexec::inplace_stop_token stop_token) {
+        return stdexec::let_value(
+            stdexec::just(TileQueue{settings.width, settings.height, settings.tile_size}),
+            [sched, partitions, viewport, settings, target, precision, pass, &stats, stop_token](TileQueue &queue) {
+                const ProgressivePass progressive{viewport, settings, target, precision, pass};
+                return MakeFanOutSender(
+                    sched, partitions,
+                    [progressive, &queue, &stats](std::uint32_t worker, auto should_stop) {
+                        const auto busy = stats.TrackBusy(worker);
+                        return progressive.RenderTiles(queue, should_stop, stats.TileRecorder(worker));
+                    },
+                    stop_token);
+            });
+    }
+
 public:
+    // num_threads — размер пула; 0 заменяется на одного потока
     explicit MandelbrotRenderer(std::uint32_t num_threads = std::thread::hardware_concurrency())
-        : thread_pool_{num_threads} {}
+        : num_threads_{std::max<std::uint32_t>(num_threads, 1)}, thread_pool_{num_threads_} {}
 
-    template <size_t N>
-    [[nodiscard]] auto RenderAsync(mandelbrot::ViewPort viewport, RenderSettings settings) {
-        auto sched = thread_pool_.get_scheduler();
+    [[nodiscard]] std::uint32_t ThreadCount() const noexcept { return num_threads_; }
+
+    // Планировщик пула для работы, которая делит потоки с рендерингом кадров (например, экспорт пирамиды)
+    [[nodiscard]] auto GetScheduler() noexcept { return thread_pool_.get_scheduler(); }
+
+    // Кэш плиток: ограничение памяти, диск и счётчики попаданий
+    [[nodiscard]] TileCache &Cache() noexcept { return tile_cache_; }
+    [[nodiscard]] const TileCache &Cache() const noexcept { return tile_cache_; }
 
-        if constexpr (N == 0) {
-            // Если N=0, нет работы для выполнения, возвращаем сендер с пустым результатом.
-            return stdexec::just(RenderResult{});
-        } else {
+    // Мгновенное превью вида из последнего готового кадра (см. ResamplePreviousFrame), пока кадр
+    // считается в RenderAsync. std::nullopt, если кадров ещё не было или виды не пересекаются.
+    [[nodiscard]] std::optional<RenderResult> Preview(mandelbrot::ViewPort viewport, RenderSettings settings) const {
+        if (mandelbrot::SelectPrecision(viewport, settings.width, settings.height) == mandelbrot::Precision::DOUBLE) {
+            viewport = mandelbrot::Flattened(viewport);
+        }
 
-            // Разделение экрана на N полос.
-            std::array<PixelRegion, N> regions;
+        RenderResult preview{.pixel_data = PixelMatrix(settings.width, settings.height),
+                             .color_data = ColorMatrix{},
+                             .viewport = viewport,
+                             .settings = settings,
+                             .render_time = std::chrono::milliseconds{0}};
 
-            const std::uint32_t strip_height = settings.height / N;
-            const std::uint32_t remainder = settings.height % N;
-            std::uint32_t current_row = 0;
+        {
+            const std::lock_guard lock{last_frame_mutex_};
+            if (!last_frame_ ||
+                !ResamplePreviousFrame(*last_frame_, viewport, settings, RenderTarget{preview.pixel_data.View(), {}})) {
+                return std::nullopt;
+            }
+        }
+        // Превью раскрашивается по своим настройкам, а не копирует цвета прошлого кадра
+        if (settings.colorize) {
+            ColorizeFrame(preview);
+        }
+        return preview;
+    }
 
-            for (size_t i = 0; i < N; ++i) {
-                std::uint32_t height = strip_height + (i < remainder ? 1 : 0);
-                regions[i] = {current_row, current_row + height, 0, settings.width};
-                current_row += height;
+    // Последний готовый кадр в раскраске coloring: итерации берутся из памяти, пересчитываются только цвета,
+    // поэтому кадр перекрашивается без сглаживания. std::nullopt, если кадров ещё не было.
+    [[nodiscard]] std::optional<RenderResult> RecolorLastFrame(const ColorSettings &coloring) const {
+        RenderResult frame;
+        {
+            const std::lock_guard lock{last_frame_mutex_};
+            if (!last_frame_) {
+                return std::nullopt;
             }
+            frame = RenderResult{.pixel_data = last_frame_->pixel_data,
+                                 .color_data = ColorMatrix{},
+                                 .viewport = last_frame_->viewport,
+                                 .settings = last_frame_->settings,
+                                 .render_time = last_frame_->render_time,
+                                 .stats = last_frame_->stats};
+        }
+        Recolor(frame, coloring);
+        return frame;
+    }
+
+    // Отменяет кадр, который считается сейчас: его сендер завершится set_stopped
+    void CancelFrame() {
+        const std::lock_guard lock{frame_stop_mutex_};
+        if (frame_stop_) {
+            frame_stop_->request_stop();
+        }
+    }
+
+    // Рендеринг кадра partitions рабочими задачами пула; 0 — по числу потоков пула (см. ThreadCount).
+    // Кадр, запущенный до завершения этого (или CancelFrame), отменяет его: сендер завершается set_stopped,
+    // непосчитанные плитки пропускаются. Кадр FrameKind::INDEPENDENT не отменяется.
+    // Без settings.colorize кадр содержит только итерации.
+    [[nodiscard]] auto RenderAsync(mandelbrot::ViewPort viewport, RenderSettings settings,
+                                   std::uint32_t partitions = 0, FrameKind kind = FrameKind::INTERACTIVE) {
+        const bool interactive = kind == FrameKind::INTERACTIVE;
+        auto sched = thread_pool_.get_scheduler();
+        partitions = Partitions(partitions);
 
-            // Планирование (schedule) и объединение сендеров.
-            auto create_when_all = [&]<size_t... I>(std::index_sequence<I...>) {
-                return stdexec::when_all((stdexec::on(sched, MakeMandelbrotSender(viewport, settings, regions[I])))...);
-            };
-
-            auto all_senders = create_when_all(std::make_index_sequence<N>{});
-
-            // После завершения всех задач в `when_all`, объединяем их результаты в `then`.
-            return all_senders | stdexec::then([regions, viewport, settings](auto &&...results) {
-                       PixelMatrix full_pixel_data(settings.height, std::vector<std::uint32_t>(settings.width));
-                       ColorMatrix full_color_data(settings.height, std::vector<mandelbrot::RgbColor>(settings.width));
-
-                       size_t i = 0;
-                       // Лямбда для слияния результата из одного региона в итоговое изображение.
-                       auto merge_one_result = [&](auto &&result) {
-                           const auto &region = regions[i];
-                           for (size_t y = 0; y < result.pixel_data.size(); ++y) {
-                               const auto dest_y = region.start_row + y;
-                               if (dest_y < settings.height) {
-
-                                   std::ranges::copy(result.pixel_data[y], full_pixel_data[dest_y].begin());
-                                   std::ranges::copy(result.color_data[y], full_color_data[dest_y].begin());
-                               }
+        // Глубокое приближение считается методом возмущений, промежуточное — в double-double
+        // относительно viewport.origin, остальные виды — в double с границами в абсолютных координатах
+        const auto precision = mandelbrot::SelectPrecision(viewport, settings.width, settings.height);
+        if (precision == mandelbrot::Precision::DOUBLE) {
+            viewport = mandelbrot::Flattened(viewport);
+        }
+
+        // Кадр выделяется один раз и делится на плитки settings.tile_size x settings.tile_size.
+        // partitions рабочих задач разбирают плитки из общей очереди: задача, закончившая быструю плитку,
+        // сразу берёт следующую, поэтому тяжёлые области не задерживают остальные потоки.
+        // Задачи считают только итерации; цвета заполняет следующий этап (см. ColorizeAsync).
+        RenderResult frame = AllocateFrame(viewport, settings);
+        const auto placement = interactive && precision == mandelbrot::Precision::DOUBLE
+                                   ? PlaceOnTileGrid(viewport, settings)
+                                   : std::nullopt;
+
+        return stdexec::let_value(
+            stdexec::just(std::move(frame), std::optional<TileQueue>{}, RenderStatsCollector{partitions}),
+            [this, sched, partitions, viewport, settings, precision, placement,
+             interactive](RenderResult &result, std::optional<TileQueue> &queue, RenderStatsCollector &stats) {
+                const RenderTarget target{result.pixel_data.View(), {}};
+                const auto started = std::chrono::steady_clock::now();
+                // Кадр вытесняет предыдущий, переносит пиксели и берёт плитки из кэша в момент запуска,
+                // а не создания сендера: к этому времени прошлый кадр и кэш могли измениться
+                auto frame_stop =
+                    interactive ? BeginFrame() : std::make_shared<stdexec::inplace_stop_source>();
+                const auto stop_token = frame_stop->get_token();
+
+                // При сдвиге вида готовые пиксели переносятся из прошлого кадра, считаются только открывшиеся
+                // полосы
+                auto reused_regions = interactive ? ReuseLastFrame(viewport, settings, target) : std::nullopt;
+                std::vector<PixelRegion> regions{
+                    PixelRegion{.start_row = 0, .end_row = settings.height, .start_col = 0, .end_col = settings.width}};
+                if (reused_regions) {
+                    regions = std::move(*reused_regions);
+                }
+
+                // Оставшиеся области дополняются плитками из кэша; считаются только непокрытые кэшем части
+                if (placement) {
+                    auto uncached = regions;
+                    if (tile_cache_.Fill(*placement, settings, result.pixel_data.View(), uncached) > 0) {
+                        regions = std::move(uncached);
+                    }
+                }
+                queue.emplace(regions, settings.tile_size);
+                std::uint64_t reused_pixels = std::uint64_t{settings.width} * settings.height;
+                for (const auto &region : regions) {
+                    reused_pixels -= std::uint64_t{region.width()} * region.height();
+                }
+
+                // В режиме MARIANI_SILVER прямоугольники сами распределяются по всему пулу задачами,
+                // поэтому partitions на него не влияет; делятся только оставшиеся после переноса и кэша
+                // области. Метод возмущений не зависит от settings.mode, а в double-double плитки всегда
+                // считаются целиком: подразбиение работает в double.
+                auto brute_force = [&] {
+                    return MakeFanOutSender(
+                        sched, partitions,
+                        [viewport, settings, target, precision, &queue, &stats](std::uint32_t worker,
+                                                                                 auto should_stop) {
+                            const auto busy = stats.TrackBusy(worker);
+                            return RenderTiles(viewport, settings, *queue, target, precision, should_stop,
+                                               stats.TileRecorder(worker));
+                        },
+                        stop_token);
+                };
+                auto subdivision = [&] {
+                    return MakeMarianiSilverSender(sched, viewport, settings, target, regions, stop_token);
+                };
+                auto perturbation = [&] {
+                    return MakePerturbationSender(sched, viewport, settings, target, partitions, regions, stop_token);
+                };
+                using Work =
+                    exec::variant_sender<decltype(brute_force()), decltype(subdivision()), decltype(perturbation())>;
+
+                auto select_work = [&]() -> Work {
+                    if (precision == mandelbrot::Precision::PERTURBATION) {
+                        return perturbation();
+                    }
+                    if (precision == mandelbrot::Precision::DOUBLE && settings.mode == RenderMode::MARIANI_SILVER) {
+                        return subdivision();
+                    }
+                    return brute_force();
+                };
+                Work work = select_work();
+
+                // После итераций кадр раскрашивается, сглаживается, получает статистику, запоминается для
+                // следующих видов и отдаётся дальше. Отменённый кадр завершается set_stopped и не запоминается.
+                return std::move(work) | stdexec::let_value([sched, partitions, stop_token, &result, &stats] {
+                           return ColorizeAsync(sched, partitions, result, stats, stop_token);
+                       }) |
+                       stdexec::let_value([sched, partitions, precision, stop_token, &result, &stats] {
+                           return SupersampleAsync(sched, partitions, result, precision, stats, stop_token);
+                       }) |
+                       stdexec::then([this, &result, &stats, started, reused_pixels, placement, interactive,
+                                      frame_stop = std::move(frame_stop)]() {
+                           FinishStats(result, stats, started, reused_pixels);
+                           if (interactive) {
+                               RememberFrame(result, placement);
                            }
-                           i++;
-                       };
+                           return std::move(result);
+                       });
+            });
+    }
 
-                       // Вызываем `merge_one_result` для каждого из N результатов.
-                       (merge_one_result(std::forward<decltype(results)>(results)), ...);
+    // Прогрессивный рендеринг: проходы с шагом сетки из PROGRESSIVE_PASS_STEPS (1/16, 1/4 и все пиксели).
+    // После каждого прохода on_pass(const RenderResult &) получает промежуточный кадр в потоке пула,
+    // завершившем проход; в это время кадр никто не изменяет. Сендер завершается полным кадром.
+    // Метод возмущений, сдвиг вида с переносом готовых пикселей и кадр с плитками в кэше выполняются одним
+    // проходом через RenderAsync.
+    // partitions — как в RenderAsync.
+    template <typename OnPass>
+    [[nodiscard]] auto RenderProgressiveAsync(mandelbrot::ViewPort viewport, RenderSettings settings, OnPass on_pass,
+                                              std::uint32_t partitions = 0) {
+        auto sched = thread_pool_.get_scheduler();
+        partitions = Partitions(partitions);
+        const auto precision = mandelbrot::SelectPrecision(viewport, settings.width, settings.height);
 
-                       return RenderResult{.pixel_data = std::move(full_pixel_data),
-                                           .color_data = std::move(full_color_data),
-                                           .viewport = viewport,
-                                           .settings = settings,
-                                           .render_time = std::chrono::milliseconds{0}};
+        auto single_pass = [&] {
+            return RenderAsync(viewport, settings, partitions) | stdexec::then([on_pass](RenderResult result) {
+                       on_pass(std::as_const(result));
+                       return result;
                    });
-        }
+        };
+
+        auto passes = [&] {
+            const auto pass_viewport =
+                precision == mandelbrot::Precision::DOUBLE ? mandelbrot::Flattened(viewport) : viewport;
+            RenderResult frame = AllocateFrame(pass_viewport, settings);
+
+            return stdexec::let_value(
+                stdexec::just(std::move(frame), RenderStatsCollector{partitions}),
+                [this, sched, partitions, pass_viewport, settings, precision, on_pass](RenderResult &result,
+                                                                                      RenderStatsCollector &stats) {
+                    const auto placement = precision == mandelbrot::Precision::DOUBLE
+                                               ? PlaceOnTileGrid(pass_viewport, settings)
+                                               : std::nullopt;
+                    const RenderTarget target{result.pixel_data.View(), {}};
+                    const auto started = std::chrono::steady_clock::now();
+                    auto frame_stop = BeginFrame();
+                    const auto stop_token = frame_stop->get_token();
+                    // Каждый проход считает итерации и раскрашивает кадр целиком: раскраска на порядки дешевле.
+                    // Сглаживается только последний проход: в грубых проходах границами выглядят края блоков.
+                    // Промежуточный кадр несёт время с начала рендеринга, последний — полную статистику.
+                    auto run_pass = [=, &result, &stats](std::uint32_t pass) {
+                        const std::uint32_t supersample_partitions =
+                            pass + 1 == PROGRESSIVE_PASS_STEPS.size() ? partitions : 0;
+                        return RenderPassAsync(sched, partitions, pass_viewport, settings, target, precision, pass,
+                                               stats, stop_token) |
+                               stdexec::let_value([sched, partitions, stop_token, &result, &stats] {
+                                   return ColorizeAsync(sched, partitions, result, stats, stop_token);
+                               }) |
+                               stdexec::let_value([sched, supersample_partitions, precision, stop_token, &result,
+                                                   &stats] {
+                                   return SupersampleAsync(sched, supersample_partitions, result, precision, stats,
+                                                           stop_token);
+                               }) |
+                               stdexec::then([on_pass, started, pass, &result, &stats] {
+                                   if (pass + 1 == PROGRESSIVE_PASS_STEPS.size()) {
+                                       FinishStats(result, stats, started, 0);
+                                   } else {
+                                       result.render_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                           std::chrono::steady_clock::now() - started);
+                                   }
+                                   on_pass(std::as_const(result));
+                               });
+                    };
+                    static_assert(PROGRESSIVE_PASS_STEPS.size() == 3);
+
+                    // Отменённый кадр прерывается на текущем проходе; следующие проходы не запускаются
+                    return run_pass(0) | stdexec::let_value([run_pass] { return run_pass(1); }) |
+                           stdexec::let_value([run_pass] { return run_pass(2); }) |
+                           stdexec::then([this, &result, placement, frame_stop = std::move(frame_stop)]() {
+                               RememberFrame(result, placement);
+                               return std::move(result);
+                           });
+                });
+        };
+
+        using Work = exec::variant_sender<decltype(single_pass()), decltype(passes())>;
+        auto select_work = [&]() -> Work {
+            if (precision == mandelbrot::Precision::PERTURBATION || CanReuseLastFrame(viewport, settings) ||
+                HasCachedTiles(viewport, settings, precision)) {
+                return single_pass();
+            }
+            return passes();
+        };
+        return select_work();
     }
 };
@@ -1,9 +1,107 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <span>
 #include <stdexec/execution.hpp>
 
+#include "mandelbrot_simd.hpp"
+#include "palette.hpp"
+#include "render_stats.hpp"
+#include "render_stop.hpp"
+#include "tile_queue.hpp"
 #include "types.hpp"
 
+// Вычисляет область region кадра и записывает результат напрямую в target.
+// Начало представлений target соответствует левому верхнему углу области.
+// Строка обрабатывается порциями векторным ядром (см. mandelbrot_simd.hpp).
+// При Precision::DOUBLE_DOUBLE координаты точек отсчитываются от viewport.origin в double-double.
+// На неглубоких видах (см. UseFloatKernel) точки считаются ядром float с пересчётом сомнительных в double.
+// Без target.colors записываются только итерации. Палитра берётся из CachedPalette и может бросить bad_alloc.
+inline void RenderRegion(const mandelbrot::ViewPort &viewport, const RenderSettings &settings,
+                         const PixelRegion &region, const RenderTarget &target,
+                         mandelbrot::Precision precision = mandelbrot::Precision::DOUBLE) {
+    constexpr std::uint32_t CHUNK_SIZE = 256;
+    std::array<mandelbrot::Complex, CHUNK_SIZE> points;
+    std::array<mandelbrot::DoubleDoubleComplex, CHUNK_SIZE> precise_points;
+    const bool float_kernel = precision == mandelbrot::Precision::DOUBLE && UseFloatKernel(viewport, settings);
+
+    for (std::uint32_t y = region.start_row; y < region.end_row; ++y) {
+        const auto pixel_row = target.pixels[y - region.start_row];
+
+        for (std::uint32_t chunk_start = region.start_col; chunk_start < region.end_col; chunk_start += CHUNK_SIZE) {
+            const std::uint32_t count = std::min(CHUNK_SIZE, region.end_col - chunk_start);
+            const auto iterations = pixel_row.subspan(chunk_start - region.start_col, count);
+
+            if (precision == mandelbrot::Precision::DOUBLE_DOUBLE) {
+                for (std::uint32_t i = 0; i < count; ++i) {
+                    precise_points[i] = mandelbrot::Pixel2DToDoubleDouble(chunk_start + i, y, viewport, settings.width,
+                                                                          settings.height);
+                }
+                mandelbrot::simd::CalculateIterations(std::span{precise_points}.first(count), iterations,
+                                                      settings.max_iterations, settings.escape_radius);
+                continue;
+            }
+
+            for (std::uint32_t i = 0; i < count; ++i) {
+                points[i] = mandelbrot::Pixel2DToComplex(chunk_start + i, y, viewport, settings.width, settings.height);
+            }
+
+            if (float_kernel) {
+                mandelbrot::simd::CalculateIterationsFloat(std::span{points}.first(count), iterations,
+                                                           settings.max_iterations, settings.escape_radius,
+                                                           settings.interior_checks);
+            } else {
+                mandelbrot::simd::CalculateIterations(std::span{points}.first(count), iterations,
+                                                      settings.max_iterations, settings.escape_radius,
+                                                      settings.interior_checks);
+            }
+        }
+
+        if (target.HasColors()) {
+            mandelbrot::CachedPalette(settings).Colorize(pixel_row, target.colors[y - region.start_row]);
+        }
+    }
+}
+
+// RenderRegion по строкам: перед каждой строкой вызывается should_stop(). Возвращает false, если
+// вычисление прервано; уже посчитанные строки остаются в target.
+template <typename ShouldStop>
+bool RenderRegionRows(const mandelbrot::ViewPort &viewport, const RenderSettings &settings, const PixelRegion &region,
+                      const RenderTarget &target, ShouldStop should_stop) {
+    for (std::uint32_t y = 0; y < region.height(); ++y) {
+        if (should_stop()) {
+            return false;
+        }
+        const PixelRegion row{.start_row = region.start_row + y,
+                              .end_row = region.start_row + y + 1,
+                              .start_col = region.start_col,
+                              .end_col = region.end_col};
+        const PixelRegion local{.start_row = y, .end_row = y + 1, .start_col = 0, .end_col = region.width()};
+        RenderRegion(viewport, settings, row, target.SubView(local));
+    }
+    return true;
+}
+
+// Рабочий цикл: забирает плитки из общей очереди, пока они не закончатся, и пишет каждую в общий буфер
+// кадра target. Перед каждой плиткой вызывается should_stop(); возвращает false, если цикл прерван.
+// После каждой плитки on_tile(tile, время) получает время её вычисления (см. RenderStatsCollector).
+template <typename ShouldStop, typename OnTile = IgnoreTileTime>
+bool RenderTiles(const mandelbrot::ViewPort &viewport, const RenderSettings &settings, TileQueue &tiles,
+                 const RenderTarget &target, mandelbrot::Precision precision, ShouldStop should_stop,
+                 OnTile on_tile = {}) {
+    while (const auto tile = tiles.Next()) {
+        if (should_stop()) {
+            return false;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        RenderRegion(viewport, settings, *tile, target.SubView(*tile), precision);
+        on_tile(*tile, std::chrono::steady_clock::now() - start);
+    }
+    return true;
+}
+
 template <typename Receiver>
 struct MandelbrotOperationState {
     Receiver receiver_;
@@ -17,35 +115,31 @@ struct MandelbrotOperationState {
 
     void start() noexcept {
         try {
-            // Вычисляем множество Мандельброта для заданной области
-            PixelMatrix pixel_data(region_.end_row - region_.start_row,
-                                   std::vector<std::uint32_t>(region_.end_col - region_.start_col));
-            ColorMatrix color_data(region_.end_row - region_.start_row,
-                                   std::vector<mandelbrot::RgbColor>(region_.end_col - region_.start_col));
-
-            for (std::uint32_t y = region_.start_row; y < region_.end_row; ++y) {
-                for (std::uint32_t x = region_.start_col; x < region_.end_col; ++x) {
-                    const auto complex_point =
-                        mandelbrot::Pixel2DToComplex(x, y, viewport_, settings_.width, settings_.height);
-                    const auto iterations = mandelbrot::CalculateIterationsForPoint(
-                        complex_point, settings_.max_iterations, settings_.escape_radius);
-                    const auto color = mandelbrot::IterationsToColor(iterations, settings_.max_iterations);
-
-                    const auto local_y = y - region_.start_row;
-                    const auto local_x = x - region_.start_col;
-                    pixel_data[local_y][local_x] = iterations;
-                    color_data[local_y][local_x] = color;
-                }
+            const auto started = std::chrono::steady_clock::now();
+            // Вычисляем множество Мандельброта для заданной области в собственный буфер;
+            // без settings.colorize буфер цветов не выделяется
+            PixelMatrix pixel_data(region_.width(), region_.height());
+            ColorMatrix color_data;
+            RenderTarget target{pixel_data.View(), {}};
+            if (settings_.colorize) {
+                color_data = ColorMatrix(region_.width(), region_.height());
+                target.colors = color_data.View();
+            }
+
+            // Токен получателя проверяется перед каждой строкой: отменённая операция завершается set_stopped
+            if (!RenderRegionRows(viewport_, settings_, region_, target, [this] { return StopRequested(receiver_); })) {
+                stdexec::set_stopped(std::move(receiver_));
+                return;
             }
 
-            // Создаем результат рендеринга
-            RenderResult result{
-                .pixel_data = std::move(pixel_data),
-                .color_data = std::move(color_data),
-                .viewport = viewport_,
-                .settings = settings_,
-                .render_time = std::chrono::milliseconds{0}  // Время рендеринга можно добавить позже
-            };
+            // Создаем результат рендеринга; область считается одной задачей без плиток
+            RenderResult result{.pixel_data = std::move(pixel_data),
+                                .color_data = std::move(color_data),
+                                .viewport = viewport_,
+                                .settings = settings_,
+                                .render_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                    std::chrono::steady_clock::now() - started)};
+            CountPixels(result.stats, result.pixel_data, settings_.max_iterations);
 
             // Отправляем результат получателю
             stdexec::set_value(std::move(receiver_), std::move(result));
@@ -100,7 +194,7 @@ struct MandelbrotSender<void> {
 
 [[nodiscard]] inline auto MakeMandelbrotSender(mandelbrot::ViewPort viewport, RenderSettings settings,
                                                PixelRegion region) {
-    return MandelbrotSender<void>{viewport, settings, region};
+    return MandelbrotSender<void>{mandelbrot::Flattened(viewport), settings, region};
 }
 
 // Включаем поддержку sender для MandelbrotSender
@@ -0,0 +1,475 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+#include "double_double.hpp"
+#include "mandelbrot_fractal_utils.hpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define MANDELBROT_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace mandelbrot::simd {
+
+// Набор инструкций, которым вычисляется ядро итераций
+enum class Isa { SCALAR, SSE2, AVX2, AVX512 };
+
+[[nodiscard]] constexpr const char *IsaName(Isa isa) noexcept {
+    switch (isa) {
+    case Isa::SSE2:
+        return "SSE2";
+    case Isa::AVX2:
+        return "AVX2";
+    case Isa::AVX512:
+        return "AVX-512";
+    default:
+        return "Scalar";
+    }
+}
+
+// Лучший набор инструкций, поддерживаемый процессором (определяется через CPUID)
+[[nodiscard]] inline Isa DetectIsa() noexcept {
+#ifdef MANDELBROT_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return Isa::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return Isa::AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return Isa::SSE2;
+    }
+#endif
+    return Isa::SCALAR;
+}
+
+// Результат DetectIsa, вычисленный один раз при первом обращении
+[[nodiscard]] inline Isa ActiveIsa() noexcept {
+    static const Isa active_isa = DetectIsa();
+    return active_isa;
+}
+
+[[nodiscard]] inline bool IsSupported(Isa isa) noexcept { return isa <= ActiveIsa(); }
+
+// Эталонная скалярная реализация, она же запасной вариант для процессоров без SIMD
+inline void CalculateIterationsScalar(std::span<const Complex> points, std::span<std::uint32_t> iterations,
+                                      std::uint32_t max_iterations, double escape_radius,
+                                      const InteriorChecks &checks = {}) noexcept {
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        iterations[i] = CalculateIterationsForPoint(points[i], max_iterations, escape_radius, checks);
+    }
+}
+
+// Эталонная скалярная реализация ядра double-double
+inline void CalculateIterationsScalar(std::span<const DoubleDoubleComplex> points, std::span<std::uint32_t> iterations,
+                                      std::uint32_t max_iterations, double escape_radius) noexcept {
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        iterations[i] = CalculateIterationsForPoint(points[i], max_iterations, escape_radius);
+    }
+}
+
+// Эталонная скалярная реализация float-ядра: сомнительные точки остаются FLOAT_FALLBACK
+inline void CalculateIterationsFloatScalar(std::span<const Complex> points, std::span<std::uint32_t> iterations,
+                                           std::uint32_t max_iterations, double escape_radius,
+                                           const InteriorChecks &checks = {}) noexcept {
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        iterations[i] = CalculateIterationsForPointFloat(points[i], max_iterations, escape_radius, checks);
+    }
+}
+
+#ifdef MANDELBROT_SIMD_X86
+// Код между BEGIN и END компилируется под указанный набор инструкций
+#define MANDELBROT_SIMD_PRAGMA(x) _Pragma(#x)
+#if defined(__clang__)
+#define MANDELBROT_SIMD_TARGET_BEGIN(isa)                                                                             \
+    MANDELBROT_SIMD_PRAGMA(clang attribute push(__attribute__((target(isa))), apply_to = function))
+#define MANDELBROT_SIMD_TARGET_END _Pragma("clang attribute pop")
+#else
+#define MANDELBROT_SIMD_TARGET_BEGIN(isa) _Pragma("GCC push_options") MANDELBROT_SIMD_PRAGMA(GCC target(isa))
+#define MANDELBROT_SIMD_TARGET_END _Pragma("GCC pop_options")
+#endif
+
+namespace detail {
+
+// Обёртки над интринсиками для каждого набора инструкций: Ops для double, FloatOps для float-ядра.
+// Сравнения возвращают маску дорожек (Mask), ToBits переводит её в битовую маску.
+// Ядро из mandelbrot_simd_lanes.hpp пишется один раз и компилируется заново в пространстве имён
+// каждого набора инструкций.
+MANDELBROT_SIMD_TARGET_BEGIN("sse2")
+namespace sse2 {
+
+struct Ops {
+    using Vec = __m128d;
+    using Mask = __m128d;
+    static constexpr std::size_t LANES = 2;
+
+    static Vec Set1(double v) noexcept { return _mm_set1_pd(v); }
+    static Vec Load(const double *p) noexcept { return _mm_load_pd(p); }
+    static void Store(double *p, Vec v) noexcept { _mm_store_pd(p, v); }
+    static Vec Add(Vec a, Vec b) noexcept { return _mm_add_pd(a, b); }
+    static Vec Sub(Vec a, Vec b) noexcept { return _mm_sub_pd(a, b); }
+    static Vec Mul(Vec a, Vec b) noexcept { return _mm_mul_pd(a, b); }
+    static Vec Abs(Vec a) noexcept { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+    static Mask Greater(Vec a, Vec b) noexcept { return _mm_cmpgt_pd(a, b); }
+    static Mask GreaterEqual(Vec a, Vec b) noexcept { return _mm_cmpge_pd(a, b); }
+    static Mask LessEqual(Vec a, Vec b) noexcept { return _mm_cmple_pd(a, b); }
+    static Mask Equal(Vec a, Vec b) noexcept { return _mm_cmpeq_pd(a, b); }
+    static Mask And(Mask a, Mask b) noexcept { return _mm_and_pd(a, b); }
+    static Mask Or(Mask a, Mask b) noexcept { return _mm_or_pd(a, b); }
+    static Vec Select(Mask m, Vec if_true, Vec if_false) noexcept {
+        return _mm_or_pd(_mm_and_pd(m, if_true), _mm_andnot_pd(m, if_false));
+    }
+    static unsigned ToBits(Mask m) noexcept { return static_cast<unsigned>(_mm_movemask_pd(m)); }
+};
+
+struct FloatOps {
+    using Vec = __m128;
+    using Mask = __m128;
+    static constexpr std::size_t LANES = 4;
+
+    static Vec Set1(float v) noexcept { return _mm_set1_ps(v); }
+    static Vec Load(const float *p) noexcept { return _mm_load_ps(p); }
+    static void Store(float *p, Vec v) noexcept { _mm_store_ps(p, v); }
+    static Vec Add(Vec a, Vec b) noexcept { return _mm_add_ps(a, b); }
+    static Vec Sub(Vec a, Vec b) noexcept { return _mm_sub_ps(a, b); }
+    static Vec Mul(Vec a, Vec b) noexcept { return _mm_mul_ps(a, b); }
+    static Vec Abs(Vec a) noexcept { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static Mask Greater(Vec a, Vec b) noexcept { return _mm_cmpgt_ps(a, b); }
+    static Mask GreaterEqual(Vec a, Vec b) noexcept { return _mm_cmpge_ps(a, b); }
+    static Mask LessEqual(Vec a, Vec b) noexcept { return _mm_cmple_ps(a, b); }
+    static Mask Equal(Vec a, Vec b) noexcept { return _mm_cmpeq_ps(a, b); }
+    static Mask And(Mask a, Mask b) noexcept { return _mm_and_ps(a, b); }
+    static Mask Or(Mask a, Mask b) noexcept { return _mm_or_ps(a, b); }
+    static Vec Select(Mask m, Vec if_true, Vec if_false) noexcept {
+        return _mm_or_ps(_mm_and_ps(m, if_true), _mm_andnot_ps(m, if_false));
+    }
+    static unsigned ToBits(Mask m) noexcept { return static_cast<unsigned>(_mm_movemask_ps(m)); }
+};
+
+#include "mandelbrot_simd_lanes.hpp"
+
+}  // namespace sse2
+MANDELBROT_SIMD_TARGET_END
+
+MANDELBROT_SIMD_TARGET_BEGIN("avx2")
+namespace avx2 {
+
+struct Ops {
+    using Vec = __m256d;
+    using Mask = __m256d;
+    static constexpr std::size_t LANES = 4;
+
+    static Vec Set1(double v) noexcept { return _mm256_set1_pd(v); }
+    static Vec Load(const double *p) noexcept { return _mm256_load_pd(p); }
+    static void Store(double *p, Vec v) noexcept { _mm256_store_pd(p, v); }
+    static Vec Add(Vec a, Vec b) noexcept { return _mm256_add_pd(a, b); }
+    static Vec Sub(Vec a, Vec b) noexcept { return _mm256_sub_pd(a, b); }
+    static Vec Mul(Vec a, Vec b) noexcept { return _mm256_mul_pd(a, b); }
+    static Vec Abs(Vec a) noexcept { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+    static Mask Greater(Vec a, Vec b) noexcept { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+    static Mask GreaterEqual(Vec a, Vec b) noexcept { return _mm256_cmp_pd(a, b, _CMP_GE_OQ); }
+    static Mask LessEqual(Vec a, Vec b) noexcept { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+    static Mask Equal(Vec a, Vec b) noexcept { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+    static Mask And(Mask a, Mask b) noexcept { return _mm256_and_pd(a, b); }
+    static Mask Or(Mask a, Mask b) noexcept { return _mm256_or_pd(a, b); }
+    static Vec Select(Mask m, Vec if_true, Vec if_false) noexcept { return _mm256_blendv_pd(if_false, if_true, m); }
+    static unsigned ToBits(Mask m) noexcept { return static_cast<unsigned>(_mm256_movemask_pd(m)); }
+};
+
+struct FloatOps {
+    using Vec = __m256;
+    using Mask = __m256;
+    static constexpr std::size_t LANES = 8;
+
+    static Vec Set1(float v) noexcept { return _mm256_set1_ps(v); }
+    static Vec Load(const float *p) noexcept { return _mm256_load_ps(p); }
+    static void Store(float *p, Vec v) noexcept { _mm256_store_ps(p, v); }
+    static Vec Add(Vec a, Vec b) noexcept { return _mm256_add_ps(a, b); }
+    static Vec Sub(Vec a, Vec b) noexcept { return _mm256_sub_ps(a, b); }
+    static Vec Mul(Vec a, Vec b) noexcept { return _mm256_mul_ps(a, b); }
+    static Vec Abs(Vec a) noexcept { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static Mask Greater(Vec a, Vec b) noexcept { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static Mask GreaterEqual(Vec a, Vec b) noexcept { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    static Mask LessEqual(Vec a, Vec b) noexcept { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static Mask Equal(Vec a, Vec b) noexcept { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    static Mask And(Mask a, Mask b) noexcept { return _mm256_and_ps(a, b); }
+    static Mask Or(Mask a, Mask b) noexcept { return _mm256_or_ps(a, b); }
+    static Vec Select(Mask m, Vec if_true, Vec if_false) noexcept { return _mm256_blendv_ps(if_false, if_true, m); }
+    static unsigned ToBits(Mask m) noexcept { return static_cast<unsigned>(_mm256_movemask_ps(m)); }
+};
+
+#include "mandelbrot_simd_lanes.hpp"
+
+// Раскраска по таблице палитры: 8 цветов за одну выборку gather
+inline void Colorize(std::span<const std::uint32_t> iterations, const RgbColor *palette, std::uint32_t max_index,
+                     RgbColor *colors) noexcept {
+    const __m256i limit = _mm256_set1_epi32(static_cast<int>(max_index));
+    const auto *table = reinterpret_cast<const int *>(palette);
+    std::size_t i = 0;
+    for (; i + 8 <= iterations.size(); i += 8) {
+        const __m256i index =
+            _mm256_min_epu32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(iterations.data() + i)), limit);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(colors + i), _mm256_i32gather_epi32(table, index, 4));
+    }
+    for (; i < iterations.size(); ++i) {
+        colors[i] = palette[std::min(iterations[i], max_index)];
+    }
+}
+
+}  // namespace avx2
+MANDELBROT_SIMD_TARGET_END
+
+MANDELBROT_SIMD_TARGET_BEGIN("avx512f")
+namespace avx512 {
+
+struct Ops {
+    using Vec = __m512d;
+    using Mask = __mmask8;
+    static constexpr std::size_t LANES = 8;
+
+    static Vec Set1(double v) noexcept { return _mm512_set1_pd(v); }
+    static Vec Load(const double *p) noexcept { return _mm512_load_pd(p); }
+    static void Store(double *p, Vec v) noexcept { _mm512_store_pd(p, v); }
+    static Vec Add(Vec a, Vec b) noexcept { return _mm512_add_pd(a, b); }
+    static Vec Sub(Vec a, Vec b) noexcept { return _mm512_sub_pd(a, b); }
+    static Vec Mul(Vec a, Vec b) noexcept { return _mm512_mul_pd(a, b); }
+    static Vec Abs(Vec a) noexcept { return _mm512_abs_pd(a); }
+    static Mask Greater(Vec a, Vec b) noexcept { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+    static Mask GreaterEqual(Vec a, Vec b) noexcept { return _mm512_cmp_pd_mask(a, b, _CMP_GE_OQ); }
+    static Mask LessEqual(Vec a, Vec b) noexcept { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+    static Mask Equal(Vec a, Vec b) noexcept { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+    static Mask And(Mask a, Mask b) noexcept { return static_cast<Mask>(a & b); }
+    static Mask Or(Mask a, Mask b) noexcept { return static_cast<Mask>(a | b); }
+    static Vec Select(Mask m, Vec if_true, Vec if_false) noexcept { return _mm512_mask_blend_pd(m, if_false, if_true); }
+    static unsigned ToBits(Mask m) noexcept { return static_cast<unsigned>(m); }
+};
+
+struct FloatOps {
+    using Vec = __m512;
+    using Mask = __mmask16;
+    static constexpr std::size_t LANES = 16;
+
+    static Vec Set1(float v) noexcept { return _mm512_set1_ps(v); }
+    static Vec Load(const float *p) noexcept { return _mm512_load_ps(p); }
+    static void Store(float *p, Vec v) noexcept { _mm512_store_ps(p, v); }
+    static Vec Add(Vec a, Vec b) noexcept { return _mm512_add_ps(a, b); }
+    static Vec Sub(Vec a, Vec b) noexcept { return _mm512_sub_ps(a, b); }
+    static Vec Mul(Vec a, Vec b) noexcept { return _mm512_mul_ps(a, b); }
+    static Vec Abs(Vec a) noexcept { return _mm512_abs_ps(a); }
+    static Mask Greater(Vec a, Vec b) noexcept { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+    static Mask GreaterEqual(Vec a, Vec b) noexcept { return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ); }
+    static Mask LessEqual(Vec a, Vec b) noexcept { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+    static Mask Equal(Vec a, Vec b) noexcept { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+    static Mask And(Mask a, Mask b) noexcept { return static_cast<Mask>(a & b); }
+    static Mask Or(Mask a, Mask b) noexcept { return static_cast<Mask>(a | b); }
+    static Vec Select(Mask m, Vec if_true, Vec if_false) noexcept { return _mm512_mask_blend_ps(m, if_false, if_true); }
+    static unsigned ToBits(Mask m) noexcept { return static_cast<unsigned>(m); }
+};
+
+#include "mandelbrot_simd_lanes.hpp"
+
+// Раскраска по таблице палитры: 16 цветов за одну выборку gather
+inline void Colorize(std::span<const std::uint32_t> iterations, const RgbColor *palette, std::uint32_t max_index,
+                     RgbColor *colors) noexcept {
+    const __m512i limit = _mm512_set1_epi32(static_cast<int>(max_index));
+    const auto *table = reinterpret_cast<const int *>(palette);
+    std::size_t i = 0;
+    for (; i + 16 <= iterations.size(); i += 16) {
+        // Формы с маской: у _mm512_min_epu32 и _mm512_i32gather_epi32 в GCC 12 неинициализированный источник
+        // (-Wmaybe-uninitialized)
+        const __m512i index = _mm512_maskz_min_epu32(0xFFFF, _mm512_loadu_si512(iterations.data() + i), limit);
+        const __m512i rgba = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), 0xFFFF, index, table, 4);
+        _mm512_storeu_si512(colors + i, rgba);
+    }
+    for (; i < iterations.size(); ++i) {
+        colors[i] = palette[std::min(iterations[i], max_index)];
+    }
+}
+
+}  // namespace avx512
+MANDELBROT_SIMD_TARGET_END
+
+}  // namespace detail
+
+#undef MANDELBROT_SIMD_TARGET_BEGIN
+#undef MANDELBROT_SIMD_TARGET_END
+#undef MANDELBROT_SIMD_PRAGMA
+#endif
+
+// Вычисляет число итераций для каждой точки points заданным набором инструкций.
+// Если набор не поддерживается процессором, используется скалярная реализация.
+inline void CalculateIterations(std::span<const Complex> points, std::span<std::uint32_t> iterations,
+                                std::uint32_t max_iterations, double escape_radius, Isa isa,
+                                InteriorChecks checks = {}) noexcept {
+    if (!IsSupported(isa)) {
+        isa = Isa::SCALAR;
+    }
+    if (!checks.ApplicableFor(escape_radius)) {
+        checks = InteriorChecks{};
+    }
+
+    switch (isa) {
+#ifdef MANDELBROT_SIMD_X86
+    case Isa::AVX512:
+        detail::avx512::CalculateIterations(points, iterations, max_iterations, escape_radius, checks);
+        return;
+    case Isa::AVX2:
+        detail::avx2::CalculateIterations(points, iterations, max_iterations, escape_radius, checks);
+        return;
+    case Isa::SSE2:
+        detail::sse2::CalculateIterations(points, iterations, max_iterations, escape_radius, checks);
+        return;
+#endif
+    default:
+        CalculateIterationsScalar(points, iterations, max_iterations, escape_radius, checks);
+        return;
+    }
+}
+
+// То же самое с лучшим набором инструкций, доступным на этом процессоре
+inline void CalculateIterations(std::span<const Complex> points, std::span<std::uint32_t> iterations,
+                                std::uint32_t max_iterations, double escape_radius,
+                                const InteriorChecks &checks = {}) noexcept {
+    CalculateIterations(points, iterations, max_iterations, escape_radius, ActiveIsa(), checks);
+}
+
+// Первый проход float-ядра (см. CalculateIterationsForPointFloat): сомнительные точки остаются FLOAT_FALLBACK
+inline void CalculateIterationsFloatPass(std::span<const Complex> points, std::span<std::uint32_t> iterations,
+                                         std::uint32_t max_iterations, double escape_radius, Isa isa,
+                                         InteriorChecks checks = {}) noexcept {
+    if (!IsSupported(isa)) {
+        isa = Isa::SCALAR;
+    }
+    if (!checks.ApplicableFor(escape_radius)) {
+        checks = InteriorChecks{};
+    }
+
+    switch (isa) {
+#ifdef MANDELBROT_SIMD_X86
+    case Isa::AVX512:
+        detail::avx512::CalculateIterationsFloat(points, iterations, max_iterations, escape_radius, checks);
+        return;
+    case Isa::AVX2:
+        detail::avx2::CalculateIterationsFloat(points, iterations, max_iterations, escape_radius, checks);
+        return;
+    case Isa::SSE2:
+        detail::sse2::CalculateIterationsFloat(points, iterations, max_iterations, escape_radius, checks);
+        return;
+#endif
+    default:
+        CalculateIterationsFloatScalar(points, iterations, max_iterations, escape_radius, checks);
+        return;
+    }
+}
+
+// Ядро одинарной точности для неглубоких видов (см. FloatPrecisionSuffices). Точки, для которых оценка
+// ошибки float не гарантирует результат, пересчитываются ядром double, поэтому итог совпадает
+// с CalculateIterations побитово.
+inline void CalculateIterationsFloat(std::span<const Complex> points, std::span<std::uint32_t> iterations,
+                                     std::uint32_t max_iterations, double escape_radius, Isa isa,
+                                     const InteriorChecks &checks = {}) noexcept {
+    CalculateIterationsFloatPass(points, iterations, max_iterations, escape_radius, isa, checks);
+
+    // Сомнительные точки собираются порциями и считаются в double тем же набором инструкций
+    constexpr std::size_t BATCH = 64;
+    std::array<Complex, BATCH> batch_points;
+    std::array<std::uint32_t, BATCH> batch_iterations;
+    std::array<std::size_t, BATCH> batch_index;
+    std::size_t count = 0;
+    auto flush = [&] {
+        CalculateIterations(std::span{batch_points}.first(count), std::span{batch_iterations}.first(count),
+                            max_iterations, escape_radius, isa, checks);
+        for (std::size_t i = 0; i < count; ++i) {
+            iterations[batch_index[i]] = batch_iterations[i];
+        }
+        count = 0;
+    };
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        if (iterations[i] == FLOAT_FALLBACK) {
+            batch_points[count] = points[i];
+            batch_index[count] = i;
+            if (++count == BATCH) {
+                flush();
+            }
+        }
+    }
+    if (count > 0) {
+        flush();
+    }
+}
+
+inline void CalculateIterationsFloat(std::span<const Complex> points, std::span<std::uint32_t> iterations,
+                                     std::uint32_t max_iterations, double escape_radius,
+                                     const InteriorChecks &checks = {}) noexcept {
+    CalculateIterationsFloat(points, iterations, max_iterations, escape_radius, ActiveIsa(), checks);
+}
+
+// Ядро double-double для приближений глубже точности double (см. Precision::DOUBLE_DOUBLE)
+inline void CalculateIterations(std::span<const DoubleDoubleComplex> points, std::span<std::uint32_t> iterations,
+                                std::uint32_t max_iterations, double escape_radius, Isa isa) noexcept {
+    if (!IsSupported(isa)) {
+        isa = Isa::SCALAR;
+    }
+
+    switch (isa) {
+#ifdef MANDELBROT_SIMD_X86
+    case Isa::AVX512:
+        detail::avx512::CalculateIterations(points, iterations, max_iterations, escape_radius);
+        return;
+    case Isa::AVX2:
+        detail::avx2::CalculateIterations(points, iterations, max_iterations, escape_radius);
+        return;
+    case Isa::SSE2:
+        detail::sse2::CalculateIterations(points, iterations, max_iterations, escape_radius);
+        return;
+#endif
+    default:
+        CalculateIterationsScalar(points, iterations, max_iterations, escape_radius);
+        return;
+    }
+}
+
+inline void CalculateIterations(std::span<const DoubleDoubleComplex> points, std::span<std::uint32_t> iterations,
+                                std::uint32_t max_iterations, double escape_radius) noexcept {
+    CalculateIterations(points, iterations, max_iterations, escape_radius, ActiveIsa());
+}
+
+// Раскрашивает строку по таблице палитры: colors[i] = palette[min(iterations[i], palette.size() - 1)].
+// AVX2 и AVX-512 выбирают цвета из таблицы инструкциями gather; в SSE2 их нет, там работает скалярный цикл.
+inline void Colorize(std::span<const std::uint32_t> iterations, std::span<const RgbColor> palette,
+                     std::span<RgbColor> colors, Isa isa) noexcept {
+    if (!IsSupported(isa)) {
+        isa = Isa::SCALAR;
+    }
+    const auto max_index = static_cast<std::uint32_t>(palette.size() - 1);
+
+    switch (isa) {
+#ifdef MANDELBROT_SIMD_X86
+    case Isa::AVX512:
+        detail::avx512::Colorize(iterations, palette.data(), max_index, colors.data());
+        return;
+    case Isa::AVX2:
+        detail::avx2::Colorize(iterations, palette.data(), max_index, colors.data());
+        return;
+#endif
+    default:
+        for (std::size_t i = 0; i < iterations.size(); ++i) {
+            colors[i] = palette[std::min(iterations[i], max_index)];
+        }
+        return;
+    }
+}
+
+inline void Colorize(std::span<const std::uint32_t> iterations, std::span<const RgbColor> palette,
+                     std::span<RgbColor> colors) noexcept {
+    Colorize(iterations, palette, colors, ActiveIsa());
+}
+
+}  // namespace mandelbrot::simd
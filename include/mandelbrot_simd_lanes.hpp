@@ -0,0 +1,500 @@
+// Векторное ядро итераций. Файл намеренно не защищён от повторного включения:
+// mandelbrot_simd.hpp включает его по разу для каждого набора инструкций внутри
+// своего пространства имён, где уже объявлен тип Ops и включена нужная цель компиляции.
+// Так все функции, работающие с векторными типами, компилируются под один набор инструкций
+// и корректно передают векторы друг другу даже без встраивания (например, в сборке -O0).
+
+// Векторное ядро: каждая дорожка итерирует свою точку, завершившиеся дорожки сразу
+// заполняются следующими точками, чтобы векторные блоки не простаивали.
+// Арифметика и проверки InteriorChecks повторяют CalculateIterationsForPoint операция в операцию,
+// поэтому результат совпадает побитово.
+template <bool PERIODICITY>
+inline void IterateLanes(std::span<const Complex> points, std::span<std::uint32_t> iterations,
+                         std::uint32_t max_iterations, double escape_radius, const InteriorChecks &checks) noexcept {
+    using Vec = Ops::Vec;
+    constexpr std::size_t LANES = Ops::LANES;
+    constexpr std::size_t IDLE = std::numeric_limits<std::size_t>::max();
+
+    alignas(64) double zr[LANES]{};
+    alignas(64) double zi[LANES]{};
+    alignas(64) double cr[LANES]{};
+    alignas(64) double ci[LANES]{};
+    alignas(64) double iter[LANES]{};
+    alignas(64) double checkpoint_r[LANES]{};
+    alignas(64) double checkpoint_i[LANES]{};
+    alignas(64) double next_checkpoint[LANES]{};
+    std::size_t index[LANES];
+
+    std::size_t next = 0;
+    std::size_t active = 0;
+
+    // Загружает в дорожку следующую точку; свободная дорожка никогда не завершается.
+    // Точки кардиоиды и круга периода 2 записываются сразу, не занимая дорожку.
+    auto refill = [&](std::size_t lane) {
+        while (checks.cardioid_bulb && next < points.size() && IsInMainCardioidOrBulb(points[next])) {
+            iterations[next++] = max_iterations;
+        }
+
+        zr[lane] = 0.0;
+        zi[lane] = 0.0;
+        checkpoint_r[lane] = 0.0;
+        checkpoint_i[lane] = 0.0;
+        next_checkpoint[lane] = 1.0;
+        if (next < points.size()) {
+            cr[lane] = points[next].real();
+            ci[lane] = points[next].imag();
+            iter[lane] = 0.0;
+            index[lane] = next++;
+            ++active;
+        } else {
+            // NaN в контрольной точке исключает свободную дорожку из проверки периодичности
+            cr[lane] = 0.0;
+            ci[lane] = 0.0;
+            iter[lane] = -std::numeric_limits<double>::infinity();
+            checkpoint_r[lane] = std::numeric_limits<double>::quiet_NaN();
+            index[lane] = IDLE;
+        }
+    };
+
+    for (std::size_t lane = 0; lane < LANES; ++lane) {
+        refill(lane);
+    }
+
+    const Vec escape_radius_squared = Ops::Set1(escape_radius * escape_radius);
+    const Vec max_iter = Ops::Set1(static_cast<double>(max_iterations));
+    const Vec one = Ops::Set1(1.0);
+    const Vec tolerance = Ops::Set1(checks.periodicity_tolerance);
+
+    Vec vzr = Ops::Load(zr);
+    Vec vzi = Ops::Load(zi);
+    Vec vcr = Ops::Load(cr);
+    Vec vci = Ops::Load(ci);
+    Vec viter = Ops::Load(iter);
+    Vec vcheckpoint_r = Ops::Load(checkpoint_r);
+    Vec vcheckpoint_i = Ops::Load(checkpoint_i);
+    Vec vnext_checkpoint = Ops::Load(next_checkpoint);
+
+    while (active > 0) {
+        const Vec zr2 = Ops::Mul(vzr, vzr);
+        const Vec zi2 = Ops::Mul(vzi, vzi);
+
+        // Дорожка завершена, если точка убежала или исчерпан лимит итераций;
+        // в обоих случаях результат равен текущему счётчику итераций.
+        const unsigned done = Ops::ToBits(
+            Ops::Or(Ops::Greater(Ops::Add(zr2, zi2), escape_radius_squared), Ops::GreaterEqual(viter, max_iter)));
+
+        if (done != 0) {
+            Ops::Store(zr, vzr);
+            Ops::Store(zi, vzi);
+            Ops::Store(cr, vcr);
+            Ops::Store(ci, vci);
+            Ops::Store(iter, viter);
+            if constexpr (PERIODICITY) {
+                Ops::Store(checkpoint_r, vcheckpoint_r);
+                Ops::Store(checkpoint_i, vcheckpoint_i);
+                Ops::Store(next_checkpoint, vnext_checkpoint);
+            }
+
+            for (std::size_t lane = 0; lane < LANES; ++lane) {
+                if ((done >> lane) & 1u) {
+                    iterations[index[lane]] = static_cast<std::uint32_t>(iter[lane]);
+                    --active;
+                    refill(lane);
+                }
+            }
+
+            vzr = Ops::Load(zr);
+            vzi = Ops::Load(zi);
+            vcr = Ops::Load(cr);
+            vci = Ops::Load(ci);
+            viter = Ops::Load(iter);
+            if constexpr (PERIODICITY) {
+                vcheckpoint_r = Ops::Load(checkpoint_r);
+                vcheckpoint_i = Ops::Load(checkpoint_i);
+                vnext_checkpoint = Ops::Load(next_checkpoint);
+            }
+            continue;
+        }
+
+        // z = z * z + c
+        const Vec zrzi = Ops::Mul(vzr, vzi);
+        vzr = Ops::Add(Ops::Sub(zr2, zi2), vcr);
+        vzi = Ops::Add(Ops::Add(zrzi, zrzi), vci);
+        viter = Ops::Add(viter, one);
+
+        if constexpr (PERIODICITY) {
+            // Орбита вернулась к контрольной точке: дорожка завершится на следующем шаге с max_iterations
+            const auto periodic = Ops::And(Ops::LessEqual(Ops::Abs(Ops::Sub(vzr, vcheckpoint_r)), tolerance),
+                                           Ops::LessEqual(Ops::Abs(Ops::Sub(vzi, vcheckpoint_i)), tolerance));
+            viter = Ops::Select(periodic, max_iter, viter);
+
+            // На итерациях, равных степени двойки, контрольная точка переносится в текущую
+            const auto update = Ops::Equal(viter, vnext_checkpoint);
+            vcheckpoint_r = Ops::Select(update, vzr, vcheckpoint_r);
+            vcheckpoint_i = Ops::Select(update, vzi, vcheckpoint_i);
+            vnext_checkpoint = Ops::Select(update, Ops::Add(vnext_checkpoint, vnext_checkpoint), vnext_checkpoint);
+        }
+    }
+}
+
+// Ядро одинарной точности с заполнением освободившихся дорожек, как в IterateLanes, но на вдвое большем
+// числе дорожек. Арифметика повторяет CalculateIterationsForPointFloat операция в операцию, включая оценку
+// ошибки: точки, которые могут разойтись с double, получают FLOAT_FALLBACK.
+template <bool PERIODICITY>
+inline void IterateLanesFloat(std::span<const Complex> points, std::span<std::uint32_t> iterations,
+                              std::uint32_t max_iterations, double escape_radius,
+                              const InteriorChecks &checks) noexcept {
+    using Vec = FloatOps::Vec;
+    constexpr std::size_t LANES = FloatOps::LANES;
+    constexpr std::size_t IDLE = std::numeric_limits<std::size_t>::max();
+
+    alignas(64) float zr[LANES]{};
+    alignas(64) float zi[LANES]{};
+    alignas(64) float cr[LANES]{};
+    alignas(64) float ci[LANES]{};
+    alignas(64) float c_magnitude[LANES]{};
+    alignas(64) float error[LANES]{};
+    alignas(64) float iter[LANES]{};
+    alignas(64) float checkpoint_r[LANES]{};
+    alignas(64) float checkpoint_i[LANES]{};
+    alignas(64) float checkpoint_error[LANES]{};
+    alignas(64) float next_checkpoint[LANES]{};
+    std::size_t index[LANES];
+
+    std::size_t next = 0;
+    std::size_t active = 0;
+
+    auto refill = [&](std::size_t lane) {
+        while (checks.cardioid_bulb && next < points.size() && IsInMainCardioidOrBulb(points[next])) {
+            iterations[next++] = max_iterations;
+        }
+
+        zr[lane] = 0.0f;
+        zi[lane] = 0.0f;
+        error[lane] = 0.0f;
+        checkpoint_r[lane] = 0.0f;
+        checkpoint_i[lane] = 0.0f;
+        checkpoint_error[lane] = 0.0f;
+        next_checkpoint[lane] = 1.0f;
+        if (next < points.size()) {
+            cr[lane] = static_cast<float>(points[next].real());
+            ci[lane] = static_cast<float>(points[next].imag());
+            c_magnitude[lane] = std::abs(cr[lane]) + std::abs(ci[lane]);
+            iter[lane] = 0.0f;
+            index[lane] = next++;
+            ++active;
+        } else {
+            cr[lane] = 0.0f;
+            ci[lane] = 0.0f;
+            c_magnitude[lane] = 0.0f;
+            iter[lane] = -std::numeric_limits<float>::infinity();
+            checkpoint_r[lane] = std::numeric_limits<float>::quiet_NaN();
+            index[lane] = IDLE;
+        }
+    };
+
+    for (std::size_t lane = 0; lane < LANES; ++lane) {
+        refill(lane);
+    }
+
+    const Vec radius = FloatOps::Set1(static_cast<float>(escape_radius));
+    const Vec radius_squared = FloatOps::Set1(static_cast<float>(escape_radius * escape_radius));
+    const Vec max_iter = FloatOps::Set1(static_cast<float>(max_iterations));
+    const Vec one = FloatOps::Set1(1.0f);
+    const Vec two = FloatOps::Set1(2.0f);
+    const Vec rounding_bound = FloatOps::Set1(FLOAT_ROUNDING_BOUND);
+    const Vec tolerance =
+        FloatOps::Set1(std::max(FLOAT_PERIODICITY_TOLERANCE, static_cast<float>(checks.periodicity_tolerance)));
+    const Vec infinity = FloatOps::Set1(std::numeric_limits<float>::infinity());
+
+    Vec vzr = FloatOps::Load(zr);
+    Vec vzi = FloatOps::Load(zi);
+    Vec vcr = FloatOps::Load(cr);
+    Vec vci = FloatOps::Load(ci);
+    Vec vc_magnitude = FloatOps::Load(c_magnitude);
+    Vec verror = FloatOps::Load(error);
+    Vec viter = FloatOps::Load(iter);
+    Vec vcheckpoint_r = FloatOps::Load(checkpoint_r);
+    Vec vcheckpoint_i = FloatOps::Load(checkpoint_i);
+    Vec vcheckpoint_error = FloatOps::Load(checkpoint_error);
+    Vec vnext_checkpoint = FloatOps::Load(next_checkpoint);
+
+    while (active > 0) {
+        const Vec zr2 = FloatOps::Mul(vzr, vzr);
+        const Vec zi2 = FloatOps::Mul(vzi, vzi);
+        const Vec norm = FloatOps::Add(zr2, zi2);
+
+        // Лимит итераций проверяется первым; затем сомнительное положение относительно радиуса убегания
+        const Vec low = FloatOps::Sub(radius, verror);
+        const Vec high = FloatOps::Add(radius, verror);
+        const auto limit = FloatOps::GreaterEqual(viter, max_iter);
+        const auto ambiguous =
+            FloatOps::Or(FloatOps::GreaterEqual(verror, radius),
+                         FloatOps::And(FloatOps::Greater(norm, FloatOps::Mul(low, low)),
+                                       FloatOps::LessEqual(norm, FloatOps::Mul(high, high))));
+        const unsigned done = FloatOps::ToBits(
+            FloatOps::Or(limit, FloatOps::Or(ambiguous, FloatOps::Greater(norm, radius_squared))));
+
+        if (done != 0) {
+            const unsigned limit_bits = FloatOps::ToBits(limit);
+            const unsigned ambiguous_bits = FloatOps::ToBits(ambiguous);
+            FloatOps::Store(zr, vzr);
+            FloatOps::Store(zi, vzi);
+            FloatOps::Store(cr, vcr);
+            FloatOps::Store(ci, vci);
+            FloatOps::Store(c_magnitude, vc_magnitude);
+            FloatOps::Store(error, verror);
+            FloatOps::Store(iter, viter);
+            if constexpr (PERIODICITY) {
+                FloatOps::Store(checkpoint_r, vcheckpoint_r);
+                FloatOps::Store(checkpoint_i, vcheckpoint_i);
+                FloatOps::Store(checkpoint_error, vcheckpoint_error);
+                FloatOps::Store(next_checkpoint, vnext_checkpoint);
+            }
+
+            for (std::size_t lane = 0; lane < LANES; ++lane) {
+                if ((done >> lane) & 1u) {
+                    const bool fallback = !((limit_bits >> lane) & 1u) && ((ambiguous_bits >> lane) & 1u);
+                    iterations[index[lane]] = fallback ? FLOAT_FALLBACK : static_cast<std::uint32_t>(iter[lane]);
+                    --active;
+                    refill(lane);
+                }
+            }
+
+            vzr = FloatOps::Load(zr);
+            vzi = FloatOps::Load(zi);
+            vcr = FloatOps::Load(cr);
+            vci = FloatOps::Load(ci);
+            vc_magnitude = FloatOps::Load(c_magnitude);
+            verror = FloatOps::Load(error);
+            viter = FloatOps::Load(iter);
+            if constexpr (PERIODICITY) {
+                vcheckpoint_r = FloatOps::Load(checkpoint_r);
+                vcheckpoint_i = FloatOps::Load(checkpoint_i);
+                vcheckpoint_error = FloatOps::Load(checkpoint_error);
+                vnext_checkpoint = FloatOps::Load(next_checkpoint);
+            }
+            continue;
+        }
+
+        // error = error * (2|z| + error) + FLOAT_ROUNDING_BOUND * (|z|^2 + |c|)
+        const Vec z_magnitude = FloatOps::Add(FloatOps::Abs(vzr), FloatOps::Abs(vzi));
+        verror = FloatOps::Add(
+            FloatOps::Mul(verror, FloatOps::Add(FloatOps::Mul(z_magnitude, two), verror)),
+            FloatOps::Mul(rounding_bound, FloatOps::Add(norm, vc_magnitude)));
+
+        // z = z * z + c
+        const Vec zrzi = FloatOps::Mul(vzr, vzi);
+        vzr = FloatOps::Add(FloatOps::Sub(zr2, zi2), vcr);
+        vzi = FloatOps::Add(FloatOps::Add(zrzi, zrzi), vci);
+        viter = FloatOps::Add(viter, one);
+
+        if constexpr (PERIODICITY) {
+            // Похожая на периодическую орбита уходит в double: бесконечная ошибка завершит дорожку
+            const Vec match = FloatOps::Add(FloatOps::Add(tolerance, verror), vcheckpoint_error);
+            const auto periodic =
+                FloatOps::And(FloatOps::LessEqual(FloatOps::Abs(FloatOps::Sub(vzr, vcheckpoint_r)), match),
+                              FloatOps::LessEqual(FloatOps::Abs(FloatOps::Sub(vzi, vcheckpoint_i)), match));
+            verror = FloatOps::Select(periodic, infinity, verror);
+
+            const auto update = FloatOps::Equal(viter, vnext_checkpoint);
+            vcheckpoint_r = FloatOps::Select(update, vzr, vcheckpoint_r);
+            vcheckpoint_i = FloatOps::Select(update, vzi, vcheckpoint_i);
+            vcheckpoint_error = FloatOps::Select(update, verror, vcheckpoint_error);
+            vnext_checkpoint =
+                FloatOps::Select(update, FloatOps::Add(vnext_checkpoint, vnext_checkpoint), vnext_checkpoint);
+        }
+    }
+}
+
+// Векторная арифметика double-double: те же операции, что в double_double.hpp, в том же порядке
+struct DoubleDoubleVec {
+    Ops::Vec hi;
+    Ops::Vec lo;
+};
+
+struct DoubleDoubleOps {
+    using Vec = Ops::Vec;
+
+    static DoubleDoubleVec TwoSum(Vec a, Vec b) noexcept {
+        const Vec s = Ops::Add(a, b);
+        const Vec bb = Ops::Sub(s, a);
+        return {s, Ops::Add(Ops::Sub(a, Ops::Sub(s, bb)), Ops::Sub(b, bb))};
+    }
+
+    static DoubleDoubleVec QuickTwoSum(Vec a, Vec b) noexcept {
+        const Vec s = Ops::Add(a, b);
+        return {s, Ops::Sub(b, Ops::Sub(s, a))};
+    }
+
+    static DoubleDoubleVec Split(Vec a) noexcept {
+        const Vec t = Ops::Mul(Ops::Set1(double_double::SPLITTER), a);
+        const Vec hi = Ops::Sub(t, Ops::Sub(t, a));
+        return {hi, Ops::Sub(a, hi)};
+    }
+
+    static DoubleDoubleVec TwoProd(Vec a, Vec b) noexcept {
+        const Vec p = Ops::Mul(a, b);
+        const DoubleDoubleVec as = Split(a);
+        const DoubleDoubleVec bs = Split(b);
+        const Vec err = Ops::Add(
+            Ops::Add(Ops::Add(Ops::Sub(Ops::Mul(as.hi, bs.hi), p), Ops::Mul(as.hi, bs.lo)), Ops::Mul(as.lo, bs.hi)),
+            Ops::Mul(as.lo, bs.lo));
+        return {p, err};
+    }
+
+    static DoubleDoubleVec Add(const DoubleDoubleVec &a, const DoubleDoubleVec &b) noexcept {
+        const DoubleDoubleVec s = TwoSum(a.hi, b.hi);
+        const DoubleDoubleVec t = TwoSum(a.lo, b.lo);
+        const DoubleDoubleVec s2 = QuickTwoSum(s.hi, Ops::Add(s.lo, t.hi));
+        return QuickTwoSum(s2.hi, Ops::Add(s2.lo, t.lo));
+    }
+
+    static DoubleDoubleVec Negate(const DoubleDoubleVec &a) noexcept {
+        const Vec zero = Ops::Set1(0.0);
+        return {Ops::Sub(zero, a.hi), Ops::Sub(zero, a.lo)};
+    }
+
+    static DoubleDoubleVec Twice(const DoubleDoubleVec &a) noexcept {
+        return {Ops::Add(a.hi, a.hi), Ops::Add(a.lo, a.lo)};
+    }
+
+    static DoubleDoubleVec Mul(const DoubleDoubleVec &a, const DoubleDoubleVec &b) noexcept {
+        const DoubleDoubleVec p = TwoProd(a.hi, b.hi);
+        return QuickTwoSum(p.hi, Ops::Add(p.lo, Ops::Add(Ops::Mul(a.hi, b.lo), Ops::Mul(a.lo, b.hi))));
+    }
+
+    static DoubleDoubleVec Square(const DoubleDoubleVec &a) noexcept {
+        const DoubleDoubleVec p = TwoProd(a.hi, a.hi);
+        const Vec cross = Ops::Mul(a.hi, a.lo);
+        return QuickTwoSum(p.hi, Ops::Add(p.lo, Ops::Add(cross, cross)));
+    }
+};
+
+// Ядро double-double с заполнением освободившихся дорожек, как в IterateLanes.
+// Проверки InteriorChecks не применяются: их допуски рассчитаны на точность double.
+inline void IterateLanesDoubleDouble(std::span<const DoubleDoubleComplex> points, std::span<std::uint32_t> iterations,
+                                     std::uint32_t max_iterations, double escape_radius) noexcept {
+    using Vec = Ops::Vec;
+    using DD = DoubleDoubleOps;
+    constexpr std::size_t LANES = Ops::LANES;
+    constexpr std::size_t IDLE = std::numeric_limits<std::size_t>::max();
+
+    alignas(64) double zr_hi[LANES]{};
+    alignas(64) double zr_lo[LANES]{};
+    alignas(64) double zi_hi[LANES]{};
+    alignas(64) double zi_lo[LANES]{};
+    alignas(64) double cr_hi[LANES]{};
+    alignas(64) double cr_lo[LANES]{};
+    alignas(64) double ci_hi[LANES]{};
+    alignas(64) double ci_lo[LANES]{};
+    alignas(64) double iter[LANES]{};
+    std::size_t index[LANES];
+
+    std::size_t next = 0;
+    std::size_t active = 0;
+
+    auto refill = [&](std::size_t lane) {
+        zr_hi[lane] = 0.0;
+        zr_lo[lane] = 0.0;
+        zi_hi[lane] = 0.0;
+        zi_lo[lane] = 0.0;
+        if (next < points.size()) {
+            cr_hi[lane] = points[next].real.hi;
+            cr_lo[lane] = points[next].real.lo;
+            ci_hi[lane] = points[next].imag.hi;
+            ci_lo[lane] = points[next].imag.lo;
+            iter[lane] = 0.0;
+            index[lane] = next++;
+            ++active;
+        } else {
+            cr_hi[lane] = 0.0;
+            cr_lo[lane] = 0.0;
+            ci_hi[lane] = 0.0;
+            ci_lo[lane] = 0.0;
+            iter[lane] = -std::numeric_limits<double>::infinity();
+            index[lane] = IDLE;
+        }
+    };
+
+    for (std::size_t lane = 0; lane < LANES; ++lane) {
+        refill(lane);
+    }
+
+    const Vec escape_radius_squared = Ops::Set1(escape_radius * escape_radius);
+    const Vec max_iter = Ops::Set1(static_cast<double>(max_iterations));
+    const Vec one = Ops::Set1(1.0);
+
+    DoubleDoubleVec zr{Ops::Load(zr_hi), Ops::Load(zr_lo)};
+    DoubleDoubleVec zi{Ops::Load(zi_hi), Ops::Load(zi_lo)};
+    DoubleDoubleVec cr{Ops::Load(cr_hi), Ops::Load(cr_lo)};
+    DoubleDoubleVec ci{Ops::Load(ci_hi), Ops::Load(ci_lo)};
+    Vec viter = Ops::Load(iter);
+
+    while (active > 0) {
+        const Vec norm = Ops::Add(Ops::Mul(zr.hi, zr.hi), Ops::Mul(zi.hi, zi.hi));
+        const unsigned done =
+            Ops::ToBits(Ops::Or(Ops::Greater(norm, escape_radius_squared), Ops::GreaterEqual(viter, max_iter)));
+
+        if (done != 0) {
+            Ops::Store(zr_hi, zr.hi);
+            Ops::Store(zr_lo, zr.lo);
+            Ops::Store(zi_hi, zi.hi);
+            Ops::Store(zi_lo, zi.lo);
+            Ops::Store(cr_hi, cr.hi);
+            Ops::Store(cr_lo, cr.lo);
+            Ops::Store(ci_hi, ci.hi);
+            Ops::Store(ci_lo, ci.lo);
+            Ops::Store(iter, viter);
+
+            for (std::size_t lane = 0; lane < LANES; ++lane) {
+                if ((done >> lane) & 1u) {
+                    iterations[index[lane]] = static_cast<std::uint32_t>(iter[lane]);
+                    --active;
+                    refill(lane);
+                }
+            }
+
+            zr = {Ops::Load(zr_hi), Ops::Load(zr_lo)};
+            zi = {Ops::Load(zi_hi), Ops::Load(zi_lo)};
+            cr = {Ops::Load(cr_hi), Ops::Load(cr_lo)};
+            ci = {Ops::Load(ci_hi), Ops::Load(ci_lo)};
+            viter = Ops::Load(iter);
+            continue;
+        }
+
+        // z = z * z + c
+        const DoubleDoubleVec real_squared = DD::Square(zr);
+        const DoubleDoubleVec imag_squared = DD::Square(zi);
+        const DoubleDoubleVec real_imag = DD::Mul(zr, zi);
+        zr = DD::Add(DD::Add(real_squared, DD::Negate(imag_squared)), cr);
+        zi = DD::Add(DD::Twice(real_imag), ci);
+        viter = Ops::Add(viter, one);
+    }
+}
+
+// Точка входа для этого набора инструкций: векторные типы не пересекают её границу
+inline void CalculateIterations(std::span<const Complex> points, std::span<std::uint32_t> iterations,
+                                std::uint32_t max_iterations, double escape_radius,
+                                const InteriorChecks &checks) noexcept {
+    if (checks.periodicity) {
+        IterateLanes<true>(points, iterations, max_iterations, escape_radius, checks);
+    } else {
+        IterateLanes<false>(points, iterations, max_iterations, escape_radius, checks);
+    }
+}
+
+inline void CalculateIterations(std::span<const DoubleDoubleComplex> points, std::span<std::uint32_t> iterations,
+                                std::uint32_t max_iterations, double escape_radius) noexcept {
+    IterateLanesDoubleDouble(points, iterations, max_iterations, escape_radius);
+}
+
+inline void CalculateIterationsFloat(std::span<const Complex> points, std::span<std::uint32_t> iterations,
+                                     std::uint32_t max_iterations, double escape_radius,
+                                     const InteriorChecks &checks) noexcept {
+    if (checks.periodicity) {
+        IterateLanesFloat<true>(points, iterations, max_iterations, escape_radius, checks);
+    } else {
+        IterateLanesFloat<false>(points, iterations, max_iterations, escape_radius, checks);
+    }
+}
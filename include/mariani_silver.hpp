@@ -0,0 +1,337 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+#include <stdexec/execution.hpp>
+
+#include "mandelbrot_simd.hpp"
+#include "palette.hpp"
+#include "render_stop.hpp"
+#include "types.hpp"
+
+// Прямоугольники, у которых хотя бы одна сторона не больше этой, вычисляются целиком без деления
+const constexpr std::uint32_t MARIANI_SILVER_MIN_SIZE{12};
+// Прямоугольники с площадью не меньше этой обрабатываются отдельными задачами пула
+const constexpr std::uint32_t MARIANI_SILVER_TASK_AREA{64 * 64};
+
+// Рендеринг делением прямоугольников (алгоритм Мариани–Сильвера): вычисляется только граница
+// прямоугольника; если на всей границе одинаковое число итераций, внутренность заливается без вычисления,
+// иначе прямоугольник делится пополам и обе половины обрабатываются так же.
+// Все координаты задаются в пикселях кадра, target покрывает весь кадр.
+class MarianiSilver {
+public:
+    // Палитра для target.colors строится здесь: вычисление не бросает исключений, а построение палитры может
+    MarianiSilver(mandelbrot::ViewPort viewport, RenderSettings settings, RenderTarget target)
+        : viewport_{viewport}, settings_{settings}, target_{target},
+          float_kernel_{UseFloatKernel(viewport, settings)},
+          palette_{target.HasColors()
+                       ? std::make_shared<const mandelbrot::Palette>(settings.max_iterations, settings.coloring)
+                       : nullptr} {}
+
+    // Вычисляет границу прямоугольника region; после этого его можно передавать в Subdivide
+    void ComputeBorder(const PixelRegion &region) const noexcept {
+        if (region.width() == 0 || region.height() == 0) {
+            return;
+        }
+        const std::uint32_t last_row = region.end_row - 1;
+        const std::uint32_t last_col = region.end_col - 1;
+
+        PointBatch batch{*this};
+        for (std::uint32_t x = region.start_col; x < region.end_col; ++x) {
+            batch.Add(x, region.start_row);
+            if (last_row != region.start_row) {
+                batch.Add(x, last_row);
+            }
+        }
+        for (std::uint32_t y = region.start_row + 1; y < last_row; ++y) {
+            batch.Add(region.start_col, y);
+            if (last_col != region.start_col) {
+                batch.Add(last_col, y);
+            }
+        }
+    }
+
+    // Обрабатывает прямоугольник с уже вычисленной границей. Половины, площадь которых не меньше
+    // MARIANI_SILVER_TASK_AREA, передаются в spawn (для запуска отдельной задачей), остальные
+    // обрабатываются рекурсивно в текущем потоке.
+    template <typename Spawn>
+    void Subdivide(const PixelRegion &region, Spawn &&spawn) const noexcept {
+        if (region.width() <= 2 || region.height() <= 2) {
+            // Внутренности нет: все пиксели лежат на границе
+            return;
+        }
+
+        const PixelRegion inner{region.start_row + 1, region.end_row - 1, region.start_col + 1, region.end_col - 1};
+
+        if (region.width() <= MARIANI_SILVER_MIN_SIZE || region.height() <= MARIANI_SILVER_MIN_SIZE) {
+            ComputeRegion(inner);
+            return;
+        }
+
+        if (const auto iterations = UniformBorderIterations(region)) {
+            Fill(inner, *iterations);
+            return;
+        }
+
+        // Делим по длинной стороне; линия раздела становится общей границей половин
+        PixelRegion first = region;
+        PixelRegion second = region;
+        if (region.width() >= region.height()) {
+            const std::uint32_t middle = region.start_col + region.width() / 2;
+            ComputeRegion(PixelRegion{inner.start_row, inner.end_row, middle, middle + 1});
+            first.end_col = middle + 1;
+            second.start_col = middle;
+        } else {
+            const std::uint32_t middle = region.start_row + region.height() / 2;
+            ComputeRegion(PixelRegion{middle, middle + 1, inner.start_col, inner.end_col});
+            first.end_row = middle + 1;
+            second.start_row = middle;
+        }
+
+        for (const auto &half : {first, second}) {
+            if (half.width() * half.height() >= MARIANI_SILVER_TASK_AREA) {
+                spawn(half);
+            } else {
+                Subdivide(half, spawn);
+            }
+        }
+    }
+
+    // Последовательный рендеринг области целиком в текущем потоке
+    void Render(const PixelRegion &region) const noexcept {
+        ComputeBorder(region);
+        Subdivide(region, *this);
+    }
+
+    // Последовательная обработка половины: сам объект может выступать в роли spawn
+    void operator()(const PixelRegion &half) const noexcept { Subdivide(half, *this); }
+
+private:
+    // Накопитель точек для векторного ядра. Отрезки границ и небольшие прямоугольники слишком коротки,
+    // чтобы вычислять их построчно: дорожки ядра простаивали бы в ожидании самой долгой точки.
+    // Поэтому точки собираются в порции по CAPACITY и вычисляются одним вызовом.
+    class PointBatch {
+    public:
+        explicit PointBatch(const MarianiSilver &owner) noexcept : owner_{owner} {}
+        PointBatch(const PointBatch &) = delete;
+        PointBatch &operator=(const PointBatch &) = delete;
+        ~PointBatch() { Flush(); }
+
+        void Add(std::uint32_t x, std::uint32_t y) noexcept {
+            points_[count_] = mandelbrot::Pixel2DToComplex(x, y, owner_.viewport_, owner_.settings_.width,
+                                                           owner_.settings_.height);
+            xs_[count_] = x;
+            ys_[count_] = y;
+            if (++count_ == CAPACITY) {
+                Flush();
+            }
+        }
+
+        void Flush() noexcept {
+            if (count_ == 0) {
+                return;
+            }
+            const auto &settings = owner_.settings_;
+            const auto iterations = std::span{iterations_}.first(count_);
+            if (owner_.float_kernel_) {
+                mandelbrot::simd::CalculateIterationsFloat(std::span{points_}.first(count_), iterations,
+                                                           settings.max_iterations, settings.escape_radius,
+                                                           settings.interior_checks);
+            } else {
+                mandelbrot::simd::CalculateIterations(std::span{points_}.first(count_), iterations,
+                                                      settings.max_iterations, settings.escape_radius,
+                                                      settings.interior_checks);
+            }
+            for (std::uint32_t i = 0; i < count_; ++i) {
+                owner_.target_.pixels(xs_[i], ys_[i]) = iterations_[i];
+            }
+            if (owner_.target_.HasColors()) {
+                const auto &palette = *owner_.palette_;
+                for (std::uint32_t i = 0; i < count_; ++i) {
+                    owner_.target_.colors(xs_[i], ys_[i]) = palette[iterations_[i]];
+                }
+            }
+            count_ = 0;
+        }
+
+    private:
+        static constexpr std::uint32_t CAPACITY = 256;
+
+        const MarianiSilver &owner_;
+        std::array<mandelbrot::Complex, CAPACITY> points_;
+        std::array<std::uint32_t, CAPACITY> iterations_;
+        std::array<std::uint32_t, CAPACITY> xs_;
+        std::array<std::uint32_t, CAPACITY> ys_;
+        std::uint32_t count_{0};
+    };
+
+    // Вычисляет все пиксели прямоугольника region
+    void ComputeRegion(const PixelRegion &region) const noexcept {
+        PointBatch batch{*this};
+        for (std::uint32_t y = region.start_row; y < region.end_row; ++y) {
+            for (std::uint32_t x = region.start_col; x < region.end_col; ++x) {
+                batch.Add(x, y);
+            }
+        }
+    }
+
+    // Число итераций, если оно одинаково на всей границе, иначе std::nullopt
+    [[nodiscard]] std::optional<std::uint32_t> UniformBorderIterations(const PixelRegion &region) const noexcept {
+        const std::uint32_t value = target_.pixels(region.start_col, region.start_row);
+        const std::uint32_t last_row = region.end_row - 1;
+        const std::uint32_t last_col = region.end_col - 1;
+
+        for (std::uint32_t x = region.start_col; x < region.end_col; ++x) {
+            if (target_.pixels(x, region.start_row) != value || target_.pixels(x, last_row) != value) {
+                return std::nullopt;
+            }
+        }
+        for (std::uint32_t y = region.start_row + 1; y < last_row; ++y) {
+            if (target_.pixels(region.start_col, y) != value || target_.pixels(last_col, y) != value) {
+                return std::nullopt;
+            }
+        }
+        return value;
+    }
+
+    void Fill(const PixelRegion &region, std::uint32_t iterations) const noexcept {
+        for (std::uint32_t y = region.start_row; y < region.end_row; ++y) {
+            std::ranges::fill(target_.pixels[y].subspan(region.start_col, region.width()), iterations);
+        }
+        if (!target_.HasColors()) {
+            return;
+        }
+        const auto color = (*palette_)[iterations];
+        for (std::uint32_t y = region.start_row; y < region.end_row; ++y) {
+            std::ranges::fill(target_.colors[y].subspan(region.start_col, region.width()), color);
+        }
+    }
+
+    mandelbrot::ViewPort viewport_;
+    RenderSettings settings_;
+    RenderTarget target_;
+    // Ядро float для неглубоких видов (см. UseFloatKernel)
+    bool float_kernel_;
+    // Своя палитра, а не CachedPalette: объект копируется в задачи других потоков; nullptr без target.colors
+    std::shared_ptr<const mandelbrot::Palette> palette_;
+};
+
+// Рендеринг алгоритмом Мариани–Сильвера на пуле потоков: каждая область regions и каждый крупный прямоугольник
+// обрабатываются отдельной задачей на планировщике, операция завершается вместе с последней задачей.
+// После отмены задачи пропускают свои прямоугольники, и операция завершается set_stopped.
+template <typename Scheduler, typename Receiver>
+struct MarianiSilverOperationState {
+    Receiver receiver_;
+    Scheduler scheduler_;
+    MarianiSilver renderer_;
+    std::vector<PixelRegion> regions_;
+    stdexec::inplace_stop_token stop_token_;
+    // Количество запущенных, но ещё не завершённых задач
+    std::atomic<std::size_t> pending_{0};
+    // Хотя бы один прямоугольник пропущен из-за отмены
+    std::atomic<bool> stopped_{false};
+
+    template <typename R>
+    explicit MarianiSilverOperationState(R &&r, Scheduler scheduler, MarianiSilver renderer,
+                                         std::vector<PixelRegion> regions, stdexec::inplace_stop_token stop_token)
+        : receiver_{std::forward<R>(r)}, scheduler_{scheduler}, renderer_{std::move(renderer)},
+          regions_{std::move(regions)}, stop_token_{stop_token} {}
+
+    void start() noexcept {
+        // Собственная ссылка не даёт операции завершиться, пока запускаются задачи областей
+        pending_.store(1, std::memory_order_relaxed);
+        for (const auto &region : regions_) {
+            if (region.width() != 0 && region.height() != 0) {
+                Spawn(region, true);
+            }
+        }
+        Release();
+    }
+
+    // Запускает обработку прямоугольника отдельной задачей; граница корневого прямоугольника
+    // вычисляется в той же задаче, у остальных она уже посчитана родителем
+    void Spawn(const PixelRegion &region, bool compute_border) noexcept {
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        try {
+            stdexec::start_detached(stdexec::schedule(scheduler_) |
+                                    stdexec::then([this, region, compute_border] { Run(region, compute_border); }));
+        } catch (...) {
+            // Задачу не удалось запланировать: обрабатываем прямоугольник в текущем потоке
+            Run(region, compute_border);
+        }
+    }
+
+    void Run(const PixelRegion &region, bool compute_border) noexcept {
+        if (StopRequested(receiver_, stop_token_)) {
+            stopped_.store(true, std::memory_order_relaxed);
+        } else {
+            if (compute_border) {
+                renderer_.ComputeBorder(region);
+            }
+            renderer_.Subdivide(region, [this](const PixelRegion &half) { Spawn(half, false); });
+        }
+        Release();
+    }
+
+    // Снимает ссылку задачи; последняя завершает операцию
+    void Release() noexcept {
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            if (stopped_.load(std::memory_order_relaxed)) {
+                stdexec::set_stopped(std::move(receiver_));
+            } else {
+                stdexec::set_value(std::move(receiver_));
+            }
+        }
+    }
+};
+
+template <typename Scheduler>
+struct MarianiSilverSender {
+    Scheduler scheduler_;
+    mandelbrot::ViewPort viewport_;
+    RenderSettings settings_;
+    std::vector<PixelRegion> regions_;
+    RenderTarget target_;
+    stdexec::inplace_stop_token stop_token_;
+
+    using completion_signatures = stdexec::completion_signatures<stdexec::set_value_t(), stdexec::set_stopped_t()>;
+
+    template <typename Env>
+    auto get_completion_signatures(Env) const -> completion_signatures {
+        return {};
+    }
+
+    template <typename R>
+    auto connect(R &&r) {
+        return MarianiSilverOperationState<Scheduler, std::decay_t<R>>{
+            std::forward<R>(r), scheduler_, MarianiSilver{viewport_, settings_, target_}, regions_, stop_token_};
+    }
+};
+
+// Области regions кадра делятся независимо (например, части кадра вокруг плиток из кэша).
+// target должен покрывать весь кадр settings.width x settings.height; области не должны пересекаться.
+template <typename Scheduler>
+[[nodiscard]] auto MakeMarianiSilverSender(Scheduler scheduler, mandelbrot::ViewPort viewport, RenderSettings settings,
+                                           RenderTarget target, std::vector<PixelRegion> regions,
+                                           stdexec::inplace_stop_token stop_token = {}) {
+    return MarianiSilverSender<Scheduler>{scheduler, viewport, settings, std::move(regions), target, stop_token};
+}
+
+// Весь кадр
+template <typename Scheduler>
+[[nodiscard]] auto MakeMarianiSilverSender(Scheduler scheduler, mandelbrot::ViewPort viewport, RenderSettings settings,
+                                           RenderTarget target, stdexec::inplace_stop_token stop_token = {}) {
+    return MakeMarianiSilverSender(scheduler, viewport, settings, target,
+                                   std::vector{PixelRegion{0, settings.height, 0, settings.width}}, stop_token);
+}
+
+namespace stdexec {
+template <typename Scheduler>
+inline constexpr bool enable_sender<MarianiSilverSender<Scheduler>> = true;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "mandelbrot_fractal_utils.hpp"
+#include "mandelbrot_simd.hpp"
+#include "types.hpp"
+
+namespace mandelbrot {
+
+// Период палитры в режиме ColoringMode::CYCLIC, в итерациях
+const constexpr std::uint32_t PALETTE_CYCLE_LENGTH{64};
+
+// Цвет палитры kind на шаге step из period (0 <= step < period)
+[[nodiscard]] constexpr RgbColor PaletteColor(PaletteKind kind, std::uint32_t step, std::uint32_t period) noexcept {
+    switch (kind) {
+    case PaletteKind::FIRE: {
+        // Каналы загораются по очереди: красный, затем зелёный, затем синий
+        const double t = 3.0 * step / period;
+        const auto channel = [t](double start) {
+            return static_cast<std::uint8_t>(std::clamp(t - start, 0.0, 1.0) * 255);
+        };
+        return RgbColor{channel(0.0), channel(1.0), channel(2.0)};
+    }
+    case PaletteKind::GRAYSCALE: {
+        const auto value = static_cast<std::uint8_t>(255.0 * step / period);
+        return RgbColor{value, value, value};
+    }
+    default:
+        return IterationsToColor(step, period);
+    }
+}
+
+// Таблица цветов для 0..max_iterations итераций. Цвет зависит только от (iterations, max_iterations)
+// и настроек раскраски, поэтому палитра считается один раз, а не для каждого пикселя каждого кадра.
+// Точки множества (max_iterations) чёрные при любой палитре.
+class Palette {
+public:
+    explicit Palette(std::uint32_t max_iterations, ColorSettings coloring = {})
+        : max_iterations_{max_iterations}, coloring_{coloring}, colors_(max_iterations + 1) {
+        const std::uint32_t period = coloring.mode == ColoringMode::CYCLIC ? PALETTE_CYCLE_LENGTH : max_iterations;
+        for (std::uint32_t iterations = 0; iterations < max_iterations; ++iterations) {
+            const std::int64_t shifted = std::int64_t{iterations} + coloring.cycle_offset;
+            const auto step = static_cast<std::uint32_t>((shifted % period + period) % period);
+            colors_[iterations] = PaletteColor(coloring.palette, step, period);
+        }
+        colors_[max_iterations] = RgbColors::BLACK;
+    }
+
+    [[nodiscard]] std::uint32_t MaxIterations() const noexcept { return max_iterations_; }
+    [[nodiscard]] const ColorSettings &Coloring() const noexcept { return coloring_; }
+
+    // Число итераций больше max_iterations раскрашивается как max_iterations
+    [[nodiscard]] RgbColor operator[](std::uint32_t iterations) const noexcept {
+        return colors_[std::min(iterations, max_iterations_)];
+    }
+
+    [[nodiscard]] std::span<const RgbColor> Colors() const noexcept { return colors_; }
+
+    // Раскрашивает строку пикселей векторным проходом (см. simd::Colorize)
+    void Colorize(std::span<const std::uint32_t> iterations, std::span<RgbColor> colors) const noexcept {
+        simd::Colorize(iterations, colors_, colors);
+    }
+
+private:
+    std::uint32_t max_iterations_;
+    ColorSettings coloring_;
+    std::vector<RgbColor> colors_;
+};
+
+// Палитра, построенная в этом потоке. Потоки пула строят её при первом кадре и перестраивают только
+// при смене max_iterations или раскраски. Ссылка действительна до следующего вызова с другими
+// параметрами в том же потоке.
+[[nodiscard]] inline const Palette &CachedPalette(std::uint32_t max_iterations, const ColorSettings &coloring = {}) {
+    thread_local std::optional<Palette> palette;
+    if (!palette || palette->MaxIterations() != max_iterations || palette->Coloring() != coloring) {
+        palette.emplace(max_iterations, coloring);
+    }
+    return *palette;
+}
+
+[[nodiscard]] inline const Palette &CachedPalette(const RenderSettings &settings) {
+    return CachedPalette(settings.max_iterations, settings.coloring);
+}
+
+}  // namespace mandelbrot
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "types.hpp"
+
+// Потоковая запись изображения в двоичный PPM (P6): заголовок пишется при открытии, строки дописываются
+// полосами по мере готовности, поэтому в памяти не нужно держать всё изображение.
+// Ошибки ввода-вывода и несогласованные размеры полос бросают std::runtime_error.
+class PpmWriter {
+public:
+    PpmWriter(const std::filesystem::path &path, std::uint32_t width, std::uint32_t height)
+        : width_{width}, height_{height}, file_{path, std::ios::binary | std::ios::trunc},
+          row_(3 * std::size_t{width}) {
+        if (!file_) {
+            throw std::runtime_error{std::format("PpmWriter: cannot open {}", path.string())};
+        }
+        file_ << "P6\n" << width << ' ' << height << "\n255\n";
+        Check();
+    }
+
+    [[nodiscard]] std::uint32_t RowsWritten() const noexcept { return rows_written_; }
+
+    // Дописывает строки полосы colors сразу после уже записанных; альфа-канал отбрасывается
+    void WriteRows(const ColorMatrix &colors) {
+        if (colors.width() != width_ || rows_written_ + colors.height() > height_) {
+            throw std::runtime_error{std::format("PpmWriter: band {}x{} does not fit image {}x{} at row {}",
+                                                 colors.width(), colors.height(), width_, height_, rows_written_)};
+        }
+        for (std::uint32_t y = 0; y < colors.height(); ++y) {
+            const auto source = colors[y];
+            for (std::uint32_t x = 0; x < width_; ++x) {
+                row_[3 * x] = static_cast<char>(source[x].r);
+                row_[3 * x + 1] = static_cast<char>(source[x].g);
+                row_[3 * x + 2] = static_cast<char>(source[x].b);
+            }
+            file_.write(row_.data(), static_cast<std::streamsize>(row_.size()));
+        }
+        Check();
+        rows_written_ += colors.height();
+    }
+
+    // Завершает файл: все строки должны быть записаны
+    void Close() {
+        if (rows_written_ != height_) {
+            throw std::runtime_error{std::format("PpmWriter: {} of {} rows written", rows_written_, height_)};
+        }
+        file_.close();
+        Check();
+    }
+
+private:
+    void Check() const {
+        if (file_.fail()) {
+            throw std::runtime_error{"PpmWriter: write failed"};
+        }
+    }
+
+    std::uint32_t width_;
+    std::uint32_t height_;
+    std::uint32_t rows_written_{0};
+    std::ofstream file_;
+    // Строка в формате RGB8 для записи одним вызовом
+    std::vector<char> row_;
+};
+
+// Записывает изображение целиком
+inline void WritePpm(const std::filesystem::path &path, const ColorMatrix &colors) {
+    PpmWriter writer{path, colors.width(), colors.height()};
+    writer.WriteRows(colors);
+    writer.Close();
+}
+
+// Читает двоичный PPM (P6, 255 уровней), записанный PpmWriter; альфа-канал цветов — 255.
+// Бросает std::runtime_error, если файла нет или формат не поддерживается.
+[[nodiscard]] inline ColorMatrix ReadPpm(const std::filesystem::path &path) {
+    std::ifstream file{path, std::ios::binary};
+    std::string magic;
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    std::uint32_t max_value = 0;
+    file >> magic >> width >> height >> max_value;
+    // После заголовка ровно один пробельный символ
+    file.get();
+    if (!file || magic != "P6" || max_value != 255) {
+        throw std::runtime_error{std::format("ReadPpm: unsupported or missing file {}", path.string())};
+    }
+
+    ColorMatrix colors(width, height);
+    std::vector<char> row(3 * std::size_t{width});
+    for (std::uint32_t y = 0; y < height; ++y) {
+        if (!file.read(row.data(), static_cast<std::streamsize>(row.size()))) {
+            throw std::runtime_error{std::format("ReadPpm: truncated file {}", path.string())};
+        }
+        const auto target = colors[y];
+        for (std::uint32_t x = 0; x < width; ++x) {
+            target[x] = mandelbrot::RgbColor{static_cast<std::uint8_t>(row[3 * x]),
+                                             static_cast<std::uint8_t>(row[3 * x + 1]),
+                                             static_cast<std::uint8_t>(row[3 * x + 2])};
+        }
+    }
+    return colors;
+}
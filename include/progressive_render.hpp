@@ -0,0 +1,152 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <span>
+
+#include "double_double.hpp"
+#include "mandelbrot_simd.hpp"
+#include "palette.hpp"
+#include "render_stats.hpp"
+#include "tile_queue.hpp"
+#include "types.hpp"
+
+// Шаги сетки проходов прогрессивного рендеринга: сначала 1/16 пикселей, затем 1/4, затем все
+const constexpr std::array<std::uint32_t, 3> PROGRESSIVE_PASS_STEPS{4, 2, 1};
+
+// Один проход прогрессивного рендеринга. Вычисляются пиксели на сетке с шагом step = PROGRESSIVE_PASS_STEPS[pass],
+// кроме уже посчитанных на сетке предыдущего прохода; каждый вычисленный пиксель заливает свой блок step x step,
+// чтобы промежуточный кадр можно было показать. После последнего прохода кадр совпадает с полным расчётом.
+// Сетка привязана к кадру, поэтому блоки разных плиток не пересекаются; target покрывает весь кадр.
+class ProgressivePass {
+public:
+    // Палитра для target.colors строится здесь: вычисление не бросает исключений, а построение палитры может
+    ProgressivePass(mandelbrot::ViewPort viewport, RenderSettings settings, RenderTarget target,
+                    mandelbrot::Precision precision, std::uint32_t pass)
+        : viewport_{viewport}, settings_{settings}, target_{target}, precision_{precision},
+          float_kernel_{precision == mandelbrot::Precision::DOUBLE && UseFloatKernel(viewport, settings)},
+          step_{PROGRESSIVE_PASS_STEPS[pass]}, coarser_step_{pass == 0 ? 0 : PROGRESSIVE_PASS_STEPS[pass - 1]},
+          palette_{target.HasColors()
+                       ? std::make_shared<const mandelbrot::Palette>(settings.max_iterations, settings.coloring)
+                       : nullptr} {}
+
+    void Render(const PixelRegion &region) const noexcept {
+        PointBatch batch{*this};
+        for (std::uint32_t y = FirstOnGrid(region.start_row); y < region.end_row; y += step_) {
+            for (std::uint32_t x = FirstOnGrid(region.start_col); x < region.end_col; x += step_) {
+                if (coarser_step_ != 0 && x % coarser_step_ == 0 && y % coarser_step_ == 0) {
+                    continue;
+                }
+                batch.Add(x, y);
+            }
+        }
+    }
+
+    // Рабочий цикл прохода: плитки из общей очереди, перед каждой вызывается should_stop(),
+    // после каждой on_tile(tile, время) — как в ::RenderTiles. Возвращает false, если цикл прерван.
+    template <typename ShouldStop, typename OnTile = IgnoreTileTime>
+    bool RenderTiles(TileQueue &tiles, ShouldStop should_stop, OnTile on_tile = {}) const noexcept {
+        while (const auto tile = tiles.Next()) {
+            if (should_stop()) {
+                return false;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            Render(*tile);
+            on_tile(*tile, std::chrono::steady_clock::now() - start);
+        }
+        return true;
+    }
+
+private:
+    // Накопитель точек для векторного ядра: на грубых проходах строка сетки слишком коротка для него
+    class PointBatch {
+    public:
+        explicit PointBatch(const ProgressivePass &owner) noexcept : owner_{owner} {}
+        PointBatch(const PointBatch &) = delete;
+        PointBatch &operator=(const PointBatch &) = delete;
+        ~PointBatch() { Flush(); }
+
+        void Add(std::uint32_t x, std::uint32_t y) noexcept {
+            const auto &settings = owner_.settings_;
+            if (owner_.precision_ == mandelbrot::Precision::DOUBLE_DOUBLE) {
+                precise_points_[count_] =
+                    mandelbrot::Pixel2DToDoubleDouble(x, y, owner_.viewport_, settings.width, settings.height);
+            } else {
+                points_[count_] = mandelbrot::Pixel2DToComplex(x, y, owner_.viewport_, settings.width, settings.height);
+            }
+            xs_[count_] = x;
+            ys_[count_] = y;
+            if (++count_ == CAPACITY) {
+                Flush();
+            }
+        }
+
+        void Flush() noexcept {
+            if (count_ == 0) {
+                return;
+            }
+            const auto &settings = owner_.settings_;
+            const auto iterations = std::span{iterations_}.first(count_);
+            if (owner_.precision_ == mandelbrot::Precision::DOUBLE_DOUBLE) {
+                mandelbrot::simd::CalculateIterations(std::span{precise_points_}.first(count_), iterations,
+                                                      settings.max_iterations, settings.escape_radius);
+            } else if (owner_.float_kernel_) {
+                mandelbrot::simd::CalculateIterationsFloat(std::span{points_}.first(count_), iterations,
+                                                           settings.max_iterations, settings.escape_radius,
+                                                           settings.interior_checks);
+            } else {
+                mandelbrot::simd::CalculateIterations(std::span{points_}.first(count_), iterations,
+                                                      settings.max_iterations, settings.escape_radius,
+                                                      settings.interior_checks);
+            }
+            for (std::uint32_t i = 0; i < count_; ++i) {
+                owner_.FillBlock(xs_[i], ys_[i], iterations_[i]);
+            }
+            count_ = 0;
+        }
+
+    private:
+        static constexpr std::uint32_t CAPACITY = 256;
+
+        const ProgressivePass &owner_;
+        std::array<mandelbrot::Complex, CAPACITY> points_;
+        std::array<mandelbrot::DoubleDoubleComplex, CAPACITY> precise_points_;
+        std::array<std::uint32_t, CAPACITY> iterations_;
+        std::array<std::uint32_t, CAPACITY> xs_;
+        std::array<std::uint32_t, CAPACITY> ys_;
+        std::uint32_t count_{0};
+    };
+
+    [[nodiscard]] std::uint32_t FirstOnGrid(std::uint32_t start) const noexcept {
+        return (start + step_ - 1) / step_ * step_;
+    }
+
+    // Заливает блок step x step с углом в вычисленном пикселе, обрезанный по границе кадра
+    void FillBlock(std::uint32_t x, std::uint32_t y, std::uint32_t iterations) const noexcept {
+        const std::uint32_t width = std::min(step_, target_.pixels.width() - x);
+        const std::uint32_t end_row = std::min(y + step_, target_.pixels.height());
+        for (std::uint32_t row = y; row < end_row; ++row) {
+            std::ranges::fill(target_.pixels[row].subspan(x, width), iterations);
+        }
+        if (!target_.HasColors()) {
+            return;
+        }
+        const auto color = (*palette_)[iterations];
+        for (std::uint32_t row = y; row < end_row; ++row) {
+            std::ranges::fill(target_.colors[row].subspan(x, width), color);
+        }
+    }
+
+    mandelbrot::ViewPort viewport_;
+    RenderSettings settings_;
+    RenderTarget target_;
+    mandelbrot::Precision precision_;
+    // Ядро float для неглубоких видов (см. UseFloatKernel)
+    bool float_kernel_;
+    std::uint32_t step_;
+    std::uint32_t coarser_step_;
+    // Своя палитра, а не CachedPalette: проход копируется в задачи других потоков; nullptr без target.colors
+    std::shared_ptr<const mandelbrot::Palette> palette_;
+};
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <string>
+#include <vector>
+
+#include "mandelbrot_fractal_utils.hpp"
+#include "types.hpp"
+
+// Статистика рендеринга кадра (RenderResult::stats): время плиток и занятость рабочих задач собираются
+// во время расчёта, счётчики пикселей — по готовому кадру. Выводится оверлеем в окне и строками JSON.
+
+// Обработчик времени плитки по умолчанию: статистика не собирается
+struct IgnoreTileTime {
+    void operator()(const PixelRegion &, std::chrono::nanoseconds) const noexcept {}
+};
+
+// Сборщик времени плиток и занятости задач кадра. Задача worker пишет только в свой слот, поэтому блокировки
+// не нужны; слоты читаются после завершения всех задач (см. MergeInto).
+class RenderStatsCollector {
+public:
+    explicit RenderStatsCollector(std::uint32_t workers) : slots_(workers) {}
+
+    // Время плитки region задачи worker; при нехватке памяти плитка не учитывается
+    void AddTile(std::uint32_t worker, const PixelRegion &region, std::chrono::nanoseconds time) noexcept {
+        try {
+            slots_[worker].tiles.push_back(TileStats{.region = region, .worker = worker, .time = time});
+        } catch (...) {
+        }
+    }
+
+    void AddBusy(std::uint32_t worker, std::chrono::nanoseconds time) noexcept { slots_[worker].busy += time; }
+
+    void AddSupersampled(std::uint32_t worker, std::uint64_t pixels) noexcept { slots_[worker].supersampled += pixels; }
+
+    // Обработчик времени плиток задачи worker для RenderTiles
+    [[nodiscard]] auto TileRecorder(std::uint32_t worker) noexcept {
+        return [this, worker](const PixelRegion &region, std::chrono::nanoseconds time) noexcept {
+            AddTile(worker, region, time);
+        };
+    }
+
+    // Замер занятости: время жизни таймера добавляется к занятости задачи worker
+    class BusyTimer {
+    public:
+        BusyTimer(RenderStatsCollector &collector, std::uint32_t worker) noexcept
+            : collector_{collector}, worker_{worker}, start_{std::chrono::steady_clock::now()} {}
+        BusyTimer(const BusyTimer &) = delete;
+        BusyTimer &operator=(const BusyTimer &) = delete;
+        ~BusyTimer() { collector_.AddBusy(worker_, std::chrono::steady_clock::now() - start_); }
+
+    private:
+        RenderStatsCollector &collector_;
+        std::uint32_t worker_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    [[nodiscard]] BusyTimer TrackBusy(std::uint32_t worker) noexcept { return BusyTimer{*this, worker}; }
+
+    // Дописывает плитки, занятость задач и сглаженные пиксели в stats
+    void MergeInto(RenderStats &stats) const {
+        stats.worker_busy.resize(std::max(stats.worker_busy.size(), slots_.size()));
+        for (std::size_t worker = 0; worker < slots_.size(); ++worker) {
+            stats.tiles.insert(stats.tiles.end(), slots_[worker].tiles.begin(), slots_[worker].tiles.end());
+            stats.worker_busy[worker] += slots_[worker].busy;
+            stats.supersampled_pixels += slots_[worker].supersampled;
+        }
+    }
+
+private:
+    // Слоты на отдельных кэш-линиях: задачи пишут в них из разных потоков
+    struct alignas(64) Slot {
+        std::vector<TileStats> tiles;
+        std::chrono::nanoseconds busy{};
+        std::uint64_t supersampled{0};
+    };
+    std::vector<Slot> slots_;
+};
+
+// Считает итерации, убежавшие, поздно убежавшие и внутренние пиксели готового кадра
+inline void CountPixels(RenderStats &stats, const PixelMatrix &pixels, std::uint32_t max_iterations) noexcept {
+    stats.iterations = 0;
+    stats.escaped_pixels = 0;
+    stats.interior_pixels = 0;
+    stats.late_escaped_pixels = 0;
+    stats.max_escape_iterations = 0;
+    const std::uint32_t late = max_iterations / 2;
+    for (std::uint32_t y = 0; y < pixels.height(); ++y) {
+        std::uint64_t interior = 0;
+        std::uint64_t late_escaped = 0;
+        for (const auto iterations : pixels[y]) {
+            stats.iterations += iterations;
+            const bool inside = iterations >= max_iterations;
+            interior += inside ? 1 : 0;
+            late_escaped += !inside && iterations >= late ? 1 : 0;
+            stats.max_escape_iterations = std::max(stats.max_escape_iterations, inside ? 0 : iterations);
+        }
+        stats.interior_pixels += interior;
+        stats.escaped_pixels += pixels.width() - interior;
+        stats.late_escaped_pixels += late_escaped;
+    }
+}
+
+// Есть ли у кадра статистика: у превью и пустых кадров её нет
+[[nodiscard]] inline bool HasRenderStats(const RenderResult &frame) noexcept {
+    return !frame.pixel_data.empty() && frame.stats.escaped_pixels + frame.stats.interior_pixels != 0;
+}
+
+// Время плиток кадра: минимум, среднее и максимум; нули, если плиток нет
+struct TileTimeSummary {
+    std::chrono::nanoseconds min{};
+    std::chrono::nanoseconds mean{};
+    std::chrono::nanoseconds max{};
+};
+
+[[nodiscard]] inline TileTimeSummary SummarizeTiles(const RenderStats &stats) noexcept {
+    if (stats.tiles.empty()) {
+        return {};
+    }
+    TileTimeSummary summary{.min = stats.tiles.front().time, .mean = {}, .max = stats.tiles.front().time};
+    std::chrono::nanoseconds total{};
+    for (const auto &tile : stats.tiles) {
+        summary.min = std::min(summary.min, tile.time);
+        summary.max = std::max(summary.max, tile.time);
+        total += tile.time;
+    }
+    summary.mean = total / static_cast<std::int64_t>(stats.tiles.size());
+    return summary;
+}
+
+// Дисбаланс нагрузки: отношение самой занятой задачи к средней; 1 — нагрузка равномерная, 0 — нет данных
+[[nodiscard]] inline double WorkerImbalance(const RenderStats &stats) noexcept {
+    if (stats.worker_busy.empty()) {
+        return 0.0;
+    }
+    std::chrono::nanoseconds total{};
+    std::chrono::nanoseconds busiest{};
+    for (const auto busy : stats.worker_busy) {
+        total += busy;
+        busiest = std::max(busiest, busy);
+    }
+    if (total.count() == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(busiest.count()) * static_cast<double>(stats.worker_busy.size()) /
+           static_cast<double>(total.count());
+}
+
+namespace detail {
+
+[[nodiscard]] inline double Microseconds(std::chrono::nanoseconds time) noexcept {
+    return std::chrono::duration<double, std::micro>{time}.count();
+}
+
+[[nodiscard]] inline double Milliseconds(std::chrono::nanoseconds time) noexcept {
+    return std::chrono::duration<double, std::milli>{time}.count();
+}
+
+}  // namespace detail
+
+// Статистика кадра одной строкой JSON без перевода строки. Время плиток и задач — в микросекундах;
+// отдельные плитки не выводятся, только сводка.
+[[nodiscard]] inline std::string RenderStatsJson(const RenderResult &frame) {
+    const auto &stats = frame.stats;
+    const auto tiles = SummarizeTiles(stats);
+    std::string busy;
+    for (const auto time : stats.worker_busy) {
+        busy += std::format("{}{:.1f}", busy.empty() ? "" : ",", detail::Microseconds(time));
+    }
+    const auto viewport = mandelbrot::Flattened(frame.viewport);
+    return std::format(
+        R"({{"width":{},"height":{},"max_iterations":{},"viewport":[{},{},{},{}],"render_ms":{},)"
+        R"("iterations":{},"escaped_pixels":{},"interior_pixels":{},"reused_pixels":{},"supersampled_pixels":{},)"
+        R"("tiles":{},"tile_us":{{"min":{:.1f},"mean":{:.1f},"max":{:.1f}}},)"
+        R"("worker_busy_us":[{}],"imbalance":{:.3f}}})",
+        frame.settings.width, frame.settings.height, frame.settings.max_iterations, viewport.x_min, viewport.x_max,
+        viewport.y_min, viewport.y_max, frame.render_time.count(), stats.iterations, stats.escaped_pixels,
+        stats.interior_pixels, stats.reused_pixels, stats.supersampled_pixels, stats.tiles.size(),
+        detail::Microseconds(tiles.min), detail::Microseconds(tiles.mean), detail::Microseconds(tiles.max), busy,
+        WorkerImbalance(stats));
+}
+
+// Статистика кадра для оверлея: несколько коротких строк
+[[nodiscard]] inline std::string FormatRenderStats(const RenderResult &frame) {
+    const auto &stats = frame.stats;
+    const auto tiles = SummarizeTiles(stats);
+    const double pixels = std::max<double>(1.0, static_cast<double>(frame.settings.width) * frame.settings.height);
+    std::string text = std::format("render {} ms, {:.1f}M iterations\n", frame.render_time.count(),
+                                   static_cast<double>(stats.iterations) / 1e6);
+    text += std::format("escaped {:.1f}%, interior {:.1f}%, reused {:.1f}%\n", 100.0 * stats.escaped_pixels / pixels,
+                        100.0 * stats.interior_pixels / pixels, 100.0 * stats.reused_pixels / pixels);
+    if (stats.supersampled_pixels > 0) {
+        text += std::format("supersampled {:.1f}%\n", 100.0 * stats.supersampled_pixels / pixels);
+    }
+    if (!stats.tiles.empty()) {
+        text += std::format("tiles {}: {:.2f} / {:.2f} / {:.2f} ms\n", stats.tiles.size(),
+                            detail::Milliseconds(tiles.min), detail::Milliseconds(tiles.mean),
+                            detail::Milliseconds(tiles.max));
+    }
+    if (!stats.worker_busy.empty()) {
+        text += "workers";
+        for (const auto time : stats.worker_busy) {
+            text += std::format(" {:.1f}", detail::Milliseconds(time));
+        }
+        text += std::format(" ms, imbalance {:.2f}\n", WorkerImbalance(stats));
+    }
+    return text;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdexec/execution.hpp>
+
+// Проверка отмены рендеринга. Операция прерывается по токену окружения получателя (внешняя отмена или
+// соседний рабочий в when_all, завершившийся set_stopped) либо по токену кадра, который MandelbrotRenderer
+// запрашивает, когда новый вид вытесняет ещё не готовый кадр. Пустой frame_token отмену не запрашивает.
+template <typename Receiver>
+[[nodiscard]] bool StopRequested(const Receiver &receiver, const stdexec::inplace_stop_token &frame_token) noexcept {
+    return frame_token.stop_requested() || stdexec::get_stop_token(stdexec::get_env(receiver)).stop_requested();
+}
+
+template <typename Receiver>
+[[nodiscard]] bool StopRequested(const Receiver &receiver) noexcept {
+    return StopRequested(receiver, stdexec::inplace_stop_token{});
+}
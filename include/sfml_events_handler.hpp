@@ -3,6 +3,7 @@
 #include <SFML/Graphics.hpp>
 #include <stdexec/execution.hpp>
 
+#include "tile_cache.hpp"
 #include "types.hpp"
 
 class SfmlEventHandler {
@@ -16,6 +17,9 @@ public:
         sf::Clock &zoom_clock_;
 
         static constexpr float ZOOM_INTERVAL_MS = 100.0f;
+        static constexpr int PAN_STEP_PIXELS = 40;
+        // Шаг сдвига палитры клавишами [ и ], в итерациях
+        static constexpr std::uint32_t COLOR_OFFSET_STEP = 4;
 
         template <typename R>
         explicit OperationState(R &&r, sf::RenderWindow &window, RenderSettings render_settings, AppState &state,
@@ -65,7 +69,36 @@ public:
                         state_.should_exit = true;
                     } else if (event.key.code == sf::Keyboard::R) {
                         // Сброс к начальному виду
-                        state_.viewport = mandelbrot::ViewPort{-2.5, 1.5, -2.0, 2.0};
+                        state_.viewport = SnapToTileGrid(mandelbrot::ViewPort{-2.5, 1.5, -2.0, 2.0},
+                                                         render_settings_.width, render_settings_.height);
+                        state_.need_rerender = true;
+                    } else if (event.key.code == sf::Keyboard::Left) {
+                        Pan(-PAN_STEP_PIXELS, 0);
+                    } else if (event.key.code == sf::Keyboard::Right) {
+                        Pan(PAN_STEP_PIXELS, 0);
+                    } else if (event.key.code == sf::Keyboard::Up) {
+                        Pan(0, -PAN_STEP_PIXELS);
+                    } else if (event.key.code == sf::Keyboard::Down) {
+                        Pan(0, PAN_STEP_PIXELS);
+                    } else if (event.key.code == sf::Keyboard::P) {
+                        NextPalette();
+                    } else if (event.key.code == sf::Keyboard::M) {
+                        ToggleColoringMode();
+                    } else if (event.key.code == sf::Keyboard::LBracket) {
+                        state_.coloring.cycle_offset -= COLOR_OFFSET_STEP;
+                        state_.need_recolor = true;
+                    } else if (event.key.code == sf::Keyboard::RBracket) {
+                        state_.coloring.cycle_offset += COLOR_OFFSET_STEP;
+                        state_.need_recolor = true;
+                    } else if (event.key.code == sf::Keyboard::I) {
+                        state_.show_stats = !state_.show_stats;
+                    } else if (event.key.code == sf::Keyboard::J) {
+                        state_.dump_stats = true;
+                    } else if (event.key.code == sf::Keyboard::A) {
+                        state_.auto_iterations = !state_.auto_iterations;
+                        state_.need_rerender = true;
+                    } else if (event.key.code == sf::Keyboard::S) {
+                        state_.supersampling = !state_.supersampling;
                         state_.need_rerender = true;
                     }
                     break;
@@ -105,6 +138,44 @@ public:
             state_.viewport.x_max = target_x + new_width / 2.0;
             state_.viewport.y_min = target_y - new_height / 2.0;
             state_.viewport.y_max = target_y + new_height / 2.0;
+            // Вид выравнивается по сетке кэша плиток (сдвиг меньше пикселя): при возврате к прежнему масштабу
+            // рендерер берёт готовые плитки. Глубоко в приближении центр переносится в повышенную точность.
+            state_.viewport = mandelbrot::Rebased(
+                SnapToTileGrid(state_.viewport, render_settings_.width, render_settings_.height));
+            state_.need_rerender = true;
+        }
+
+        void ToggleColoringMode() {
+            state_.coloring.mode =
+                state_.coloring.mode == ColoringMode::NORMALIZED ? ColoringMode::CYCLIC : ColoringMode::NORMALIZED;
+            state_.need_recolor = true;
+        }
+
+        // Смена палитры по кругу: RAINBOW → FIRE → GRAYSCALE
+        void NextPalette() {
+            switch (state_.coloring.palette) {
+            case PaletteKind::RAINBOW:
+                state_.coloring.palette = PaletteKind::FIRE;
+                break;
+            case PaletteKind::FIRE:
+                state_.coloring.palette = PaletteKind::GRAYSCALE;
+                break;
+            case PaletteKind::GRAYSCALE:
+                state_.coloring.palette = PaletteKind::RAINBOW;
+                break;
+            }
+            state_.need_recolor = true;
+        }
+
+        // Сдвиг ровно на целое число пикселей: рендерер переносит готовые пиксели и считает только новые полосы
+        void Pan(int pixels_x, int pixels_y) {
+            const double dx = pixels_x * (state_.viewport.width() / render_settings_.width);
+            const double dy = pixels_y * (state_.viewport.height() / render_settings_.height);
+            state_.viewport.x_min += dx;
+            state_.viewport.x_max += dx;
+            state_.viewport.y_min += dy;
+            state_.viewport.y_max += dy;
+            state_.viewport = mandelbrot::Rebased(state_.viewport);
             state_.need_rerender = true;
         }
     };
@@ -133,3 +204,8 @@ private:
     AppState &state_;
     sf::Clock &zoom_clock_;
 };
+
+namespace stdexec {
+template <>
+inline constexpr bool enable_sender<SfmlEventHandler> = true;
+}
@@ -1,45 +1,66 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include <stdexcept>
 #include <stdexec/execution.hpp>
 
+#include "render_stop.hpp"
+#include "stats_overlay.hpp"
 #include "types.hpp"
 
+// Буфер цветов кадра уже лежит подряд в формате RGBA8 (см. RgbColor) и загружается в текстуру одним
+// вызовом sf::Texture::update, без промежуточного sf::Image и попиксельного setPixel.
+static_assert(sizeof(mandelbrot::RgbColor) == 4 * sizeof(sf::Uint8));
+
 class SFMLRender {
 public:
     template <typename Receiver>
     struct OperationState {
         Receiver receiver_;
         RenderResult render_result_;
-        sf::Image &image_;
         sf::Texture &texture_;
         sf::Sprite &sprite_;
         sf::RenderWindow &window_;
         RenderSettings render_settings_;
+        StatsOverlay *overlay_;
 
         template <typename R>
-        explicit OperationState(R &&r, RenderResult render_result, sf::Image &image, sf::Texture &texture,
-                                sf::Sprite &sprite, sf::RenderWindow &window, RenderSettings render_settings)
-            : receiver_{std::forward<R>(r)}, render_result_{std::move(render_result)}, image_{image}, texture_{texture},
-              sprite_{sprite}, window_{window}, render_settings_{render_settings} {}
+        explicit OperationState(R &&r, RenderResult render_result, sf::Texture &texture, sf::Sprite &sprite,
+                                sf::RenderWindow &window, RenderSettings render_settings, StatsOverlay *overlay)
+            : receiver_{std::forward<R>(r)}, render_result_{std::move(render_result)}, texture_{texture},
+              sprite_{sprite}, window_{window}, render_settings_{render_settings}, overlay_{overlay} {}
 
         void start() noexcept {
+            // Кадр устаревшего вида не выводим
+            if (StopRequested(receiver_)) {
+                stdexec::set_stopped(std::move(receiver_));
+                return;
+            }
+
             try {
-                // Обновляем изображение с результатами рендеринга
-                for (std::uint32_t y = 0; y < render_result_.color_data.size(); ++y) {
-                    for (std::uint32_t x = 0; x < render_result_.color_data[y].size(); ++x) {
-                        const auto &color = render_result_.color_data[y][x];
-                        image_.setPixel(x, y, sf::Color{color.r, color.g, color.b});
+                // Загружаем цвета кадра в текстуру напрямую; кадр другого размера пересоздаёт текстуру.
+                // Кадр пониженного разрешения (см. dynamic_resolution.hpp) растягивается на окно.
+                const auto &colors = render_result_.color_data;
+                if (!colors.empty()) {
+                    const auto size = texture_.getSize();
+                    const bool resized = size.x != colors.width() || size.y != colors.height();
+                    if (resized && !texture_.create(colors.width(), colors.height())) {
+                        throw std::runtime_error{"Failed to create texture"};
                     }
+                    texture_.update(reinterpret_cast<const sf::Uint8 *>(colors.data()), colors.width(), colors.height(),
+                                    0, 0);
+                    sprite_.setTexture(texture_, resized);
+                    sprite_.setScale(static_cast<float>(render_settings_.width) / colors.width(),
+                                     static_cast<float>(render_settings_.height) / colors.height());
                 }
 
-                // Обновляем текстуру и спрайт
-                texture_.update(image_);
-                sprite_.setTexture(texture_);
-
-                // Очищаем окно и отрисовываем спрайт
+                // Очищаем окно и отрисовываем спрайт и статистику кадра поверх него
                 window_.clear(sf::Color::Black);
                 window_.draw(sprite_);
+                if (overlay_ != nullptr) {
+                    overlay_->Update(window_, render_result_);
+                    overlay_->Draw(window_);
+                }
                 window_.display();
 
                 // Отправляем сигнал о завершении рендеринга
@@ -51,20 +72,21 @@ public:
     };
 
     RenderResult render_result_;
-    sf::Image &image_;
     sf::Texture &texture_;
     sf::Sprite &sprite_;
     sf::RenderWindow &window_;
     RenderSettings render_settings_;
+    // Необязательный оверлей статистики кадра
+    StatsOverlay *overlay_;
 
     using completion_signatures =
         stdexec::completion_signatures<stdexec::set_value_t(), stdexec::set_error_t(std::exception_ptr),
                                        stdexec::set_stopped_t()>;
 
-    SFMLRender(RenderResult render_result, sf::Image &image, sf::Texture &texture, sf::Sprite &sprite,
-               sf::RenderWindow &window, RenderSettings render_settings)
-        : render_result_(std::move(render_result)), image_{image}, texture_{texture}, sprite_{sprite}, window_{window},
-          render_settings_{render_settings} {}
+    SFMLRender(RenderResult render_result, sf::Texture &texture, sf::Sprite &sprite, sf::RenderWindow &window,
+               RenderSettings render_settings, StatsOverlay *overlay = nullptr)
+        : render_result_(std::move(render_result)), texture_{texture}, sprite_{sprite}, window_{window},
+          render_settings_{render_settings}, overlay_{overlay} {}
 
     template <typename Env>
     auto get_completion_signatures(Env) const -> completion_signatures {
@@ -74,6 +96,12 @@ public:
     template <typename Receiver>
     auto connect(Receiver &&r) {
         return OperationState<std::decay_t<Receiver>>{
-            std::forward<Receiver>(r), std::move(render_result_), image_, texture_, sprite_, window_, render_settings_};
+            std::forward<Receiver>(r), std::move(render_result_), texture_, sprite_, window_, render_settings_,
+            overlay_};
     }
 };
+
+namespace stdexec {
+template <>
+inline constexpr bool enable_sender<SFMLRender> = true;
+}
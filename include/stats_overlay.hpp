@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <string>
+
+#include <SFML/Graphics.hpp>
+
+#include "render_stats.hpp"
+#include "types.hpp"
+
+// Оверлей со статистикой последнего показанного кадра (см. FormatRenderStats) в левом верхнем углу окна.
+// Шрифт ищется среди системных; без шрифта первая строка статистики выводится в заголовок окна.
+class StatsOverlay {
+public:
+    StatsOverlay() {
+        for (const char *path : FONT_PATHS) {
+            if (font_.loadFromFile(path)) {
+                has_font_ = true;
+                break;
+            }
+        }
+        text_.setFont(font_);
+        text_.setCharacterSize(CHARACTER_SIZE);
+        text_.setFillColor(sf::Color::White);
+        text_.setPosition(PADDING, PADDING);
+        background_.setFillColor(sf::Color{0, 0, 0, 160});
+        background_.setPosition(0.0f, 0.0f);
+    }
+
+    StatsOverlay(const StatsOverlay &) = delete;
+    StatsOverlay &operator=(const StatsOverlay &) = delete;
+
+    [[nodiscard]] bool Visible() const noexcept { return visible_; }
+
+    void SetVisible(sf::RenderWindow &window, bool visible) {
+        visible_ = visible;
+        if (!has_font_) {
+            window.setTitle(visible_ && !title_.empty() ? std::string{WINDOW_TITLE} + " | " + title_ : WINDOW_TITLE);
+        }
+    }
+
+    // Запоминает статистику кадра frame; кадры без статистики (превью) её не меняют
+    void Update(sf::RenderWindow &window, const RenderResult &frame) {
+        if (!HasRenderStats(frame)) {
+            return;
+        }
+        const std::string text = FormatRenderStats(frame);
+        title_ = text.substr(0, text.find('\n'));
+        text_.setString(text);
+        const auto bounds = text_.getLocalBounds();
+        background_.setSize(
+            sf::Vector2f{bounds.left + bounds.width + 2 * PADDING, bounds.top + bounds.height + 2 * PADDING});
+        SetVisible(window, visible_);
+    }
+
+    // Рисует оверлей поверх кадра, если он включён и шрифт найден
+    void Draw(sf::RenderWindow &window) const {
+        if (visible_ && has_font_) {
+            window.draw(background_);
+            window.draw(text_);
+        }
+    }
+
+    static constexpr const char *WINDOW_TITLE = "Mandelbrot Fractal";
+
+private:
+    static constexpr unsigned CHARACTER_SIZE = 14;
+    static constexpr float PADDING = 6.0f;
+    static constexpr std::array FONT_PATHS{
+        "/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf",
+        "/usr/share/fonts/dejavu/DejaVuSansMono.ttf",
+        "/usr/share/fonts/TTF/DejaVuSansMono.ttf",
+        "/System/Library/Fonts/Menlo.ttc",
+        "C:/Windows/Fonts/consola.ttf",
+    };
+
+    sf::Font font_;
+    bool has_font_{false};
+    bool visible_{false};
+    sf::Text text_;
+    sf::RectangleShape background_;
+    std::string title_;
+};
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <span>
+
+#include "double_double.hpp"
+#include "mandelbrot_fractal_utils.hpp"
+#include "mandelbrot_simd.hpp"
+#include "palette.hpp"
+#include "types.hpp"
+
+// Адаптивное сглаживание: кадр считается одной выборкой на пиксель, затем пиксели, итерации которых отличаются
+// от соседних по стороне больше чем на порог (граница множества, резкие переходы палитры), пересчитываются
+// сеткой grid x grid выборок со случайным сдвигом внутри каждой ячейки. Однородные области, то есть
+// большая часть кадра, не пересчитываются. Цвета выборок усредняются в линейном пространстве: среднее
+// значений sRGB затемняет тонкие светлые нити на тёмном фоне. Меняются только цвета, итерации кадра остаются
+// в одну выборку на пиксель.
+
+// Наибольшая сторона сетки выборок: 64 выборки на пиксель
+const constexpr std::uint32_t SUPERSAMPLING_MAX_GRID{8};
+// Выборок в одном вызове ядра: выборки нескольких пикселей считаются одним векторным проходом
+const constexpr std::uint32_t SUPERSAMPLING_BATCH{256};
+static_assert(SUPERSAMPLING_BATCH >= SUPERSAMPLING_MAX_GRID * SUPERSAMPLING_MAX_GRID);
+
+// Сторона сетки выборок по настройкам: 1 — сглаживание выключено
+[[nodiscard]] constexpr std::uint32_t SupersamplingGrid(const SupersamplingSettings &settings) noexcept {
+    return std::clamp<std::uint32_t>(settings.grid, 1, SUPERSAMPLING_MAX_GRID);
+}
+
+// Сглаживается ли кадр: сглаживание включено, кадр раскрашивается и считается в double или double-double.
+// Метод возмущений считает точки относительно опорной орбиты и отдельные выборки не поддерживает.
+[[nodiscard]] inline bool SupersamplingApplies(const RenderSettings &settings,
+                                               mandelbrot::Precision precision) noexcept {
+    return SupersamplingGrid(settings.supersampling) > 1 && settings.colorize &&
+           precision != mandelbrot::Precision::PERTURBATION;
+}
+
+// Яркость канала sRGB в линейном пространстве, [0, 1]
+[[nodiscard]] inline float SrgbToLinear(std::uint8_t value) noexcept {
+    static const auto table = [] {
+        std::array<float, 256> result{};
+        for (std::size_t i = 0; i < result.size(); ++i) {
+            const double srgb = static_cast<double>(i) / 255.0;
+            result[i] = static_cast<float>(srgb <= 0.04045 ? srgb / 12.92 : std::pow((srgb + 0.055) / 1.055, 2.4));
+        }
+        return result;
+    }();
+    return table[value];
+}
+
+// Обратное преобразование с округлением; значения вне [0, 1] обрезаются
+[[nodiscard]] inline std::uint8_t LinearToSrgb(float value) noexcept {
+    const double linear = std::clamp(static_cast<double>(value), 0.0, 1.0);
+    const double srgb = linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+    return static_cast<std::uint8_t>(std::lround(srgb * 255.0));
+}
+
+// Среднее цветов в линейном пространстве; альфа-канал непрозрачный
+[[nodiscard]] inline mandelbrot::RgbColor AverageColors(std::span<const mandelbrot::RgbColor> colors) noexcept {
+    float r = 0.0F;
+    float g = 0.0F;
+    float b = 0.0F;
+    for (const auto &color : colors) {
+        r += SrgbToLinear(color.r);
+        g += SrgbToLinear(color.g);
+        b += SrgbToLinear(color.b);
+    }
+    const float scale = colors.empty() ? 0.0F : 1.0F / static_cast<float>(colors.size());
+    return mandelbrot::RgbColor{LinearToSrgb(r * scale), LinearToSrgb(g * scale), LinearToSrgb(b * scale)};
+}
+
+// Отличаются ли итерации пикселя x, y от соседа по стороне больше чем на threshold. Соседи за краем pixels
+// не учитываются.
+[[nodiscard]] inline bool IsEdgePixel(const FrameView<const std::uint32_t> &pixels, std::uint32_t x, std::uint32_t y,
+                                      std::uint32_t threshold) noexcept {
+    const std::uint32_t center = pixels(x, y);
+    auto differs = [center, threshold](std::uint32_t neighbour) {
+        return (center > neighbour ? center - neighbour : neighbour - center) > threshold;
+    };
+    return (x > 0 && differs(pixels(x - 1, y))) || (x + 1 < pixels.width() && differs(pixels(x + 1, y))) ||
+           (y > 0 && differs(pixels(x, y - 1))) || (y + 1 < pixels.height() && differs(pixels(x, y + 1)));
+}
+
+// Положение выборки внутри пикселя, [0, 1) по каждой оси
+struct SampleOffset {
+    double x{0.0};
+    double y{0.0};
+};
+
+// Выборка sample пикселя x, y: ячейка sample сетки grid x grid плюс псевдослучайный сдвиг внутри ячейки.
+// Сдвиг зависит только от пикселя и номера выборки, поэтому одинаковые кадры сглаживаются одинаково,
+// а соседние пиксели не повторяют один и тот же узор.
+[[nodiscard]] constexpr SampleOffset JitteredSampleOffset(std::uint32_t x, std::uint32_t y, std::uint32_t sample,
+                                                          std::uint32_t grid) noexcept {
+    // Перемешивание splitmix64: младшие и старшие 32 бита дают независимые сдвиги по осям
+    std::uint64_t hash = ((std::uint64_t{x} << 32) | y) * 0x9E3779B97F4A7C15ULL + sample * 0xBF58476D1CE4E5B9ULL;
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+    hash ^= hash >> 31;
+    const double jitter_x = static_cast<double>(hash & 0xFFFFFFFFULL) * 0x1p-32;
+    const double jitter_y = static_cast<double>(hash >> 32) * 0x1p-32;
+    return SampleOffset{.x = (sample % grid + jitter_x) / grid, .y = (sample / grid + jitter_y) / grid};
+}
+
+// Сглаживание областей кадра вида viewport: итерации pixels читаются, цвета пикселей-границ в colors
+// перезаписываются. Плитки кадра можно обрабатывать параллельно: каждая задача пишет только цвета своих
+// пикселей, а границы определяются по итерациям, которые этап не меняет.
+class AdaptiveSupersampler {
+public:
+    AdaptiveSupersampler(const mandelbrot::ViewPort &viewport, const RenderSettings &settings,
+                         mandelbrot::Precision precision, FrameView<const std::uint32_t> pixels,
+                         ColorView colors) noexcept
+        : viewport_{viewport}, settings_{settings}, precision_{precision}, pixels_{pixels}, colors_{colors} {}
+
+    // Сглаживает пиксели-границы области region; возвращает их число
+    std::uint64_t Render(const PixelRegion &region) const {
+        const std::uint32_t grid = SupersamplingGrid(settings_.supersampling);
+        const std::uint32_t samples = grid * grid;
+        const std::uint32_t batch_pixels = SUPERSAMPLING_BATCH / samples;
+
+        std::array<std::uint32_t, SUPERSAMPLING_BATCH> edge_x{};
+        std::array<std::uint32_t, SUPERSAMPLING_BATCH> edge_y{};
+        std::uint32_t pending = 0;
+        std::uint64_t supersampled = 0;
+        for (std::uint32_t y = region.start_row; y < region.end_row; ++y) {
+            for (std::uint32_t x = region.start_col; x < region.end_col; ++x) {
+                if (!IsEdgePixel(pixels_, x, y, settings_.supersampling.threshold)) {
+                    continue;
+                }
+                edge_x[pending] = x;
+                edge_y[pending] = y;
+                if (++pending == batch_pixels) {
+                    RenderBatch(std::span{edge_x}.first(pending), std::span{edge_y}.first(pending), grid);
+                    supersampled += pending;
+                    pending = 0;
+                }
+            }
+        }
+        if (pending > 0) {
+            RenderBatch(std::span{edge_x}.first(pending), std::span{edge_y}.first(pending), grid);
+            supersampled += pending;
+        }
+        return supersampled;
+    }
+
+private:
+    // Дробные координаты выборки sample пикселя x, y в кадре
+    [[nodiscard]] static SampleOffset SamplePosition(std::uint32_t x, std::uint32_t y, std::uint32_t sample,
+                                                     std::uint32_t grid) noexcept {
+        const auto offset = JitteredSampleOffset(x, y, sample, grid);
+        return SampleOffset{.x = x + offset.x, .y = y + offset.y};
+    }
+
+    // Выборки пикселей xs[i], ys[i] одним вызовом ядра, затем средние цвета пикселей
+    void RenderBatch(std::span<const std::uint32_t> xs, std::span<const std::uint32_t> ys,
+                     std::uint32_t grid) const {
+        const std::uint32_t samples = grid * grid;
+        const auto count = static_cast<std::uint32_t>(xs.size()) * samples;
+        std::array<std::uint32_t, SUPERSAMPLING_BATCH> iterations{};
+        const auto batch_iterations = std::span{iterations}.first(count);
+
+        if (precision_ == mandelbrot::Precision::DOUBLE_DOUBLE) {
+            std::array<mandelbrot::DoubleDoubleComplex, SUPERSAMPLING_BATCH> points{};
+            for (std::uint32_t i = 0; i < count; ++i) {
+                const auto [x, y] = SamplePosition(xs[i / samples], ys[i / samples], i % samples, grid);
+                points[i] = mandelbrot::Subpixel2DToDoubleDouble(x, y, viewport_, settings_.width, settings_.height);
+            }
+            mandelbrot::simd::CalculateIterations(std::span{points}.first(count), batch_iterations,
+                                                  settings_.max_iterations, settings_.escape_radius);
+        } else {
+            std::array<mandelbrot::Complex, SUPERSAMPLING_BATCH> points{};
+            for (std::uint32_t i = 0; i < count; ++i) {
+                const auto [x, y] = SamplePosition(xs[i / samples], ys[i / samples], i % samples, grid);
+                points[i] = mandelbrot::Subpixel2DToComplex(x, y, viewport_, settings_.width, settings_.height);
+            }
+            mandelbrot::simd::CalculateIterations(std::span{points}.first(count), batch_iterations,
+                                                  settings_.max_iterations, settings_.escape_radius,
+                                                  settings_.interior_checks);
+        }
+
+        const auto &palette = mandelbrot::CachedPalette(settings_);
+        std::array<mandelbrot::RgbColor, SUPERSAMPLING_MAX_GRID * SUPERSAMPLING_MAX_GRID> colors{};
+        for (std::size_t pixel = 0; pixel < xs.size(); ++pixel) {
+            for (std::uint32_t sample = 0; sample < samples; ++sample) {
+                colors[sample] = palette[iterations[pixel * samples + sample]];
+            }
+            colors_(xs[pixel], ys[pixel]) = AverageColors(std::span{colors}.first(samples));
+        }
+    }
+
+    mandelbrot::ViewPort viewport_;
+    RenderSettings settings_;
+    mandelbrot::Precision precision_;
+    FrameView<const std::uint32_t> pixels_;
+    ColorView colors_;
+};
@@ -0,0 +1,425 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "frame_reuse.hpp"
+#include "mandelbrot_fractal_utils.hpp"
+#include "types.hpp"
+
+// Кэш плиток итераций на глобальной сетке пикселей. Шаг пикселя квантуется по уровням масштаба
+// (TILE_CACHE_LEVEL_STEPS уровней на удвоение), на каждом уровне плоскость делится на плитки
+// TILE_CACHE_TILE_SIZE x TILE_CACHE_TILE_SIZE, привязанные к началу координат. Кадр, чьи пиксели лежат
+// на узлах сетки (см. PlaceOnTileGrid), берёт уже посчитанные плитки из кэша вместо пересчёта:
+// возврат к исходному виду, отдаление и обратное приближение, сдвиги.
+
+// Сторона плитки кэша в пикселях
+const constexpr std::uint32_t TILE_CACHE_TILE_SIZE{64};
+// Уровней масштаба на каждое удвоение шага пикселя
+const constexpr double TILE_CACHE_LEVEL_STEPS{1 << 20};
+// Память кэша по умолчанию
+const constexpr std::size_t TILE_CACHE_DEFAULT_BYTES{256 * 1024 * 1024};
+
+struct TileKey {
+    // Уровни масштаба по осям: пиксели кадра могут быть не квадратными
+    std::int64_t level_x{0};
+    std::int64_t level_y{0};
+    std::int64_t col{0};
+    std::int64_t row{0};
+    std::uint32_t max_iterations{0};
+    double escape_radius{0.0};
+    // Проверки внутренних точек: периодичность с другим допуском иначе классифицирует точки у границы
+    bool cardioid_bulb{false};
+    bool periodicity{false};
+    double periodicity_tolerance{0.0};
+
+    friend bool operator==(const TileKey &, const TileKey &) = default;
+};
+
+struct TileKeyHash {
+    [[nodiscard]] std::size_t operator()(const TileKey &key) const noexcept {
+        std::size_t hash = 0;
+        auto mix = [&hash](std::uint64_t value) {
+            hash ^= std::hash<std::uint64_t>{}(value) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+        };
+        mix(static_cast<std::uint64_t>(key.level_x));
+        mix(static_cast<std::uint64_t>(key.level_y));
+        mix(static_cast<std::uint64_t>(key.col));
+        mix(static_cast<std::uint64_t>(key.row));
+        mix(key.max_iterations);
+        mix(std::bit_cast<std::uint64_t>(key.escape_radius));
+        mix((key.cardioid_bulb ? 1u : 0u) | (key.periodicity ? 2u : 0u));
+        mix(std::bit_cast<std::uint64_t>(key.periodicity_tolerance));
+        return hash;
+    }
+};
+
+// Уровень масштаба шага пикселя spacing и шаг уровня
+[[nodiscard]] inline std::int64_t TileLevel(double spacing) noexcept {
+    return std::llround(std::log2(spacing) * TILE_CACHE_LEVEL_STEPS);
+}
+
+[[nodiscard]] inline double TileLevelSpacing(std::int64_t level) noexcept {
+    return std::exp2(static_cast<double>(level) / TILE_CACHE_LEVEL_STEPS);
+}
+
+// Положение кадра на глобальной сетке: пиксель (x, y) кадра — глобальный пиксель (x0 + x, y0 + y)
+struct TileGridPlacement {
+    std::int64_t level_x{0};
+    std::int64_t level_y{0};
+    std::int64_t x0{0};
+    std::int64_t y0{0};
+};
+
+// Положение кадра на сетке, если каждый его пиксель совпадает с узлом сетки с точностью
+// FRAME_REUSE_TOLERANCE пикселя; иначе std::nullopt. Кадры с ненулевым origin (глубокое приближение) не кэшируются.
+[[nodiscard]] inline std::optional<TileGridPlacement> PlaceOnTileGrid(const mandelbrot::ViewPort &viewport,
+                                                                      const RenderSettings &settings) noexcept {
+    if (settings.width == 0 || settings.height == 0 || !(viewport.width() > 0.0) || !(viewport.height() > 0.0) ||
+        viewport.origin != mandelbrot::FixedPointComplex{}) {
+        return std::nullopt;
+    }
+
+    // Углы кадра в глобальных пикселях должны быть целыми, а расстояние между ними — равно размеру кадра
+    auto place = [](double min, double max, std::uint32_t size, std::int64_t level) -> std::optional<std::int64_t> {
+        const double spacing = TileLevelSpacing(level);
+        const double first = min / spacing;
+        const double last = max / spacing;
+        const double rounded = std::round(first);
+        if (!(std::abs(rounded) < 0x1p52) || std::abs(first - rounded) > FRAME_REUSE_TOLERANCE ||
+            std::abs(last - (rounded + size)) > FRAME_REUSE_TOLERANCE) {
+            return std::nullopt;
+        }
+        return static_cast<std::int64_t>(rounded);
+    };
+
+    const auto level_x = TileLevel(viewport.width() / settings.width);
+    const auto level_y = TileLevel(viewport.height() / settings.height);
+    const auto x0 = place(viewport.x_min, viewport.x_max, settings.width, level_x);
+    const auto y0 = place(viewport.y_min, viewport.y_max, settings.height, level_y);
+    if (!x0 || !y0) {
+        return std::nullopt;
+    }
+    return TileGridPlacement{.level_x = level_x, .level_y = level_y, .x0 = *x0, .y0 = *y0};
+}
+
+// Ближайший к viewport вид, пиксели которого лежат на узлах сетки: шаг — ближайший уровень, угол — ближайший
+// узел. Вид сдвигается меньше чем на пиксель, масштаб меняется в пределах 1e-6. Вид с ненулевым origin
+// возвращается без изменений.
+[[nodiscard]] inline mandelbrot::ViewPort SnapToTileGrid(const mandelbrot::ViewPort &viewport, std::uint32_t width,
+                                                         std::uint32_t height) noexcept {
+    if (width == 0 || height == 0 || !(viewport.width() > 0.0) || !(viewport.height() > 0.0) ||
+        viewport.origin != mandelbrot::FixedPointComplex{}) {
+        return viewport;
+    }
+    const double spacing_x = TileLevelSpacing(TileLevel(viewport.width() / width));
+    const double spacing_y = TileLevelSpacing(TileLevel(viewport.height() / height));
+    const double x_min = std::round(viewport.x_min / spacing_x) * spacing_x;
+    const double y_min = std::round(viewport.y_min / spacing_y) * spacing_y;
+    return mandelbrot::ViewPort{
+        .x_min = x_min, .x_max = x_min + width * spacing_x, .y_min = y_min, .y_max = y_min + height * spacing_y};
+}
+
+struct TileCacheStats {
+    std::uint64_t hits{0};
+    // Попадания, поднятые с диска (входят в hits)
+    std::uint64_t disk_hits{0};
+    std::uint64_t misses{0};
+    std::uint64_t evictions{0};
+    std::size_t tiles{0};
+    std::size_t bytes{0};
+};
+
+// LRU-кэш плиток итераций с ограничением памяти и необязательным вторым уровнем на диске: вытесненные
+// из памяти плитки записываются в каталог и поднимаются обратно при следующем обращении.
+// Потокобезопасен.
+class TileCache {
+public:
+    explicit TileCache(std::size_t max_bytes = TILE_CACHE_DEFAULT_BYTES) : max_bytes_{max_bytes} {}
+
+    TileCache(const TileCache &) = delete;
+    TileCache &operator=(const TileCache &) = delete;
+
+    static constexpr std::size_t TILE_BYTES = std::size_t{TILE_CACHE_TILE_SIZE} * TILE_CACHE_TILE_SIZE * 4;
+
+    // Ограничение памяти; лишние плитки вытесняются сразу. Меньше одной плитки (например, 0) — кэш выключен:
+    // плитки не сохраняются и не ищутся
+    void SetMaxBytes(std::size_t max_bytes) {
+        const std::lock_guard lock{mutex_};
+        max_bytes_ = max_bytes;
+        if (!EnabledLocked()) {
+            entries_.clear();
+            index_.clear();
+            return;
+        }
+        EvictLocked();
+    }
+
+    // Включает второй уровень в каталоге directory не больше max_bytes; 0 — выключает
+    void EnableSpill(const std::filesystem::path &directory, std::size_t max_bytes) {
+        const std::lock_guard lock{mutex_};
+        std::filesystem::create_directories(directory);
+        spill_directory_ = directory;
+        spill_max_bytes_ = max_bytes;
+        TrimSpillLocked();
+    }
+
+    [[nodiscard]] TileCacheStats Stats() const {
+        const std::lock_guard lock{mutex_};
+        TileCacheStats stats = stats_;
+        stats.tiles = entries_.size();
+        stats.bytes = entries_.size() * TILE_BYTES;
+        return stats;
+    }
+
+    void Clear() {
+        const std::lock_guard lock{mutex_};
+        entries_.clear();
+        index_.clear();
+    }
+
+    // Есть ли в памяти или на диске хотя бы одна плитка, целиком лежащая в кадре
+    [[nodiscard]] bool ContainsAny(const TileGridPlacement &placement, const RenderSettings &settings) const {
+        const std::lock_guard lock{mutex_};
+        if (!EnabledLocked()) {
+            return false;
+        }
+        bool found = false;
+        ForEachCell(placement, settings.width, settings.height, [&](const PixelRegion &cell, std::int64_t col,
+                                                                     std::int64_t row) {
+            const auto key = Key(placement, settings, col, row);
+            found = found || (IsFull(cell) && (index_.contains(key) || spilled_.contains(key)));
+        });
+        return found;
+    }
+
+    // Копирует в кадр frame найденные плитки, целиком лежащие в regions, и заменяет regions оставшимися
+    // для вычисления частями (пересечениями с ячейками сетки). Возвращает число найденных плиток.
+    std::size_t Fill(const TileGridPlacement &placement, const RenderSettings &settings, const PixelView &frame,
+                     std::vector<PixelRegion> &regions) {
+        const std::lock_guard lock{mutex_};
+        if (!EnabledLocked()) {
+            return 0;
+        }
+        std::vector<PixelRegion> remaining;
+        std::size_t found = 0;
+        ForEachCell(placement, settings.width, settings.height, [&](const PixelRegion &cell, std::int64_t col,
+                                                                     std::int64_t row) {
+            const bool inside = IsFull(cell) && std::ranges::any_of(regions, [&cell](const PixelRegion &region) {
+                                    return Contains(region, cell);
+                                });
+            if (inside) {
+                if (const auto *tile = FindLocked(Key(placement, settings, col, row))) {
+                    CopyTile(*tile, frame.SubView(cell));
+                    ++found;
+                    return;
+                }
+                ++stats_.misses;
+            }
+            for (const auto &region : regions) {
+                if (const auto piece = Intersect(region, cell)) {
+                    remaining.push_back(*piece);
+                }
+            }
+        });
+        regions = std::move(remaining);
+        return found;
+    }
+
+    // Сохраняет все плитки, целиком лежащие в кадре frame
+    void Store(const TileGridPlacement &placement, const RenderSettings &settings,
+               const FrameView<const std::uint32_t> &frame) {
+        const std::lock_guard lock{mutex_};
+        if (!EnabledLocked()) {
+            return;
+        }
+        ForEachCell(placement, settings.width, settings.height, [&](const PixelRegion &cell, std::int64_t col,
+                                                                     std::int64_t row) {
+            if (!IsFull(cell)) {
+                return;
+            }
+            const auto key = Key(placement, settings, col, row);
+            if (const auto it = index_.find(key); it != index_.end()) {
+                entries_.splice(entries_.begin(), entries_, it->second);
+                return;
+            }
+            std::vector<std::uint32_t> pixels(std::size_t{TILE_CACHE_TILE_SIZE} * TILE_CACHE_TILE_SIZE);
+            const auto source = frame.SubView(cell);
+            for (std::uint32_t y = 0; y < TILE_CACHE_TILE_SIZE; ++y) {
+                std::ranges::copy(source[y], pixels.begin() + std::size_t{y} * TILE_CACHE_TILE_SIZE);
+            }
+            InsertLocked(key, std::move(pixels));
+        });
+    }
+
+private:
+    struct Entry {
+        TileKey key;
+        std::vector<std::uint32_t> pixels;
+    };
+
+    [[nodiscard]] bool EnabledLocked() const noexcept { return max_bytes_ >= TILE_BYTES; }
+
+    [[nodiscard]] static TileKey Key(const TileGridPlacement &placement, const RenderSettings &settings,
+                                     std::int64_t col, std::int64_t row) noexcept {
+        return TileKey{.level_x = placement.level_x,
+                       .level_y = placement.level_y,
+                       .col = col,
+                       .row = row,
+                       .max_iterations = settings.max_iterations,
+                       .escape_radius = settings.escape_radius,
+                       .cardioid_bulb = settings.interior_checks.cardioid_bulb,
+                       .periodicity = settings.interior_checks.periodicity,
+                       .periodicity_tolerance = settings.interior_checks.periodicity_tolerance};
+    }
+
+    [[nodiscard]] static std::int64_t FloorDiv(std::int64_t value, std::int64_t divisor) noexcept {
+        return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+    }
+
+    // Вызывает visit(cell, col, row) для всех ячеек сетки, пересекающих кадр; cell — часть ячейки внутри кадра
+    template <typename Visit>
+    static void ForEachCell(const TileGridPlacement &placement, std::uint32_t width, std::uint32_t height,
+                            Visit visit) {
+        constexpr std::int64_t SIZE = TILE_CACHE_TILE_SIZE;
+        if (width == 0 || height == 0) {
+            return;
+        }
+        const auto first_col = FloorDiv(placement.x0, SIZE);
+        const auto last_col = FloorDiv(placement.x0 + width - 1, SIZE);
+        const auto first_row = FloorDiv(placement.y0, SIZE);
+        const auto last_row = FloorDiv(placement.y0 + height - 1, SIZE);
+        for (auto row = first_row; row <= last_row; ++row) {
+            for (auto col = first_col; col <= last_col; ++col) {
+                const auto start_col = std::max<std::int64_t>(col * SIZE - placement.x0, 0);
+                const auto end_col = std::min<std::int64_t>((col + 1) * SIZE - placement.x0, width);
+                const auto start_row = std::max<std::int64_t>(row * SIZE - placement.y0, 0);
+                const auto end_row = std::min<std::int64_t>((row + 1) * SIZE - placement.y0, height);
+                visit(PixelRegion{.start_row = static_cast<std::uint32_t>(start_row),
+                                  .end_row = static_cast<std::uint32_t>(end_row),
+                                  .start_col = static_cast<std::uint32_t>(start_col),
+                                  .end_col = static_cast<std::uint32_t>(end_col)},
+                      col, row);
+            }
+        }
+    }
+
+    [[nodiscard]] static bool IsFull(const PixelRegion &cell) noexcept {
+        return cell.width() == TILE_CACHE_TILE_SIZE && cell.height() == TILE_CACHE_TILE_SIZE;
+    }
+
+    [[nodiscard]] static bool Contains(const PixelRegion &outer, const PixelRegion &inner) noexcept {
+        return outer.start_row <= inner.start_row && inner.end_row <= outer.end_row &&
+               outer.start_col <= inner.start_col && inner.end_col <= outer.end_col;
+    }
+
+    [[nodiscard]] static std::optional<PixelRegion> Intersect(const PixelRegion &a, const PixelRegion &b) noexcept {
+        const PixelRegion result{.start_row = std::max(a.start_row, b.start_row),
+                                 .end_row = std::min(a.end_row, b.end_row),
+                                 .start_col = std::max(a.start_col, b.start_col),
+                                 .end_col = std::min(a.end_col, b.end_col)};
+        if (result.start_row >= result.end_row || result.start_col >= result.end_col) {
+            return std::nullopt;
+        }
+        return result;
+    }
+
+    static void CopyTile(const std::vector<std::uint32_t> &pixels, const PixelView &target) noexcept {
+        for (std::uint32_t y = 0; y < TILE_CACHE_TILE_SIZE; ++y) {
+            const auto row = pixels.begin() + std::size_t{y} * TILE_CACHE_TILE_SIZE;
+            std::copy(row, row + TILE_CACHE_TILE_SIZE, target[y].begin());
+        }
+    }
+
+    // Плитка из памяти или с диска (поднимается в память); nullptr при промахе. Попадание учитывается.
+    [[nodiscard]] const std::vector<std::uint32_t> *FindLocked(const TileKey &key) {
+        if (const auto it = index_.find(key); it != index_.end()) {
+            entries_.splice(entries_.begin(), entries_, it->second);
+            ++stats_.hits;
+            return &it->second->pixels;
+        }
+        if (!spilled_.contains(key)) {
+            return nullptr;
+        }
+        std::vector<std::uint32_t> pixels(std::size_t{TILE_CACHE_TILE_SIZE} * TILE_CACHE_TILE_SIZE);
+        std::ifstream file{SpillPath(key), std::ios::binary};
+        if (!file.read(reinterpret_cast<char *>(pixels.data()), static_cast<std::streamsize>(TILE_BYTES))) {
+            return nullptr;
+        }
+        ++stats_.hits;
+        ++stats_.disk_hits;
+        InsertLocked(key, std::move(pixels));
+        return &entries_.front().pixels;
+    }
+
+    void InsertLocked(const TileKey &key, std::vector<std::uint32_t> pixels) {
+        entries_.push_front(Entry{key, std::move(pixels)});
+        index_[key] = entries_.begin();
+        EvictLocked();
+    }
+
+    // Вытесняет самые давно использованные плитки сверх ограничения памяти; при включённом диске они
+    // записываются туда, если их там ещё нет. Только что вставленная плитка остаётся.
+    void EvictLocked() {
+        while (entries_.size() > 1 && entries_.size() * TILE_BYTES > max_bytes_) {
+            auto &entry = entries_.back();
+            if (spill_max_bytes_ > 0 && !spilled_.contains(entry.key)) {
+                std::ofstream file{SpillPath(entry.key), std::ios::binary | std::ios::trunc};
+                if (file.write(reinterpret_cast<const char *>(entry.pixels.data()),
+                               static_cast<std::streamsize>(TILE_BYTES))) {
+                    spilled_.insert(entry.key);
+                    spill_order_.push_back(entry.key);
+                    TrimSpillLocked();
+                }
+            }
+            index_.erase(entry.key);
+            entries_.pop_back();
+            ++stats_.evictions;
+        }
+    }
+
+    // Удаляет с диска самые старые плитки сверх ограничения
+    void TrimSpillLocked() {
+        while (!spill_order_.empty() && spill_order_.size() * TILE_BYTES > spill_max_bytes_) {
+            std::error_code error;
+            std::filesystem::remove(SpillPath(spill_order_.front()), error);
+            spilled_.erase(spill_order_.front());
+            spill_order_.pop_front();
+        }
+    }
+
+    [[nodiscard]] std::filesystem::path SpillPath(const TileKey &key) const {
+        return spill_directory_ / (std::to_string(key.level_x) + '_' + std::to_string(key.level_y) + '_' +
+                                   std::to_string(key.col) + '_' + std::to_string(key.row) + '_' +
+                                   std::to_string(key.max_iterations) + '_' +
+                                   std::to_string(std::bit_cast<std::uint64_t>(key.escape_radius)) + '_' +
+                                   std::to_string((key.cardioid_bulb ? 1 : 0) | (key.periodicity ? 2 : 0)) + '_' +
+                                   std::to_string(std::bit_cast<std::uint64_t>(key.periodicity_tolerance)) + ".tile");
+    }
+
+    mutable std::mutex mutex_;
+    std::size_t max_bytes_;
+    // Начало списка — последняя использованная плитка
+    std::list<Entry> entries_;
+    std::unordered_map<TileKey, std::list<Entry>::iterator, TileKeyHash> index_;
+    TileCacheStats stats_;
+
+    std::filesystem::path spill_directory_;
+    std::size_t spill_max_bytes_{0};
+    std::unordered_set<TileKey, TileKeyHash> spilled_;
+    std::deque<TileKey> spill_order_;
+};
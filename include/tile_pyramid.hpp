@@ -0,0 +1,291 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include <stdexec/execution.hpp>
+
+#include "fan_out.hpp"
+#include "mandelbrot_renderer.hpp"
+#include "mandelbrot_sender.hpp"
+#include "ppm_writer.hpp"
+#include "types.hpp"
+
+// Пирамида плиток для веб-просмотрщика (раскладка slippy map): на уровне level область делится на
+// 2^level x 2^level плиток по tile_size x tile_size пикселей, плитка x, y лежит в <каталог>/<level>/<x>/<y>.ppm.
+// Готовые плитки отмечаются в манифесте, поэтому прерванная генерация продолжается с того же места.
+
+struct PyramidSpec {
+    // Квадратная область: на всех уровнях пиксели квадратные
+    mandelbrot::ViewPort region;
+    // Уровни 0..levels-1
+    std::uint32_t levels{1};
+    // Сторона плитки в пикселях, чётная: плитка грубого уровня собирается из 2x2 плиток следующего
+    std::uint32_t tile_size{256};
+    // Итерации, радиус, проверки и раскраска; width и height задаются уровнем
+    RenderSettings settings;
+    // true — уровни грубее последнего получаются уменьшением плиток следующего уровня: усреднение 2x2 стоит
+    // несколько операций на пиксель против до max_iterations итераций при рендеринге. false — каждый уровень
+    // рендерится заново.
+    bool derive_coarse_levels{true};
+};
+
+struct PyramidTile {
+    std::uint32_t level{0};
+    std::uint32_t x{0};
+    std::uint32_t y{0};
+
+    friend auto operator<=>(const PyramidTile &, const PyramidTile &) = default;
+};
+
+// Сторона уровня в пикселях; бросает std::invalid_argument, если она не помещается в std::uint32_t
+[[nodiscard]] inline std::uint32_t PyramidLevelSize(const PyramidSpec &spec, std::uint32_t level) {
+    if (level >= 32 || (std::uint64_t{spec.tile_size} << level) > UINT32_MAX) {
+        throw std::invalid_argument{"PyramidLevelSize: level is too deep for the tile size"};
+    }
+    return spec.tile_size << level;
+}
+
+[[nodiscard]] inline std::filesystem::path PyramidTilePath(const std::filesystem::path &directory,
+                                                           const PyramidTile &tile) {
+    return directory / std::to_string(tile.level) / std::to_string(tile.x) / (std::to_string(tile.y) + ".ppm");
+}
+
+// Манифест <каталог>/manifest.txt: заголовок с параметрами пирамиды и строка "tile level x y" на каждую
+// записанную плитку. Строка дописывается после того, как файл плитки записан целиком, поэтому при
+// продолжении генерации отмеченные плитки пропускаются, а недописанные считаются заново.
+class PyramidManifest {
+public:
+    PyramidManifest(const std::filesystem::path &directory, const PyramidSpec &spec)
+        : path_{directory / "manifest.txt"} {
+        const std::string header = Header(spec);
+        if (std::ifstream existing{path_}) {
+            // Продолжение: заголовок должен совпадать, иначе каталог принадлежит другой пирамиде
+            std::string line;
+            std::string existing_header;
+            while (std::getline(existing, line) && line.rfind("tile ", 0) != 0) {
+                existing_header += line + '\n';
+            }
+            if (existing_header != header) {
+                throw std::runtime_error{"PyramidManifest: directory holds a pyramid with other parameters"};
+            }
+            do {
+                std::istringstream fields{line};
+                std::string tag;
+                PyramidTile tile;
+                if (fields >> tag >> tile.level >> tile.x >> tile.y && tag == "tile") {
+                    done_.insert(tile);
+                }
+            } while (std::getline(existing, line));
+        } else {
+            std::filesystem::create_directories(directory);
+            std::ofstream file{path_};
+            file << header;
+            if (!file.flush()) {
+                throw std::runtime_error{"PyramidManifest: cannot write manifest"};
+            }
+        }
+        file_.open(path_, std::ios::app);
+        if (!file_) {
+            throw std::runtime_error{"PyramidManifest: cannot open manifest"};
+        }
+    }
+
+    [[nodiscard]] bool Contains(const PyramidTile &tile) const {
+        const std::lock_guard lock{mutex_};
+        return done_.contains(tile);
+    }
+
+    [[nodiscard]] std::size_t Size() const {
+        const std::lock_guard lock{mutex_};
+        return done_.size();
+    }
+
+    // Отмечает записанную плитку; вызывается из любого потока
+    void Add(const PyramidTile &tile) {
+        const std::lock_guard lock{mutex_};
+        file_ << "tile " << tile.level << ' ' << tile.x << ' ' << tile.y << '\n';
+        if (!file_.flush()) {
+            throw std::runtime_error{"PyramidManifest: cannot write manifest"};
+        }
+        done_.insert(tile);
+    }
+
+private:
+    // Параметры, от которых зависят пиксели плиток; double записываются в шестнадцатеричном виде без потерь
+    [[nodiscard]] static std::string Header(const PyramidSpec &spec) {
+        const auto flat = mandelbrot::Flattened(spec.region);
+        const auto &settings = spec.settings;
+        std::ostringstream header;
+        header << std::hexfloat;
+        header << "mandelbrot-pyramid 1\n"
+               << "region " << flat.x_min << ' ' << flat.x_max << ' ' << flat.y_min << ' ' << flat.y_max << '\n'
+               << "levels " << spec.levels << "\ntile_size " << spec.tile_size << '\n'
+               << "max_iterations " << settings.max_iterations << "\nescape_radius " << settings.escape_radius << '\n'
+               << "coloring " << static_cast<int>(settings.coloring.palette) << ' '
+               << static_cast<int>(settings.coloring.mode) << ' ' << settings.coloring.cycle_offset << '\n'
+               << "interior_checks " << settings.interior_checks.cardioid_bulb << ' '
+               << settings.interior_checks.periodicity << ' ' << settings.interior_checks.periodicity_tolerance << '\n'
+               << "float_kernel " << settings.float_kernel << '\n'
+               << "derive_coarse_levels " << spec.derive_coarse_levels << '\n';
+        return header.str();
+    }
+
+    std::filesystem::path path_;
+    mutable std::mutex mutex_;
+    std::set<PyramidTile> done_;
+    std::ofstream file_;
+};
+
+namespace detail {
+
+// Записывает плитку через временный файл: в каталоге не бывает недописанных плиток
+inline void WritePyramidTile(const std::filesystem::path &directory, const PyramidTile &tile,
+                             const ColorMatrix &colors) {
+    const auto path = PyramidTilePath(directory, tile);
+    std::filesystem::create_directories(path.parent_path());
+    auto temporary = path;
+    temporary += ".tmp";
+    WritePpm(temporary, colors);
+    std::filesystem::rename(temporary, path);
+}
+
+// Рендерит плитку уровня level в собственный буфер
+[[nodiscard]] inline ColorMatrix RenderPyramidTile(const PyramidSpec &spec, const PyramidTile &tile) {
+    const std::uint32_t size = PyramidLevelSize(spec, tile.level);
+    RenderSettings settings = spec.settings;
+    settings.width = size;
+    settings.height = size;
+    settings.colorize = true;
+
+    // Как в MandelbrotRenderer::RenderAsync, но без метода возмущений: плитка считается одним потоком,
+    // и при глубоком приближении координаты остаются в double-double. Пирамиды, которым нужны возмущения,
+    // отклоняет GeneratePyramid
+    auto precision = mandelbrot::SelectPrecision(spec.region, size, size);
+    auto viewport = spec.region;
+    if (precision == mandelbrot::Precision::DOUBLE) {
+        viewport = mandelbrot::Flattened(viewport);
+    } else {
+        precision = mandelbrot::Precision::DOUBLE_DOUBLE;
+    }
+
+    const PixelRegion region{.start_row = tile.y * spec.tile_size,
+                             .end_row = (tile.y + 1) * spec.tile_size,
+                             .start_col = tile.x * spec.tile_size,
+                             .end_col = (tile.x + 1) * spec.tile_size};
+    PixelMatrix pixels(spec.tile_size, spec.tile_size);
+    ColorMatrix colors(spec.tile_size, spec.tile_size);
+    RenderRegion(viewport, settings, region, RenderTarget{pixels.View(), colors.View()}, precision);
+    return colors;
+}
+
+// Собирает плитку из 2x2 плиток следующего уровня усреднением блоков 2x2 пикселей
+[[nodiscard]] inline ColorMatrix DownsamplePyramidTile(const PyramidSpec &spec, const std::filesystem::path &directory,
+                                                       const PyramidTile &tile) {
+    const std::uint32_t half = spec.tile_size / 2;
+    ColorMatrix colors(spec.tile_size, spec.tile_size);
+    for (std::uint32_t child_y = 0; child_y < 2; ++child_y) {
+        for (std::uint32_t child_x = 0; child_x < 2; ++child_x) {
+            const auto child =
+                ReadPpm(PyramidTilePath(directory, {tile.level + 1, 2 * tile.x + child_x, 2 * tile.y + child_y}));
+            if (child.width() != spec.tile_size || child.height() != spec.tile_size) {
+                throw std::runtime_error{"DownsamplePyramidTile: child tile has a wrong size"};
+            }
+            for (std::uint32_t y = 0; y < half; ++y) {
+                const auto top = child[2 * y];
+                const auto bottom = child[2 * y + 1];
+                const auto target = colors[child_y * half + y];
+                for (std::uint32_t x = 0; x < half; ++x) {
+                    auto average = [&](auto channel) {
+                        const std::uint32_t sum = top[2 * x].*channel + top[2 * x + 1].*channel +
+                                                  bottom[2 * x].*channel + bottom[2 * x + 1].*channel;
+                        return static_cast<std::uint8_t>((sum + 2) / 4);
+                    };
+                    target[child_x * half + x] = mandelbrot::RgbColor{
+                        average(&mandelbrot::RgbColor::r), average(&mandelbrot::RgbColor::g),
+                        average(&mandelbrot::RgbColor::b)};
+                }
+            }
+        }
+    }
+    return colors;
+}
+
+}  // namespace detail
+
+// Генерирует пирамиду spec в каталоге directory на пуле renderer, начиная с самого подробного уровня.
+// Плитки уровня разбирают ThreadCount() рабочих задач; в памяти — по одной плитке на задачу.
+// Плитки, уже отмеченные в манифесте, пропускаются. Возвращает число записанных плиток.
+// Первая ошибка ввода-вывода останавливает генерацию и пробрасывается вызывающему.
+// Бросает std::invalid_argument, если самому подробному уровню не хватает точности double-double.
+inline std::uint64_t GeneratePyramid(MandelbrotRenderer &renderer, const PyramidSpec &spec,
+                                     const std::filesystem::path &directory) {
+    if (spec.levels == 0 || spec.tile_size < 2 || spec.tile_size % 2 != 0) {
+        throw std::invalid_argument{"GeneratePyramid: need at least one level and an even tile size"};
+    }
+    const std::uint32_t deepest_size = PyramidLevelSize(spec, spec.levels - 1);
+    if (mandelbrot::SelectPrecision(spec.region, deepest_size, deepest_size) == mandelbrot::Precision::PERTURBATION) {
+        throw std::invalid_argument{"pyramid too deep for double-double"};
+    }
+
+    PyramidManifest manifest{directory, spec};
+    std::atomic<std::uint64_t> written{0};
+
+    for (std::uint32_t level = spec.levels; level-- > 0;) {
+        const bool derived = spec.derive_coarse_levels && level + 1 < spec.levels;
+        const std::uint64_t tiles_per_side = std::uint64_t{1} << level;
+        std::atomic<std::uint64_t> next{0};
+        std::mutex error_mutex;
+        std::exception_ptr error;
+
+        auto work = MakeFanOutSender(
+            renderer.GetScheduler(), renderer.ThreadCount(), [&](std::uint32_t, auto should_stop) noexcept {
+                for (auto index = next.fetch_add(1); index < tiles_per_side * tiles_per_side;
+                     index = next.fetch_add(1)) {
+                    if (should_stop()) {
+                        return false;
+                    }
+                    const PyramidTile tile{level, static_cast<std::uint32_t>(index % tiles_per_side),
+                                           static_cast<std::uint32_t>(index / tiles_per_side)};
+                    if (manifest.Contains(tile)) {
+                        continue;
+                    }
+                    try {
+                        const auto colors = derived ? detail::DownsamplePyramidTile(spec, directory, tile)
+                                                    : detail::RenderPyramidTile(spec, tile);
+                        detail::WritePyramidTile(directory, tile, colors);
+                        manifest.Add(tile);
+                        written.fetch_add(1, std::memory_order_relaxed);
+                    } catch (...) {
+                        // Остальные задачи доходят до конца очереди без работы
+                        next.store(tiles_per_side * tiles_per_side);
+                        const std::lock_guard lock{error_mutex};
+                        if (!error) {
+                            error = std::current_exception();
+                        }
+                        return false;
+                    }
+                }
+                return true;
+            });
+
+        const bool completed = stdexec::sync_wait(std::move(work)).has_value();
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        if (!completed) {
+            throw std::runtime_error{"GeneratePyramid: generation cancelled"};
+        }
+    }
+    return written.load();
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "types.hpp"
+
+// Очередь плиток кадра. Рабочие потоки забирают плитки по одной через атомарный счётчик,
+// поэтому потоки, которым достались быстрые плитки, сразу берут следующие и не простаивают.
+class TileQueue {
+public:
+    TileQueue(std::uint32_t width, std::uint32_t height, std::uint32_t tile_size)
+        : TileQueue{std::vector{PixelRegion{.start_row = 0, .end_row = height, .start_col = 0, .end_col = width}},
+                    tile_size} {}
+
+    // Плитки покрывают только области regions (например, полосы, открывшиеся при сдвиге вида).
+    // Области не должны пересекаться; плитки каждой области отсчитываются от её левого верхнего угла.
+    TileQueue(std::vector<PixelRegion> regions, std::uint32_t tile_size)
+        : tile_size_{std::max<std::uint32_t>(tile_size, 1)}, regions_{std::move(regions)} {
+        first_tiles_.reserve(regions_.size());
+        for (const auto &region : regions_) {
+            first_tiles_.push_back(size_);
+            size_ += TilesX(region) * TilesY(region);
+        }
+    }
+
+    // Перемещение допустимо только до начала раздачи плиток
+    TileQueue(TileQueue &&other) noexcept
+        : tile_size_{other.tile_size_}, regions_{std::move(other.regions_)},
+          first_tiles_{std::move(other.first_tiles_)}, size_{other.size_},
+          next_{other.next_.load(std::memory_order_relaxed)} {}
+
+    TileQueue(const TileQueue &) = delete;
+    TileQueue &operator=(const TileQueue &) = delete;
+    TileQueue &operator=(TileQueue &&) = delete;
+
+    [[nodiscard]] std::uint32_t size() const noexcept { return size_; }
+
+    // Плитка с номером index: области по порядку, внутри области — в порядке строк.
+    // Крайние плитки обрезаются по границе области.
+    [[nodiscard]] PixelRegion Tile(std::uint32_t index) const noexcept {
+        const auto area = static_cast<std::size_t>(std::ranges::upper_bound(first_tiles_, index) -
+                                                   first_tiles_.begin() - 1);
+        const PixelRegion &region = regions_[area];
+        const std::uint32_t local = index - first_tiles_[area];
+        const std::uint32_t tiles_x = TilesX(region);
+
+        const std::uint32_t start_row = region.start_row + (local / tiles_x) * tile_size_;
+        const std::uint32_t start_col = region.start_col + (local % tiles_x) * tile_size_;
+        return PixelRegion{.start_row = start_row,
+                           .end_row = std::min(start_row + tile_size_, region.end_row),
+                           .start_col = start_col,
+                           .end_col = std::min(start_col + tile_size_, region.end_col)};
+    }
+
+    // Следующая невыданная плитка или std::nullopt, если плитки закончились
+    [[nodiscard]] std::optional<PixelRegion> Next() noexcept {
+        const std::uint32_t index = next_.fetch_add(1, std::memory_order_relaxed);
+        if (index >= size()) {
+            return std::nullopt;
+        }
+        return Tile(index);
+    }
+
+private:
+    [[nodiscard]] std::uint32_t TilesX(const PixelRegion &region) const noexcept {
+        return (region.width() + tile_size_ - 1) / tile_size_;
+    }
+    [[nodiscard]] std::uint32_t TilesY(const PixelRegion &region) const noexcept {
+        return (region.height() + tile_size_ - 1) / tile_size_;
+    }
+
+    std::uint32_t tile_size_;
+    std::vector<PixelRegion> regions_;
+    // Номер первой плитки каждой области
+    std::vector<std::uint32_t> first_tiles_;
+    std::uint32_t size_{0};
+    std::atomic<std::uint32_t> next_{0};
+};
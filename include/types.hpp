@@ -1,27 +1,217 @@
 #pragma once
 
+#include <algorithm>
 #include <chrono>
+#include <cstddef>
+#include <span>
 #include <vector>
 
 #include "mandelbrot_fractal_utils.hpp"
 
-const constexpr std::uint32_t THREAD_POOL_SIZE{8};
+// Способ вычисления кадра
+enum class RenderMode {
+    // Каждый пиксель вычисляется независимо
+    BRUTE_FORCE,
+    // Деление прямоугольников с заливкой однородных областей (см. mariani_silver.hpp)
+    MARIANI_SILVER,
+};
+
+// Набор цветов палитры (см. palette.hpp)
+enum class PaletteKind {
+    // Цветовой круг HSV
+    RAINBOW,
+    // Чёрный → красный → жёлтый → белый
+    FIRE,
+    GRAYSCALE,
+};
+
+// Как число итераций переводится в положение на палитре
+enum class ColoringMode {
+    // Палитра растягивается на 0..max_iterations
+    NORMALIZED,
+    // Палитра повторяется каждые PALETTE_CYCLE_LENGTH итераций независимо от max_iterations
+    CYCLIC,
+};
 
-using PixelMatrix = std::vector<std::vector<std::uint32_t>>;
-using ColorMatrix = std::vector<std::vector<mandelbrot::RgbColor>>;
+// Раскраска не влияет на итерации: её смена перекрашивает готовый кадр без пересчёта (см. Recolor)
+struct ColorSettings {
+    PaletteKind palette{PaletteKind::RAINBOW};
+    ColoringMode mode{ColoringMode::NORMALIZED};
+    // Сдвиг палитры в итерациях, может быть отрицательным
+    std::int32_t cycle_offset{0};
+
+    friend bool operator==(const ColorSettings &, const ColorSettings &) = default;
+};
+
+// Адаптивное сглаживание (см. supersampling.hpp): цвета пикселей, итерации которых отличаются от соседних
+// больше чем на threshold, усредняются по grid x grid выборкам. Итерации кадра остаются в одну выборку
+// на пиксель, поэтому перекраска готового кадра (см. Recolor) сглаживание не сохраняет.
+struct SupersamplingSettings {
+    // Сторона сетки выборок; 0 и 1 — сглаживание выключено
+    std::uint32_t grid{0};
+    std::uint32_t threshold{2};
+};
 
 struct RenderSettings {
     std::uint32_t width{800};
     std::uint32_t height{600};
     std::uint32_t max_iterations{100};
     double escape_radius{2.0};
+    // Сторона квадратной плитки, на которые делится кадр при параллельном рендеринге
+    std::uint32_t tile_size{64};
+    // Быстрые проверки внутренних точек; отключаются по отдельности для A/B сравнения
+    mandelbrot::InteriorChecks interior_checks{.cardioid_bulb = true, .periodicity = true};
+    // Ядро одинарной точности для неглубоких видов (см. UseFloatKernel); отключается для A/B сравнения
+    bool float_kernel{true};
+    RenderMode mode{RenderMode::BRUTE_FORCE};
+    ColorSettings coloring{};
+    // false — кадр содержит только итерации: ColorMatrix не выделяется и не раскрашивается
+    bool colorize{true};
+    SupersamplingSettings supersampling{};
 };
 
+// Считать ли вид viewport ядром одинарной точности: вдвое больше дорожек SIMD при том же результате
+[[nodiscard]] inline bool UseFloatKernel(const mandelbrot::ViewPort &viewport,
+                                         const RenderSettings &settings) noexcept {
+    return settings.float_kernel &&
+           mandelbrot::FloatPrecisionSuffices(viewport, settings.width, settings.height, settings.max_iterations);
+}
+
 struct PixelRegion {
     std::uint32_t start_row{};
     std::uint32_t end_row{};
     std::uint32_t start_col{};
     std::uint32_t end_col{};
+
+    [[nodiscard]] constexpr std::uint32_t width() const noexcept { return end_col - start_col; }
+    [[nodiscard]] constexpr std::uint32_t height() const noexcept { return end_row - start_row; }
+};
+
+// Невладеющее представление прямоугольной области кадра.
+// Строки лежат в памяти с шагом stride элементов, поэтому представление
+// подобласти ссылается на память родительского буфера без копирования.
+template <typename T>
+class FrameView {
+public:
+    FrameView() = default;
+    FrameView(T *data, std::uint32_t width, std::uint32_t height, std::size_t stride) noexcept
+        : data_{data}, width_{width}, height_{height}, stride_{stride} {}
+
+    [[nodiscard]] T *data() const noexcept { return data_; }
+    [[nodiscard]] std::uint32_t width() const noexcept { return width_; }
+    [[nodiscard]] std::uint32_t height() const noexcept { return height_; }
+    [[nodiscard]] std::size_t stride() const noexcept { return stride_; }
+
+    // Количество строк, как у контейнера строк
+    [[nodiscard]] std::size_t size() const noexcept { return height_; }
+    [[nodiscard]] bool empty() const noexcept { return width_ == 0 || height_ == 0; }
+
+    [[nodiscard]] std::span<T> operator[](std::size_t y) const noexcept { return {data_ + y * stride_, width_}; }
+    [[nodiscard]] T &operator()(std::uint32_t x, std::uint32_t y) const noexcept { return data_[y * stride_ + x]; }
+
+    // Представление подобласти; координаты region задаются относительно текущего представления
+    [[nodiscard]] FrameView SubView(const PixelRegion &region) const noexcept {
+        return FrameView{data_ + region.start_row * stride_ + region.start_col, region.width(), region.height(),
+                         stride_};
+    }
+
+private:
+    T *data_{nullptr};
+    std::uint32_t width_{0};
+    std::uint32_t height_{0};
+    std::size_t stride_{0};
+};
+
+// Владеющий буфер кадра: одна непрерывная аллокация на весь кадр вместо аллокации на каждую строку.
+template <typename T>
+class FrameBuffer {
+public:
+    FrameBuffer() = default;
+    FrameBuffer(std::uint32_t width, std::uint32_t height, const T &value = T{})
+        : width_{width}, height_{height}, data_(static_cast<std::size_t>(width) * height, value) {}
+
+    [[nodiscard]] T *data() noexcept { return data_.data(); }
+    [[nodiscard]] const T *data() const noexcept { return data_.data(); }
+    [[nodiscard]] std::uint32_t width() const noexcept { return width_; }
+    [[nodiscard]] std::uint32_t height() const noexcept { return height_; }
+    [[nodiscard]] std::size_t stride() const noexcept { return width_; }
+
+    // Количество строк, как у контейнера строк
+    [[nodiscard]] std::size_t size() const noexcept { return height_; }
+    [[nodiscard]] bool empty() const noexcept { return data_.empty(); }
+
+    [[nodiscard]] std::span<T> operator[](std::size_t y) noexcept { return {data_.data() + y * width_, width_}; }
+    [[nodiscard]] std::span<const T> operator[](std::size_t y) const noexcept {
+        return {data_.data() + y * width_, width_};
+    }
+
+    [[nodiscard]] FrameView<T> View() noexcept { return FrameView<T>{data_.data(), width_, height_, width_}; }
+    [[nodiscard]] FrameView<const T> View() const noexcept {
+        return FrameView<const T>{data_.data(), width_, height_, width_};
+    }
+    [[nodiscard]] FrameView<T> View(const PixelRegion &region) noexcept { return View().SubView(region); }
+    [[nodiscard]] FrameView<const T> View(const PixelRegion &region) const noexcept { return View().SubView(region); }
+
+    // Оставляет строки [start_row, end_row) в той же аллокации
+    void KeepRows(std::uint32_t start_row, std::uint32_t end_row) noexcept {
+        std::move(data_.begin() + static_cast<std::ptrdiff_t>(stride() * start_row),
+                  data_.begin() + static_cast<std::ptrdiff_t>(stride() * end_row), data_.begin());
+        data_.resize(stride() * (end_row - start_row));
+        height_ = end_row - start_row;
+    }
+
+private:
+    std::uint32_t width_{0};
+    std::uint32_t height_{0};
+    std::vector<T> data_;
+};
+
+using PixelMatrix = FrameBuffer<std::uint32_t>;
+using ColorMatrix = FrameBuffer<mandelbrot::RgbColor>;
+
+using PixelView = FrameView<std::uint32_t>;
+using ColorView = FrameView<mandelbrot::RgbColor>;
+
+// Место назначения для результатов вычисления области: представления общего буфера кадра.
+// Пустой colors — записываются только итерации, раскраска выполняется отдельным этапом (см. colorize.hpp).
+struct RenderTarget {
+    PixelView pixels;
+    ColorView colors;
+
+    [[nodiscard]] bool HasColors() const noexcept { return colors.data() != nullptr; }
+
+    // Представления подобласти; координаты region задаются относительно начала target
+    [[nodiscard]] RenderTarget SubView(const PixelRegion &region) const noexcept {
+        return RenderTarget{pixels.SubView(region), HasColors() ? colors.SubView(region) : ColorView{}};
+    }
+};
+
+// Время вычисления одной плитки кадра рабочей задачей worker
+struct TileStats {
+    PixelRegion region;
+    std::uint32_t worker{0};
+    std::chrono::nanoseconds time{};
+};
+
+// Статистика рендеринга кадра (см. render_stats.hpp)
+struct RenderStats {
+    // Посчитанные плитки и время занятости каждой рабочей задачи (итерации, раскраска и сглаживание). Пусты,
+    // если кадр считался без общей очереди плиток: методом Мариани-Сильвера или методом возмущений.
+    std::vector<TileStats> tiles;
+    std::vector<std::chrono::nanoseconds> worker_busy;
+    // Сумма итераций по пикселям кадра
+    std::uint64_t iterations{0};
+    // Пиксели, убежавшие до max_iterations, и пиксели множества
+    std::uint64_t escaped_pixels{0};
+    std::uint64_t interior_pixels{0};
+    // Гистограмма убегания: пиксели, убежавшие во второй половине лимита (не раньше max_iterations / 2),
+    // и наибольшее число итераций среди убежавших (см. auto_iterations.hpp)
+    std::uint64_t late_escaped_pixels{0};
+    std::uint32_t max_escape_iterations{0};
+    // Пиксели, перенесённые из прошлого кадра или взятые из кэша плиток без вычисления
+    std::uint64_t reused_pixels{0};
+    // Пиксели, цвета которых усреднены адаптивным сглаживанием
+    std::uint64_t supersampled_pixels{0};
 };
 
 struct RenderResult {
@@ -29,12 +219,24 @@ struct RenderResult {
     ColorMatrix color_data;
     mandelbrot::ViewPort viewport;
     RenderSettings settings;
+    // Время от запуска рендеринга кадра до готовых итераций и цветов
     std::chrono::milliseconds render_time{};
+    RenderStats stats{};
 };
 
 struct AppState {
     mandelbrot::ViewPort viewport;
     bool need_rerender{true};
+    // Раскраска, выбранная с клавиатуры; её смена перекрашивает показанный кадр без пересчёта
+    ColorSettings coloring{};
+    bool need_recolor{false};
+    // Оверлей статистики кадра (клавиша I) и запрос строки JSON со статистикой (клавиша J)
+    bool show_stats{false};
+    bool dump_stats{false};
+    // Автоматический лимит итераций (клавиша A, см. auto_iterations.hpp); выключен — лимит постоянный
+    bool auto_iterations{false};
+    // Адаптивное сглаживание кадров полного разрешения (клавиша S)
+    bool supersampling{false};
     bool left_mouse_pressed{false};
     bool right_mouse_pressed{false};
     bool should_exit{false};
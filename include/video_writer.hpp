@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+#include "types.hpp"
+
+// Потоковая запись кадров анимации в файл или стандартный вывод: кадры дописываются по одному,
+// поэтому в памяти не нужно держать всю анимацию. Результат передаётся кодировщику, например:
+//   MandelbrotFractal_batch ... | ffmpeg -i - zoom.mp4
+// Ошибки ввода-вывода и кадры другого размера бросают std::runtime_error.
+
+enum class VideoFormat {
+    // YUV4MPEG2 (Y4M) 4:4:4 в полном диапазоне: заголовок с размером и частотой кадров, понимают ffmpeg и mpv
+    Y4M,
+    // Кадры RGB8 подряд без заголовков: ffmpeg -f rawvideo -pix_fmt rgb24 -video_size WxH -framerate FPS -i -
+    RAW_RGB,
+};
+
+// Цвет в Y'CbCr по BT.601 в полном диапазоне (как JPEG), целочисленно с точностью 1/65536
+struct YCbCr {
+    std::uint8_t y{};
+    std::uint8_t cb{};
+    std::uint8_t cr{};
+};
+
+[[nodiscard]] constexpr YCbCr RgbToYCbCr(const mandelbrot::RgbColor &color) noexcept {
+    const std::int32_t r = color.r;
+    const std::int32_t g = color.g;
+    const std::int32_t b = color.b;
+    constexpr std::int32_t HALF = 1 << 15;
+    constexpr std::int32_t CHROMA_ZERO = 128 << 16;
+    auto channel = [](std::int32_t value) { return static_cast<std::uint8_t>(std::clamp(value >> 16, 0, 255)); };
+    return YCbCr{.y = channel(19595 * r + 38470 * g + 7471 * b + HALF),
+                 .cb = channel(-11059 * r - 21709 * g + 32768 * b + CHROMA_ZERO + HALF),
+                 .cr = channel(32768 * r - 27439 * g - 5329 * b + CHROMA_ZERO + HALF)};
+}
+
+class VideoWriter {
+public:
+    // path "-" — стандартный вывод; fps записывается в заголовок Y4M
+    VideoWriter(const std::filesystem::path &path, VideoFormat format, std::uint32_t width, std::uint32_t height,
+                std::uint32_t fps)
+        : format_{format}, width_{width}, height_{height}, frame_(3 * std::size_t{width} * height) {
+        if (path == "-") {
+            output_ = &std::cout;
+        } else {
+            file_.open(path, std::ios::binary | std::ios::trunc);
+            if (!file_) {
+                throw std::runtime_error{std::format("VideoWriter: cannot open {}", path.string())};
+            }
+            output_ = &file_;
+        }
+        if (format_ == VideoFormat::Y4M) {
+            *output_ << std::format("YUV4MPEG2 W{} H{} F{}:1 Ip A1:1 C444 XCOLORRANGE=FULL\n", width, height, fps);
+        }
+        Check();
+    }
+
+    [[nodiscard]] std::uint32_t FramesWritten() const noexcept { return frames_written_; }
+
+    // Дописывает кадр colors; альфа-канал отбрасывается
+    void WriteFrame(const ColorMatrix &colors) {
+        if (colors.width() != width_ || colors.height() != height_) {
+            throw std::runtime_error{std::format("VideoWriter: frame {}x{} does not match video {}x{}",
+                                                 colors.width(), colors.height(), width_, height_)};
+        }
+        const std::size_t pixels = std::size_t{width_} * height_;
+        for (std::uint32_t y = 0; y < height_; ++y) {
+            const auto source = colors[y];
+            const std::size_t row = std::size_t{y} * width_;
+            for (std::uint32_t x = 0; x < width_; ++x) {
+                if (format_ == VideoFormat::Y4M) {
+                    // Плоскости Y, Cb и Cr друг за другом
+                    const auto color = RgbToYCbCr(source[x]);
+                    frame_[row + x] = static_cast<char>(color.y);
+                    frame_[pixels + row + x] = static_cast<char>(color.cb);
+                    frame_[2 * pixels + row + x] = static_cast<char>(color.cr);
+                } else {
+                    frame_[3 * (row + x)] = static_cast<char>(source[x].r);
+                    frame_[3 * (row + x) + 1] = static_cast<char>(source[x].g);
+                    frame_[3 * (row + x) + 2] = static_cast<char>(source[x].b);
+                }
+            }
+        }
+        if (format_ == VideoFormat::Y4M) {
+            *output_ << "FRAME\n";
+        }
+        output_->write(frame_.data(), static_cast<std::streamsize>(frame_.size()));
+        Check();
+        ++frames_written_;
+    }
+
+    // Завершает поток: дописывает буферы в файл или стандартный вывод
+    void Close() {
+        output_->flush();
+        if (file_.is_open()) {
+            file_.close();
+        }
+        Check();
+    }
+
+private:
+    void Check() const {
+        if (output_->fail() || file_.fail()) {
+            throw std::runtime_error{"VideoWriter: write failed"};
+        }
+    }
+
+    VideoFormat format_;
+    std::uint32_t width_;
+    std::uint32_t height_;
+    std::uint32_t frames_written_{0};
+    std::ofstream file_;
+    std::ostream *output_{nullptr};
+    // Кадр в формате потока для записи одним вызовом
+    std::vector<char> frame_;
+};
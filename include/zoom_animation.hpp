@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <stdexec/execution.hpp>
+
+#include "auto_iterations.hpp"
+#include "mandelbrot_renderer.hpp"
+#include "types.hpp"
+#include "zoom_path.hpp"
+
+// Рендеринг анимации приближения без окна: несколько кадров пути считаются на пуле рендерера одновременно
+// (FrameKind::INDEPENDENT), а готовые кадры по порядку уходят на запись в вызывающем потоке, пока пул
+// считает следующие (см. RenderZoomAnimation).
+
+// Кадров в работе по умолчанию: пока дописываются последние плитки одного кадра, потоки заняты следующими
+const constexpr std::uint32_t ANIMATION_FRAMES_IN_FLIGHT{3};
+
+struct AnimationSettings {
+    // Размер кадра, лимит итераций, режим и раскраска каждого кадра
+    RenderSettings settings;
+    // true — лимит растёт с глубиной кадра (см. DepthIterations), но не опускается ниже settings.max_iterations
+    bool auto_iterations{false};
+    // Кадров, которые считаются одновременно; в памяти их на один больше (кадр, который записывается)
+    std::uint32_t frames_in_flight{ANIMATION_FRAMES_IN_FLIGHT};
+};
+
+struct AnimationFrame {
+    mandelbrot::ViewPort viewport;
+    RenderSettings settings;
+};
+
+// Вид и настройки кадра frame пути path
+[[nodiscard]] inline AnimationFrame MakeAnimationFrame(const ZoomPath &path, const AnimationSettings &animation,
+                                                       std::uint32_t frame) {
+    const auto view = path.At(frame);
+    AnimationFrame result{
+        .viewport = CenteredViewPort(view.center, view.span, animation.settings.width, animation.settings.height),
+        .settings = animation.settings};
+    result.settings.colorize = true;
+    if (animation.auto_iterations) {
+        const AutoIterationSettings depth{.min_iterations = animation.settings.max_iterations};
+        result.settings.max_iterations =
+            std::max(animation.settings.max_iterations, DepthIterations(depth, result.viewport));
+    }
+    return result;
+}
+
+// Рендеринг всех кадров пути path на пуле renderer. До animation.frames_in_flight кадров считаются одновременно;
+// готовые кадры по порядку передаются в sink(const RenderResult &frame, std::uint32_t index) в вызывающем
+// потоке, и следующий кадр запускается до вызова sink, поэтому запись идёт параллельно с вычислением.
+// Ошибки рендеринга и sink пробрасываются вызывающему после завершения уже запущенных кадров.
+template <typename Sink>
+void RenderZoomAnimation(MandelbrotRenderer &renderer, const ZoomPath &path, const AnimationSettings &animation,
+                         Sink sink) {
+    const std::uint32_t frames = path.FrameCount();
+    const std::uint32_t in_flight = std::clamp<std::uint32_t>(animation.frames_in_flight, 1, frames);
+
+    // Кадр index считается в слоте index % in_flight; слот освобождается, когда кадр забирают на запись
+    struct Slot {
+        std::optional<RenderResult> frame;
+        std::exception_ptr error;
+        bool done{false};
+    };
+    std::vector<Slot> slots(in_flight);
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::uint32_t launched = 0;
+    std::uint32_t completed = 0;
+
+    // Уведомление под блокировкой: после последнего кадра функция возвращается, и переменная условия
+    // не должна использоваться после этого
+    auto complete = [&](std::uint32_t index, std::optional<RenderResult> frame, std::exception_ptr error) {
+        const std::lock_guard lock{mutex};
+        auto &slot = slots[index % in_flight];
+        slot.frame = std::move(frame);
+        slot.error = std::move(error);
+        slot.done = true;
+        ++completed;
+        ready.notify_all();
+    };
+
+    auto launch = [&](std::uint32_t index) {
+        const auto [viewport, settings] = MakeAnimationFrame(path, animation, index);
+        {
+            const std::lock_guard lock{mutex};
+            slots[index % in_flight] = Slot{};
+        }
+        stdexec::start_detached(
+            renderer.RenderAsync(viewport, settings, 0, FrameKind::INDEPENDENT) |
+            stdexec::then([&complete, index](RenderResult frame) { complete(index, std::move(frame), nullptr); }) |
+            stdexec::upon_error([&complete, index](std::exception_ptr error) {
+                complete(index, std::nullopt, std::move(error));
+            }) |
+            stdexec::upon_stopped([&complete, index] {
+                complete(index, std::nullopt,
+                         std::make_exception_ptr(std::runtime_error{"RenderZoomAnimation: render cancelled"}));
+            }));
+        ++launched;
+    };
+
+    try {
+        for (std::uint32_t index = 0; index < in_flight; ++index) {
+            launch(index);
+        }
+        for (std::uint32_t index = 0; index < frames; ++index) {
+            Slot slot;
+            {
+                std::unique_lock lock{mutex};
+                ready.wait(lock, [&] { return slots[index % in_flight].done; });
+                slot = std::move(slots[index % in_flight]);
+            }
+            if (slot.error) {
+                std::rethrow_exception(slot.error);
+            }
+            if (index + in_flight < frames) {
+                launch(index + in_flight);
+            }
+            sink(std::as_const(*slot.frame), index);
+        }
+    } catch (...) {
+        // Запущенные кадры ссылаются на слоты в этой функции: выходить можно только после их завершения
+        std::unique_lock lock{mutex};
+        ready.wait(lock, [&] { return completed == launched; });
+        throw;
+    }
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <istream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "fixed_point.hpp"
+#include "mandelbrot_fractal_utils.hpp"
+
+// Путь приближения для анимации: ключевые кадры задают центр и ширину вида. Между соседними ключевыми кадрами
+// ширина меняется экспоненциально (одинаковый множитель за кадр), а центр движется с постоянной скоростью
+// в пикселях экрана, поэтому приближение выглядит равномерным на любой глубине.
+
+// Вид с центром center (в повышенной точности) и шириной span; высота — по соотношению сторон кадра
+[[nodiscard]] inline mandelbrot::ViewPort CenteredViewPort(const mandelbrot::FixedPointComplex &center, double span,
+                                                           std::uint32_t width, std::uint32_t height) noexcept {
+    const double half_width = span / 2.0;
+    const double half_height = span * height / std::max<std::uint32_t>(width, 1) / 2.0;
+    return mandelbrot::ViewPort{
+        .x_min = -half_width, .x_max = half_width, .y_min = -half_height, .y_max = half_height, .origin = center};
+}
+
+// Вид кадра анимации: центр и ширина
+struct ZoomView {
+    mandelbrot::FixedPointComplex center;
+    double span{4.0};
+};
+
+struct ZoomKeyframe {
+    std::uint32_t frame{0};
+    ZoomView view;
+};
+
+// При |ln(to.span / from.span)| меньше этого ширина почти не меняется, и центр движется линейно
+const constexpr double ZOOM_LINEAR_LOG_RATIO{1e-9};
+
+// Вид на доле t в [0, 1] пути от from к to. При r = to.span / from.span пройденная доля пути центра
+// равна (1 - r^t) / (1 - r): скорость центра пропорциональна ширине вида. Центр отсчитывается от ближнего
+// конца пути, чтобы к концу глубокого приближения погрешность доли не превышала пиксель.
+[[nodiscard]] inline ZoomView InterpolateZoom(const ZoomView &from, const ZoomView &to, double t) noexcept {
+    const double log_ratio = std::log(to.span / from.span);
+    double progress = t;
+    double remaining = 1.0 - t;
+    if (std::abs(log_ratio) > ZOOM_LINEAR_LOG_RATIO) {
+        const double denominator = std::expm1(log_ratio);
+        progress = std::expm1(t * log_ratio) / denominator;
+        remaining = -std::exp(log_ratio) * std::expm1((t - 1.0) * log_ratio) / denominator;
+    }
+
+    const mandelbrot::FixedPoint delta_real = to.center.real - from.center.real;
+    const mandelbrot::FixedPoint delta_imag = to.center.imag - from.center.imag;
+    ZoomView view{.center = {}, .span = from.span * std::exp(t * log_ratio)};
+    if (progress <= 0.5) {
+        view.center.real = from.center.real + delta_real * mandelbrot::FixedPoint{progress};
+        view.center.imag = from.center.imag + delta_imag * mandelbrot::FixedPoint{progress};
+    } else {
+        view.center.real = to.center.real - delta_real * mandelbrot::FixedPoint{remaining};
+        view.center.imag = to.center.imag - delta_imag * mandelbrot::FixedPoint{remaining};
+    }
+    return view;
+}
+
+// Путь из ключевых кадров: кадр 0 — первый ключевой, последний ключевой кадр — последний кадр анимации
+class ZoomPath {
+public:
+    // Ключевые кадры по возрастанию номера, первый — кадр 0, ширины положительные.
+    // Бросает std::invalid_argument, если это не так.
+    explicit ZoomPath(std::vector<ZoomKeyframe> keyframes) : keyframes_{std::move(keyframes)} {
+        if (keyframes_.empty() || keyframes_.front().frame != 0) {
+            throw std::invalid_argument{"ZoomPath: the first keyframe must be frame 0"};
+        }
+        for (std::size_t i = 0; i < keyframes_.size(); ++i) {
+            if (!(keyframes_[i].view.span > 0.0) || !std::isfinite(keyframes_[i].view.span)) {
+                throw std::invalid_argument{std::format("ZoomPath: keyframe {} has a non-positive span", i)};
+            }
+            if (i > 0 && keyframes_[i].frame <= keyframes_[i - 1].frame) {
+                throw std::invalid_argument{std::format("ZoomPath: keyframe {} is not after the previous one", i)};
+            }
+        }
+    }
+
+    // Путь из frames кадров от start до end; один кадр — только start
+    [[nodiscard]] static ZoomPath Between(const ZoomView &start, const ZoomView &end, std::uint32_t frames) {
+        if (frames == 0) {
+            throw std::invalid_argument{"ZoomPath: need at least one frame"};
+        }
+        std::vector<ZoomKeyframe> keyframes{ZoomKeyframe{.frame = 0, .view = start}};
+        if (frames > 1) {
+            keyframes.push_back(ZoomKeyframe{.frame = frames - 1, .view = end});
+        }
+        return ZoomPath{std::move(keyframes)};
+    }
+
+    [[nodiscard]] std::uint32_t FrameCount() const noexcept { return keyframes_.back().frame + 1; }
+
+    [[nodiscard]] const std::vector<ZoomKeyframe> &Keyframes() const noexcept { return keyframes_; }
+
+    // Вид кадра frame; кадры после последнего ключевого совпадают с ним
+    [[nodiscard]] ZoomView At(std::uint32_t frame) const noexcept {
+        const auto next = std::ranges::upper_bound(keyframes_, frame, {}, &ZoomKeyframe::frame);
+        if (next == keyframes_.end()) {
+            return keyframes_.back().view;
+        }
+        const auto &previous = *std::prev(next);
+        const double t =
+            static_cast<double>(frame - previous.frame) / static_cast<double>(next->frame - previous.frame);
+        return InterpolateZoom(previous.view, next->view, t);
+    }
+
+private:
+    std::vector<ZoomKeyframe> keyframes_;
+};
+
+// Читает ключевые кадры: строка "FRAME RE IM SPAN" на кадр, пустые строки и строки с '#' пропускаются.
+// Центр задаётся десятичной записью любой длины (см. FixedPoint::FromString).
+// Бросает std::invalid_argument с номером строки на некорректной строке.
+[[nodiscard]] inline ZoomPath ParseKeyframes(std::istream &input) {
+    std::vector<ZoomKeyframe> keyframes;
+    std::string line;
+    for (std::uint32_t line_number = 1; std::getline(input, line); ++line_number) {
+        std::istringstream fields{line};
+        std::string frame;
+        std::string real;
+        std::string imag;
+        std::string span;
+        if (!(fields >> frame) || frame.starts_with('#')) {
+            continue;
+        }
+        std::string extra;
+        if (!(fields >> real >> imag >> span) || fields >> extra) {
+            throw std::invalid_argument{std::format("keyframes line {}: expected FRAME RE IM SPAN", line_number)};
+        }
+
+        ZoomKeyframe keyframe;
+        auto number = [line_number](const std::string &text, auto &value) {
+            const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+            if (error != std::errc{} || end != text.data() + text.size()) {
+                throw std::invalid_argument{std::format("keyframes line {}: invalid number {}", line_number, text)};
+            }
+        };
+        number(frame, keyframe.frame);
+        number(span, keyframe.view.span);
+        keyframe.view.center.real = mandelbrot::FixedPoint::FromString(real);
+        keyframe.view.center.imag = mandelbrot::FixedPoint::FromString(imag);
+        keyframes.push_back(std::move(keyframe));
+    }
+    return ZoomPath{std::move(keyframes)};
+}
+
+// Читает ключевые кадры из файла path; бросает std::runtime_error, если файл не открывается
+[[nodiscard]] inline ZoomPath ReadKeyframes(const std::filesystem::path &path) {
+    std::ifstream file{path};
+    if (!file) {
+        throw std::runtime_error{std::format("ReadKeyframes: cannot open {}", path.string())};
+    }
+    return ParseKeyframes(file);
+}
@@ -0,0 +1,87 @@
+#include <cstdio>
+#include <exception>
+#include <print>
+#include <string_view>
+#include <vector>
+
+#include "batch_render.hpp"
+#include "mandelbrot_renderer.hpp"
+#include "ppm_writer.hpp"
+#include "render_stats.hpp"
+#include "tile_pyramid.hpp"
+#include "video_writer.hpp"
+#include "zoom_animation.hpp"
+
+// Пакетный рендеринг без окна: изображение считается полосами на пуле и по мере готовности
+// дописывается в PPM, поэтому размер изображения не ограничен объёмом памяти.
+// С --pyramid вместо изображения генерируется пирамида плиток (см. GeneratePyramid),
+// с --frames или --keyframes — анимация приближения потоком Y4M или RGB (см. RenderZoomAnimation).
+int main(int argc, char **argv) {
+    try {
+        const std::vector<std::string_view> args(argv + 1, argv + argc);
+        const auto options = ParseBatchOptions(args);
+        const auto &settings = options.settings;
+        MandelbrotRenderer renderer;
+
+        if (options.pyramid_levels > 0) {
+            const PyramidSpec spec{.region = options.viewport,
+                                   .levels = options.pyramid_levels,
+                                   .tile_size = options.pyramid_tile_size,
+                                   .settings = settings};
+            const auto written = GeneratePyramid(renderer, spec, options.output);
+            std::println(stderr, "written {} tiles to {}", written, options.output.string());
+            return 0;
+        }
+
+        if (options.Animation()) {
+            const auto path = AnimationPath(options);
+            const AnimationSettings animation{.settings = settings,
+                                              .auto_iterations = options.auto_iterations,
+                                              .frames_in_flight = options.frames_in_flight};
+            // Кадры могут идти в stdout: статистика тогда выводится в stderr
+            std::FILE *stats_output = options.output == "-" ? stderr : stdout;
+            VideoWriter writer{options.output, options.video_format, settings.width, settings.height, options.fps};
+            RenderZoomAnimation(renderer, path, animation,
+                                [&writer, &options, &path, stats_output](const RenderResult &frame,
+                                                                         std::uint32_t index) {
+                                    writer.WriteFrame(frame.color_data);
+                                    if (options.stats) {
+                                        std::println(stats_output, "{}", RenderStatsJson(frame));
+                                    }
+                                    std::println(stderr, "frame {} of {}", index + 1, path.FrameCount());
+                                });
+            writer.Close();
+            std::println(stderr, "written {} frames {}x{} to {}", writer.FramesWritten(), settings.width,
+                         settings.height, options.output.string());
+            return 0;
+        }
+
+        const auto band_rows = BandRows(options);
+        PpmWriter writer{options.output, settings.width, settings.height};
+        RenderBands(renderer, options.viewport, settings, band_rows,
+                    [&writer, &settings, &options](const RenderResult &band, std::uint32_t start_row) {
+                        writer.WriteRows(band.color_data);
+                        if (options.stats) {
+                            std::println("{}", RenderStatsJson(band));
+                        }
+                        std::println(stderr, "rows {}..{} of {}", start_row, start_row + band.settings.height,
+                                     settings.height);
+                    });
+        writer.Close();
+        std::println(stderr, "written {}x{} to {}", settings.width, settings.height, options.output.string());
+    } catch (const std::invalid_argument &e) {
+        std::println(stderr, "Error: {}", e.what());
+        std::println(stderr,
+                     "Usage: {} [--size WIDTHxHEIGHT] [--iterations N] [--center RE IM] [--span WIDTH] "
+                     "[--band-rows N] [--mode brute|mariani] [--output PATH] [--pyramid LEVELS] [--tile-size N] "
+                     "[--stats] [--frames N [--zoom-to RE IM SPAN] | --keyframes PATH] [--fps N] "
+                     "[--format y4m|rgb] [--frames-in-flight N] [--auto-iterations] "
+                     "[--supersample GRID [--supersample-threshold N]]",
+                     argc > 0 ? argv[0] : "MandelbrotFractal_batch");
+        return 2;
+    } catch (const std::exception &e) {
+        std::println(stderr, "Error: {}", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -1,5 +1,10 @@
 #include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <optional>
 #include <print>
+#include <string>
 #include <thread>
 #include <utility>
 
@@ -8,10 +13,16 @@
 #include <exec/static_thread_pool.hpp>
 #include <stdexec/execution.hpp>
 
+#include "auto_iterations.hpp"
+#include "colorize.hpp"
+#include "dynamic_resolution.hpp"
+#include "frame_mailbox.hpp"
 #include "mandelbrot.hpp"
 #include "mandelbrot_renderer.hpp"
+#include "render_stats.hpp"
 #include "sfml_events_handler.hpp"
 #include "sfml_renderer.hpp"
+#include "stats_overlay.hpp"
 
 using namespace std::chrono_literals;
 class FrameClock {
@@ -69,153 +80,205 @@ public:
         }
     };
 
-    template <typename Receiver>
-    friend auto tag_invoke(stdexec::connect_t, WaitForFPS &&self, Receiver &&r) {
-        return OperationState<std::decay_t<Receiver>>{std::forward<Receiver>(r), self.frame_clock_, self.target_fps_};
-    }
-
     template <typename Env>
-    friend auto tag_invoke(stdexec::get_completion_signatures_t, const WaitForFPS &, Env) -> completion_signatures {
+    auto get_completion_signatures(Env) const -> completion_signatures {
         return {};
     }
+
+    template <typename Receiver>
+    auto connect(Receiver &&r) {
+        return OperationState<std::decay_t<Receiver>>{std::forward<Receiver>(r), frame_clock_, target_fps_};
+    }
 };
 
+namespace stdexec {
+template <>
+inline constexpr bool enable_sender<WaitForFPS> = true;
+}
+
 class MandelbrotApp {
 private:
-    RenderSettings render_settings_{.width = 800, .height = 600, .max_iterations = 100, .escape_radius = 2.0};
+    static constexpr int TARGET_FPS = 60;
+    // Лимит итераций при выключенном автоматическом подборе
+    static constexpr std::uint32_t FIXED_MAX_ITERATIONS = 100;
+    // Сетка выборок адаптивного сглаживания (клавиша S)
+    static constexpr std::uint32_t SUPERSAMPLING_GRID = 4;
+
+    RenderSettings render_settings_{
+        .width = 800, .height = 600, .max_iterations = FIXED_MAX_ITERATIONS, .escape_radius = 2.0};
 
     sf::RenderWindow window_;
-    sf::Image image_;
     sf::Texture texture_;
     sf::Sprite sprite_;
+    // Пул по числу ядер машины; каждый кадр делится на столько же рабочих задач
     MandelbrotRenderer renderer_;
+    FrameMailbox frames_;
     AppState state_;
+    StatsOverlay overlay_;
+    // Статистика последнего показанного кадра строкой JSON (клавиша J)
+    std::string last_stats_json_;
+    AutoIterationSettings auto_iterations_;
+    // Отклик последнего готового кадра для автоматического лимита итераций
+    std::optional<IterationFeedback> iteration_feedback_;
+    // Текущий рендеринг уточняет показанный кадр с поднятым лимитом итераций
+    bool refining_{false};
+    // Разрешение кадров при зажатой кнопке мыши подбирается так, чтобы кадр успевал за 1/TARGET_FPS
+    ResolutionController resolution_{std::chrono::milliseconds{1000 / TARGET_FPS}};
+    // Делитель разрешения текущего рендеринга
+    std::uint32_t render_divisor_{1};
 
 public:
     MandelbrotApp()
-        : window_{sf::VideoMode{render_settings_.width, render_settings_.height}, "Mandelbrot Fractal"},
-          renderer_{THREAD_POOL_SIZE} {
+        : window_{sf::VideoMode{render_settings_.width, render_settings_.height}, StatsOverlay::WINDOW_TITLE} {
 
-        image_.create(render_settings_.width, render_settings_.height);
         texture_.create(render_settings_.width, render_settings_.height);
+        // Кадры пониженного разрешения растягиваются на окно с билинейной фильтрацией
+        texture_.setSmooth(true);
+        sprite_.setTexture(texture_);
 
         window_.setKeyRepeatEnabled(false);
     }
 
+    // Операции рендеринга, в том числе вытесненные, ссылаются на frames_ и renderer_: дожидаемся их
+    ~MandelbrotApp() {
+        renderer_.CancelFrame();
+        frames_.WaitIdle();
+    }
+
+    MandelbrotApp(const MandelbrotApp &) = delete;
+    MandelbrotApp &operator=(const MandelbrotApp &) = delete;
+
+    // Поток окна не ждёт рендеринг: кадры считаются в пуле, а цикл каждые 1/TARGET_FPS секунды
+    // обрабатывает ввод и показывает последний готовый кадр (или проход прогрессивного рендеринга).
+    // Новый вид запускает рендеринг сразу, вытесняя незаконченный кадр прежнего вида.
     void Run() {
         FrameClock frame_clock;
         sf::Clock zoom_clock;
 
         while (!state_.should_exit) {
-            // Обрабатываем события
-            sf::Event event;
-            while (window_.pollEvent(event)) {
-                switch (event.type) {
-                case sf::Event::Closed:
-                    state_.should_exit = true;
-                    break;
-                case sf::Event::MouseButtonPressed:
-                    if (event.mouseButton.button == sf::Mouse::Left) {
-                        state_.left_mouse_pressed = true;
-                        state_.need_rerender = true;
-                    } else if (event.mouseButton.button == sf::Mouse::Right) {
-                        state_.right_mouse_pressed = true;
-                        state_.need_rerender = true;
-                    }
-                    break;
-                case sf::Event::MouseButtonReleased:
-                    if (event.mouseButton.button == sf::Mouse::Left) {
-                        state_.left_mouse_pressed = false;
-                    } else if (event.mouseButton.button == sf::Mouse::Right) {
-                        state_.right_mouse_pressed = false;
-                    }
-                    break;
-                case sf::Event::KeyPressed:
-                    if (event.key.code == sf::Keyboard::Escape) {
-                        state_.should_exit = true;
-                    } else if (event.key.code == sf::Keyboard::R) {
-                        // Сброс к начальному виду
-                        state_.viewport = mandelbrot::ViewPort{-2.5, 1.5, -2.0, 2.0};
-                        state_.need_rerender = true;
-                    }
-                    break;
-                default:
-                    break;
-                }
-            }
-
-            // Обрабатываем непрерывный зум
-            if ((state_.left_mouse_pressed || state_.right_mouse_pressed) &&
-                zoom_clock.getElapsedTime().asMilliseconds() >= 100.0f) {
-
-                sf::Vector2i mouse_pos = sf::Mouse::getPosition(window_);
+            // Обрабатываем события и непрерывный зум
+            stdexec::sync_wait(SfmlEventHandler{window_, render_settings_, state_, zoom_clock});
 
-                if (mouse_pos.x >= 0 && mouse_pos.x < static_cast<int>(render_settings_.width) && mouse_pos.y >= 0 &&
-                    mouse_pos.y < static_cast<int>(render_settings_.height)) {
-
-                    // Зум к точке
-                    const double target_x =
-                        state_.viewport.x_min +
-                        (static_cast<double>(mouse_pos.x) / render_settings_.width) * state_.viewport.width();
-                    const double target_y =
-                        state_.viewport.y_min +
-                        (static_cast<double>(mouse_pos.y) / render_settings_.height) * state_.viewport.height();
+            // Новая раскраска применяется к последнему кадру сразу, без пересчёта итераций
+            if (state_.need_recolor) {
+                Recolor();
+            }
 
-                    const double zoom_factor = state_.left_mouse_pressed ? 0.8 : 1.25;
-                    const double new_width = state_.viewport.width() * zoom_factor;
-                    const double new_height = state_.viewport.height() * zoom_factor;
+            if (state_.show_stats != overlay_.Visible()) {
+                overlay_.SetVisible(window_, state_.show_stats);
+            }
+            if (state_.dump_stats) {
+                DumpStats();
+            }
 
-                    state_.viewport.x_min = target_x - new_width / 2.0;
-                    state_.viewport.x_max = target_x + new_width / 2.0;
-                    state_.viewport.y_min = target_y - new_height / 2.0;
-                    state_.viewport.y_max = target_y + new_height / 2.0;
-                    state_.need_rerender = true;
+            // Запускаем рендеринг нового вида в фоне: во время зума в пониженном разрешении, после него —
+            // кадр в полном разрешении. Без смены вида — уточнение показанного кадра.
+            const bool interacting = state_.left_mouse_pressed || state_.right_mouse_pressed;
+            if (state_.need_rerender && !state_.should_exit) {
+                StartRender(false, interacting ? resolution_.InteractiveDivisor() : 1);
+            } else if (!interacting && render_divisor_ > 1 && !state_.should_exit) {
+                StartRender(false, 1);
+            } else if (refining_ && !state_.should_exit) {
+                StartRender(true, 1);
+            }
 
-                    zoom_clock.restart();
+            // Показываем готовый кадр, если он пришёл, иначе перерисовываем текущий.
+            // Проход, начатый до смены раскраски, перекрашивается в потоке окна.
+            if (auto frame = frames_.TryTake()) {
+                if (frame->settings.coloring != render_settings_.coloring) {
+                    ::Recolor(*frame, render_settings_.coloring);
                 }
+                if (HasRenderStats(*frame)) {
+                    AdaptIterations(*frame);
+                }
+                Present(std::move(*frame));
+            } else {
+                window_.clear(sf::Color::Black);
+                window_.draw(sprite_);
+                overlay_.Draw(window_);
+                window_.display();
             }
 
-            // Рендерим, если нужно
-            if (state_.need_rerender) {
-                auto render_sender = renderer_.RenderAsync<THREAD_POOL_SIZE>(state_.viewport, render_settings_);
-
-                // Синхронно ждем результат
-                auto result = stdexec::sync_wait(std::move(render_sender));
-                if (result.has_value()) {
-                    auto render_result = std::get<0>(result.value());
-
-                    // Обновляем изображение
-                    for (std::uint32_t y = 0; y < render_result.color_data.size(); ++y) {
-                        for (std::uint32_t x = 0; x < render_result.color_data[y].size(); ++x) {
-                            const auto &color = render_result.color_data[y][x];
-                            image_.setPixel(x, y, sf::Color{color.r, color.g, color.b});
-                        }
-                    }
+            // Ограничиваем FPS
+            stdexec::sync_wait(WaitForFPS{frame_clock, TARGET_FPS});
+        }
+    }
 
-                    // Обновляем текстуру и спрайт
-                    texture_.update(image_);
-                    sprite_.setTexture(texture_);
+private:
+    void Present(RenderResult frame) {
+        if (HasRenderStats(frame)) {
+            last_stats_json_ = RenderStatsJson(frame);
+        }
+        stdexec::sync_wait(SFMLRender{std::move(frame), texture_, sprite_, window_, render_settings_, &overlay_});
+    }
 
-                    state_.need_rerender = false;
-                }
-            }
+    // Строка JSON со статистикой последнего кадра в stdout
+    void DumpStats() {
+        if (!last_stats_json_.empty()) {
+            std::println("{}", last_stats_json_);
+            std::fflush(stdout);
+        }
+        state_.dump_stats = false;
+    }
 
-            // Отрисовываем
-            window_.clear(sf::Color::Black);
-            window_.draw(sprite_);
-            window_.display();
+    // Перекрашенный кадр теряет сглаживание: со сглаживанием вид пересчитывается, итерации берутся из кэша плиток
+    void Recolor() {
+        render_settings_.coloring = state_.coloring;
+        if (auto frame = renderer_.RecolorLastFrame(render_settings_.coloring)) {
+            Present(std::move(*frame));
+            state_.need_rerender = state_.need_rerender || state_.supersampling;
+        }
+        state_.need_recolor = false;
+    }
 
-            // Ограничиваем FPS
-            const auto target_frame_time = std::chrono::milliseconds{1000 / 60};
-            const auto elapsed_time = frame_clock.GetFrameTime();
+    // Готовый кадр текущего рендеринга: его время уточняет разрешение кадров при зуме, а отклик — лимит итераций
+    // следующего кадра. Если поздно убежавших пикселей много и бюджет позволяет, кадр полного разрешения
+    // пересчитывается тем же видом с поднятым лимитом.
+    void AdaptIterations(const RenderResult &frame) {
+        resolution_.Observe(render_divisor_, frame.render_time);
+        iteration_feedback_ = MakeIterationFeedback(frame);
+        // Бюджет лимита итераций задан для полного разрешения
+        iteration_feedback_->render_time *= render_divisor_ * render_divisor_;
+        refining_ = render_divisor_ == 1 && state_.auto_iterations &&
+                    ChooseMaxIterations(auto_iterations_, state_.viewport, iteration_feedback_) >
+                        frame.settings.max_iterations;
+    }
 
-            if (elapsed_time < target_frame_time) {
-                const auto sleep_time = target_frame_time - elapsed_time;
-                std::this_thread::sleep_for(sleep_time);
+    // refining — уточнение показанного кадра тем же видом; divisor — делитель разрешения (см. ScaledSettings)
+    void StartRender(bool refining, std::uint32_t divisor) {
+        refining_ = false;
+        render_divisor_ = divisor;
+        render_settings_.max_iterations =
+            state_.auto_iterations ? ChooseMaxIterations(auto_iterations_, state_.viewport, iteration_feedback_)
+                                   : FIXED_MAX_ITERATIONS;
+        RenderSettings settings = ScaledSettings(render_settings_, divisor);
+        // Кадры пониженного разрешения растягиваются на окно, сглаживать их незачем
+        settings.supersampling.grid = state_.supersampling && divisor == 1 ? SUPERSAMPLING_GRID : 0;
+
+        // Пока кадр считается, показываем превью, пересэмплированное из предыдущего кадра.
+        // Уточнение показанного кадра не выводит превью и промежуточные проходы: на экране остаётся готовый кадр.
+        if (!refining) {
+            if (auto preview = renderer_.Preview(state_.viewport, settings)) {
+                Present(std::move(*preview));
             }
-
-            frame_clock.Reset();
         }
+
+        // Прогрессивный рендеринг: проходы 1/16, 1/4 и полный кадр приходят из пула через frames_.
+        // Запуск отменяет предыдущий кадр (см. MandelbrotRenderer::CancelFrame), его проходы отбрасываются.
+        const auto render = frames_.Begin();
+        auto post_pass = [this, render, refining](const RenderResult &pass) {
+            if (!refining || HasRenderStats(pass)) {
+                frames_.Post(render, pass);
+            }
+        };
+        auto render_sender = renderer_.RenderProgressiveAsync(state_.viewport, settings, post_pass);
+        stdexec::start_detached(std::move(render_sender) |
+                                stdexec::then([this, render](RenderResult) { frames_.Finish(render); }) |
+                                stdexec::upon_error([this, render](std::exception_ptr error) {
+                                    frames_.Finish(render, std::move(error));
+                                }) |
+                                stdexec::upon_stopped([this, render] { frames_.Finish(render); }));
+        state_.need_rerender = false;
     }
 };
 
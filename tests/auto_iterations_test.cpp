@@ -0,0 +1,82 @@
+#include "auto_iterations.hpp"
+#include "types.hpp"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <optional>
+
+using namespace std::chrono_literals;
+
+class AutoIterationsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        settings = AutoIterationSettings{};
+        home = mandelbrot::ViewPort{-2.5, 1.5, -2.0, 2.0};
+    }
+
+    // Отклик кадра 100 000 пикселей с лимитом max_iterations
+    [[nodiscard]] static IterationFeedback Feedback(std::uint32_t max_iterations, std::uint64_t late_escaped,
+                                                    std::uint32_t max_escape, std::chrono::milliseconds time) {
+        return IterationFeedback{.max_iterations = max_iterations,
+                                 .pixels = 100000,
+                                 .late_escaped_pixels = late_escaped,
+                                 .max_escape_iterations = max_escape,
+                                 .render_time = time};
+    }
+
+    AutoIterationSettings settings;
+    mandelbrot::ViewPort home;
+};
+
+TEST_F(AutoIterationsTest, RoundIterations_QuarterOctaveSteps) {
+    EXPECT_EQ(RoundIterations(0), 0);
+    EXPECT_EQ(RoundIterations(3), 3);
+    EXPECT_EQ(RoundIterations(100), 96);
+    EXPECT_EQ(RoundIterations(112), 112);
+    EXPECT_EQ(RoundIterations(1100), 1024);
+    EXPECT_EQ(RoundIterations(1365), 1280);
+}
+
+TEST_F(AutoIterationsTest, DepthIterations_GrowWithZoom) {
+    EXPECT_EQ(DepthIterations(settings, home), settings.min_iterations);
+
+    // 2^20 раз ближе исходного вида: 20 октав
+    const double span = AUTO_ITERATIONS_HOME_SPAN / (1 << 20);
+    const mandelbrot::ViewPort deep{-span / 2, span / 2, -span / 2, span / 2};
+    EXPECT_EQ(DepthIterations(settings, deep), settings.min_iterations + 20 * settings.iterations_per_octave);
+
+    // Без отклика прошлого кадра лимит задаёт глубина
+    EXPECT_EQ(ChooseMaxIterations(settings, deep, std::nullopt), 1024);
+    EXPECT_EQ(ChooseMaxIterations(settings, home, std::nullopt), settings.min_iterations);
+}
+
+TEST_F(AutoIterationsTest, ChooseMaxIterations_RaisesWhileLateEscapesMatter) {
+    // 1% пикселей убежали во второй половине лимита: лимит удваивается
+    EXPECT_EQ(ChooseMaxIterations(settings, home, Feedback(512, 1000, 500, 10ms)), 1024);
+
+    // Почти ничего не убегает у лимита: лимит остаётся прежним
+    EXPECT_EQ(ChooseMaxIterations(settings, home, Feedback(512, 10, 300, 10ms)), 512);
+}
+
+TEST_F(AutoIterationsTest, ChooseMaxIterations_LowersUnusedLimit) {
+    // Самое долгое убегание 150 при лимите 4096: лимит снижается до удвоенного убегания
+    EXPECT_EQ(ChooseMaxIterations(settings, home, Feedback(4096, 0, 150, 10ms)), 256);
+
+    // Но не ниже лимита по глубине
+    EXPECT_EQ(ChooseMaxIterations(settings, home, Feedback(4096, 0, 10, 10ms)), settings.min_iterations);
+}
+
+TEST_F(AutoIterationsTest, ChooseMaxIterations_RespectsTimeBudget) {
+    settings.time_budget = 200ms;
+
+    // Кадр с лимитом 1024 занял 150 мс: удвоение не укладывается в бюджет, лимит поднимается до 1365
+    // (с округлением — до 1280)
+    EXPECT_EQ(ChooseMaxIterations(settings, home, Feedback(1024, 5000, 1000, 150ms)), 1280);
+
+    // Кадр уже вдвое дольше бюджета: лимит снижается, но не ниже min_iterations
+    EXPECT_EQ(ChooseMaxIterations(settings, home, Feedback(1024, 5000, 1000, 400ms)), 512);
+    EXPECT_EQ(ChooseMaxIterations(settings, home, Feedback(128, 5000, 100, 10s)), settings.min_iterations);
+
+    // Ограничение сверху
+    settings.max_iterations = 700;
+    EXPECT_EQ(ChooseMaxIterations(settings, home, Feedback(512, 5000, 500, 1ms)), 700);
+}
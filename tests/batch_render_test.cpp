@@ -0,0 +1,202 @@
+#include "batch_render.hpp"
+#include "supersampling.hpp"
+#include "types.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <stdexec/execution.hpp>
+#include <string_view>
+#include <vector>
+
+class BatchRenderTest : public ::testing::Test {
+protected:
+    [[nodiscard]] static BatchOptions Parse(std::vector<std::string_view> args) { return ParseBatchOptions(args); }
+};
+
+TEST_F(BatchRenderTest, ParseBatchOptions_Values) {
+    const auto options = Parse({"--size", "640x480", "--iterations", "1000", "--center", "-0.75", "0.1", "--span",
+                                "0.5", "--band-rows", "16", "--mode", "mariani", "--output", "out.ppm"});
+    EXPECT_EQ(options.settings.width, 640);
+    EXPECT_EQ(options.settings.height, 480);
+    EXPECT_EQ(options.settings.max_iterations, 1000);
+    EXPECT_EQ(options.settings.mode, RenderMode::MARIANI_SILVER);
+    EXPECT_EQ(options.band_rows, 16);
+    EXPECT_EQ(options.output, "out.ppm");
+
+    // Центр хранится в origin, границы отсчитываются от него
+    EXPECT_DOUBLE_EQ(options.viewport.origin.real.ToDouble(), -0.75);
+    EXPECT_DOUBLE_EQ(options.viewport.origin.imag.ToDouble(), 0.1);
+    EXPECT_DOUBLE_EQ(options.viewport.width(), 0.5);
+    EXPECT_DOUBLE_EQ(options.viewport.height(), 0.375);
+}
+
+TEST_F(BatchRenderTest, ParseBatchOptions_Errors) {
+    EXPECT_THROW((void)Parse({"--size", "640"}), std::invalid_argument);
+    EXPECT_THROW((void)Parse({"--iterations", "many"}), std::invalid_argument);
+    EXPECT_THROW((void)Parse({"--span"}), std::invalid_argument);
+    EXPECT_THROW((void)Parse({"--span", "0"}), std::invalid_argument);
+    EXPECT_THROW((void)Parse({"--quality", "high"}), std::invalid_argument);
+}
+
+TEST_F(BatchRenderTest, BandRows_BoundedByMemory) {
+    auto options = Parse({"--size", "65536x65536"});
+    const auto rows = BandRows(options);
+    EXPECT_GE(rows, 1);
+    EXPECT_LE(std::size_t{rows} * 65536 * (sizeof(std::uint32_t) + sizeof(mandelbrot::RgbColor)), BATCH_BAND_BYTES);
+
+    options.band_rows = 3;
+    EXPECT_EQ(BandRows(options), 3);
+}
+
+TEST_F(BatchRenderTest, RenderBands_MatchesFullFrame) {
+    // Шаг пикселя 1/16 представим точно: полосы совпадают с кадром целиком побитово
+    const RenderSettings settings{.width = 64, .height = 64, .max_iterations = 100, .escape_radius = 2.0};
+    const mandelbrot::ViewPort viewport{-2.0, 2.0, -2.0, 2.0};
+
+    MandelbrotRenderer full_renderer{2};
+    auto full = stdexec::sync_wait(full_renderer.RenderAsync(viewport, settings));
+    ASSERT_TRUE(full.has_value());
+    const auto &expected = std::get<0>(full.value());
+
+    MandelbrotRenderer renderer{2};
+    std::vector<std::uint32_t> starts;
+    RenderBands(renderer, viewport, settings, 24, [&](const RenderResult &band, std::uint32_t start_row) {
+        starts.push_back(start_row);
+        for (std::uint32_t y = 0; y < band.settings.height; ++y) {
+            for (std::uint32_t x = 0; x < settings.width; ++x) {
+                EXPECT_EQ(band.pixel_data[y][x], expected.pixel_data[start_row + y][x]);
+                EXPECT_EQ(band.color_data[y][x].g, expected.color_data[start_row + y][x].g);
+            }
+        }
+    });
+    EXPECT_EQ(starts, (std::vector<std::uint32_t>{0, 24, 48}));
+}
+
+TEST_F(BatchRenderTest, RenderBands_SupersamplesAcrossBandBorders) {
+    // Полоса считается со строкой соседней полосы с каждой стороны: границы множества на стыке полос
+    // сглаживаются, как в изображении целиком
+    RenderSettings settings{.width = 64, .height = 64, .max_iterations = 100, .escape_radius = 2.0};
+    settings.supersampling = SupersamplingSettings{.grid = 2, .threshold = 2};
+    const mandelbrot::ViewPort viewport{-2.0, 2.0, -2.0, 2.0};
+    constexpr std::uint32_t BAND_ROWS = 24;
+
+    MandelbrotRenderer full_renderer{2};
+    auto full = stdexec::sync_wait(full_renderer.RenderAsync(viewport, settings));
+    ASSERT_TRUE(full.has_value());
+    const auto &expected = std::get<0>(full.value());
+
+    // Пиксели-границы строк [first_row, last_row) изображения, если соседи за этими строками не видны
+    auto edges = [&](std::uint32_t first_row, std::uint32_t last_row) {
+        const auto pixels = expected.pixel_data.View(PixelRegion{first_row, last_row, 0, settings.width});
+        std::uint64_t count = 0;
+        for (std::uint32_t y = 0; y < pixels.height(); ++y) {
+            for (std::uint32_t x = 0; x < pixels.width(); ++x) {
+                count += IsEdgePixel(pixels, x, y, settings.supersampling.threshold) ? 1 : 0;
+            }
+        }
+        return count;
+    };
+    ASSERT_EQ(expected.stats.supersampled_pixels, edges(0, settings.height));
+
+    MandelbrotRenderer renderer{2};
+    std::vector<std::uint32_t> starts;
+    RenderBands(renderer, viewport, settings, BAND_ROWS, [&](const RenderResult &band, std::uint32_t start_row) {
+        starts.push_back(start_row);
+        const std::uint32_t end_row = start_row + band.settings.height;
+        ASSERT_EQ(band.settings.height, std::min(BAND_ROWS, settings.height - start_row));
+        ASSERT_EQ(band.pixel_data.height(), band.settings.height);
+        ASSERT_EQ(band.color_data.height(), band.settings.height);
+        // Статистика полосы включает строки перекрытия
+        EXPECT_EQ(band.stats.supersampled_pixels, edges(start_row == 0 ? 0 : start_row - 1,
+                                                        std::min(end_row + 1, settings.height)));
+        for (std::uint32_t y = 0; y < band.settings.height; ++y) {
+            for (std::uint32_t x = 0; x < settings.width; ++x) {
+                EXPECT_EQ(band.pixel_data[y][x], expected.pixel_data[start_row + y][x]);
+            }
+        }
+    });
+    EXPECT_EQ(starts, (std::vector<std::uint32_t>{0, 24, 48}));
+}
+
+TEST_F(BatchRenderTest, RenderBands_KeepsLastInteractiveFrame) {
+    // Полосы — независимые кадры: последним кадром рендерера остаётся кадр окна
+    const RenderSettings settings{.width = 64, .height = 64, .max_iterations = 100, .escape_radius = 2.0};
+    const mandelbrot::ViewPort window{-2.0, 2.0, -2.0, 2.0};
+    const mandelbrot::ViewPort batch{-1.0, 1.0, -1.0, 1.0};
+
+    MandelbrotRenderer renderer{2};
+    ASSERT_TRUE(stdexec::sync_wait(renderer.RenderAsync(window, settings)).has_value());
+    RenderBands(renderer, batch, settings, 24, [](const RenderResult &, std::uint32_t) {});
+
+    const auto last = renderer.RecolorLastFrame(settings.coloring);
+    ASSERT_TRUE(last.has_value());
+    EXPECT_EQ(last->viewport.x_min, window.x_min);
+    EXPECT_EQ(last->viewport.x_max, window.x_max);
+    EXPECT_EQ(last->settings.height, settings.height);
+}
+
+TEST_F(BatchRenderTest, RenderBands_LeavesTileCacheEmpty) {
+    // Шаг пикселя 1/16 лежит на сетке кэша, и каждая полоса в 64 строки покрывает две плитки целиком
+    const RenderSettings settings{.width = 128, .height = 128, .max_iterations = 100, .escape_radius = 2.0};
+    const mandelbrot::ViewPort viewport{-4.0, 4.0, -4.0, 4.0};
+
+    MandelbrotRenderer renderer{2};
+    std::uint32_t bands = 0;
+    RenderBands(renderer, viewport, settings, 64, [&](const RenderResult &, std::uint32_t) { ++bands; });
+    EXPECT_EQ(bands, 2u);
+
+    const auto stats = renderer.Cache().Stats();
+    EXPECT_EQ(stats.tiles, 0u);
+    EXPECT_EQ(stats.bytes, 0u);
+    EXPECT_EQ(stats.hits, 0u);
+    EXPECT_EQ(stats.misses, 0u);
+}
+
+TEST_F(BatchRenderTest, ParseBatchOptions_Stats) {
+    EXPECT_FALSE(Parse({}).stats);
+    EXPECT_TRUE(Parse({"--stats"}).stats);
+}
+
+TEST_F(BatchRenderTest, ParseBatchOptions_Animation) {
+    EXPECT_FALSE(Parse({}).Animation());
+
+    const auto options = Parse({"--size", "320x240", "--center", "-0.5", "0", "--span", "4", "--frames", "90",
+                                "--zoom-to", "-0.75", "0.1", "1e-6", "--fps", "60", "--format", "rgb",
+                                "--frames-in-flight", "5", "--auto-iterations"});
+    EXPECT_TRUE(options.Animation());
+    EXPECT_EQ(options.frames, 90);
+    EXPECT_EQ(options.fps, 60);
+    EXPECT_EQ(options.video_format, VideoFormat::RAW_RGB);
+    EXPECT_EQ(options.frames_in_flight, 5);
+    EXPECT_TRUE(options.auto_iterations);
+    // Анимация без --output пишется в stdout
+    EXPECT_EQ(options.output, "-");
+
+    const auto path = AnimationPath(options);
+    EXPECT_EQ(path.FrameCount(), 90);
+    EXPECT_DOUBLE_EQ(path.At(0).span, 4.0);
+    EXPECT_DOUBLE_EQ(path.At(0).center.real.ToDouble(), -0.5);
+    EXPECT_DOUBLE_EQ(path.At(89).span, 1e-6);
+    EXPECT_DOUBLE_EQ(path.At(89).center.imag.ToDouble(), 0.1);
+
+    EXPECT_EQ(Parse({"--frames", "10", "--output", "zoom.y4m"}).output, "zoom.y4m");
+    EXPECT_EQ(Parse({"--keyframes", "path.txt"}).keyframes, "path.txt");
+}
+
+TEST_F(BatchRenderTest, ParseBatchOptions_AnimationErrors) {
+    EXPECT_THROW((void)Parse({"--zoom-to", "-0.75", "0.1", "1e-6"}), std::invalid_argument);
+    EXPECT_THROW((void)Parse({"--frames", "10", "--keyframes", "path.txt"}), std::invalid_argument);
+    EXPECT_THROW((void)Parse({"--frames", "10", "--pyramid", "3"}), std::invalid_argument);
+    EXPECT_THROW((void)Parse({"--format", "mp4"}), std::invalid_argument);
+}
+
+TEST_F(BatchRenderTest, ParseBatchOptions_Supersampling) {
+    EXPECT_EQ(Parse({}).settings.supersampling.grid, 0);
+
+    const auto options = Parse({"--supersample", "4", "--supersample-threshold", "8"});
+    EXPECT_EQ(options.settings.supersampling.grid, 4);
+    EXPECT_EQ(options.settings.supersampling.threshold, 8);
+
+    EXPECT_THROW((void)Parse({"--supersample", "16"}), std::invalid_argument);
+    EXPECT_THROW((void)Parse({"--supersample", "4", "--pyramid", "3"}), std::invalid_argument);
+}
@@ -0,0 +1,87 @@
+#include "colorize.hpp"
+#include "mandelbrot_sender.hpp"
+#include <gtest/gtest.h>
+
+using namespace mandelbrot;
+
+class ColorizeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        settings = RenderSettings{.width = 48, .height = 32, .max_iterations = 150, .escape_radius = 2.0};
+        viewport = ViewPort{-2.0, 1.0, -1.0, 1.0};
+    }
+
+    // Кадр, посчитанный вместе с цветами за один проход
+    [[nodiscard]] RenderResult RenderColored(const RenderSettings &frame_settings) const {
+        RenderResult result{.pixel_data = PixelMatrix(frame_settings.width, frame_settings.height),
+                            .color_data = ColorMatrix(frame_settings.width, frame_settings.height),
+                            .viewport = viewport,
+                            .settings = frame_settings};
+        RenderRegion(viewport, frame_settings, Frame(),
+                     RenderTarget{result.pixel_data.View(), result.color_data.View()});
+        return result;
+    }
+
+    // Кадр только с итерациями
+    [[nodiscard]] RenderResult RenderIterations() const {
+        RenderResult result{.pixel_data = PixelMatrix(settings.width, settings.height),
+                            .color_data = ColorMatrix{},
+                            .viewport = viewport,
+                            .settings = settings};
+        RenderRegion(viewport, settings, Frame(), RenderTarget{result.pixel_data.View(), {}});
+        return result;
+    }
+
+    [[nodiscard]] PixelRegion Frame() const {
+        return PixelRegion{.start_row = 0, .end_row = settings.height, .start_col = 0, .end_col = settings.width};
+    }
+
+    static void ExpectSameColors(const ColorMatrix &expected, const ColorMatrix &actual) {
+        ASSERT_EQ(expected.width(), actual.width());
+        ASSERT_EQ(expected.height(), actual.height());
+        for (std::uint32_t y = 0; y < expected.height(); ++y) {
+            for (std::uint32_t x = 0; x < expected.width(); ++x) {
+                EXPECT_EQ(expected[y][x].r, actual[y][x].r) << "x=" << x << " y=" << y;
+                EXPECT_EQ(expected[y][x].g, actual[y][x].g) << "x=" << x << " y=" << y;
+                EXPECT_EQ(expected[y][x].b, actual[y][x].b) << "x=" << x << " y=" << y;
+            }
+        }
+    }
+
+    RenderSettings settings;
+    ViewPort viewport;
+};
+
+TEST_F(ColorizeTest, IterationsOnlyTarget_SamePixels) {
+    const auto colored = RenderColored(settings);
+    const auto frame = RenderIterations();
+
+    EXPECT_TRUE(frame.color_data.empty());
+    for (std::uint32_t y = 0; y < settings.height; ++y) {
+        for (std::uint32_t x = 0; x < settings.width; ++x) {
+            EXPECT_EQ(frame.pixel_data[y][x], colored.pixel_data[y][x]);
+        }
+    }
+}
+
+TEST_F(ColorizeTest, ColorizeFrame_MatchesSinglePassColors) {
+    auto frame = RenderIterations();
+    ColorizeFrame(frame);
+    ExpectSameColors(RenderColored(settings).color_data, frame.color_data);
+}
+
+TEST_F(ColorizeTest, Recolor_MatchesRenderWithNewColoring) {
+    auto frame = RenderIterations();
+    ColorizeFrame(frame);
+
+    for (const ColorSettings coloring : {ColorSettings{.palette = PaletteKind::FIRE},
+                                         ColorSettings{.palette = PaletteKind::GRAYSCALE, .cycle_offset = -12},
+                                         ColorSettings{.mode = ColoringMode::CYCLIC, .cycle_offset = 30}}) {
+        Recolor(frame, coloring);
+        EXPECT_EQ(frame.settings.coloring, coloring);
+
+        RenderSettings expected_settings = settings;
+        expected_settings.coloring = coloring;
+        ExpectSameColors(RenderColored(expected_settings).color_data, frame.color_data);
+    }
+}
@@ -0,0 +1,127 @@
+#include "double_double.hpp"
+#include "mandelbrot_simd.hpp"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace mandelbrot;
+
+class DoubleDoubleTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Точка Мисюревича c = i: на глубине 1e-20 double уже не различает соседние пиксели
+        viewport = MakeViewPort(center, 1e-20, 1e-20);
+        for (std::uint32_t y = 0; y < 17; ++y) {
+            for (std::uint32_t x = 0; x < 33; ++x) {
+                points.push_back(Pixel2DToDoubleDouble(x, y, viewport, 33, 17));
+            }
+        }
+    }
+
+    [[nodiscard]] static FixedPoint ToFixedPoint(const DoubleDouble &value) {
+        return FixedPoint{value.hi} + FixedPoint{value.lo};
+    }
+
+    // Эталон: итерации целиком в повышенной точности
+    static std::uint32_t CalculateIterationsExact(const FixedPointComplex &c, std::uint32_t max_iterations,
+                                                  double escape_radius) {
+        FixedPoint z_real;
+        FixedPoint z_imag;
+        for (std::uint32_t i = 0; i < max_iterations; ++i) {
+            const double real = z_real.ToDouble();
+            const double imag = z_imag.ToDouble();
+            if (real * real + imag * imag > escape_radius * escape_radius) {
+                return i;
+            }
+            const FixedPoint real_squared = z_real * z_real;
+            const FixedPoint imag_squared = z_imag * z_imag;
+            const FixedPoint real_imag = z_real * z_imag;
+            z_real = real_squared - imag_squared + c.real;
+            z_imag = real_imag + real_imag + c.imag;
+        }
+        return max_iterations;
+    }
+
+    const FixedPointComplex center{FixedPoint{0.0}, FixedPoint{1.0}};
+    ViewPort viewport;
+    std::vector<DoubleDoubleComplex> points;
+};
+
+TEST_F(DoubleDoubleTest, TwoProdAndTwoSumAreExact) {
+    const double a = 1.0 + 0x1p-30;
+    const double b = 3.0 - 0x1p-40;
+
+    const auto product = double_double::TwoProd(a, b);
+    EXPECT_EQ(FixedPoint{product.hi} + FixedPoint{product.lo}, FixedPoint{a} * FixedPoint{b});
+
+    const auto sum = double_double::TwoSum(a, 0x1p-80);
+    EXPECT_EQ(sum.hi, a);
+    EXPECT_EQ(FixedPoint{sum.hi} + FixedPoint{sum.lo}, FixedPoint{a} + FixedPoint{0x1p-80});
+}
+
+TEST_F(DoubleDoubleTest, FromFixedPointKeepsAbout106Bits) {
+    const auto value = FixedPoint::FromString("-0.7436438870371587047521915061147746");
+    const auto converted = double_double::FromFixedPoint(value);
+
+    EXPECT_EQ(converted.hi, value.ToDouble());
+    EXPECT_LT(std::abs((ToFixedPoint(converted) - value).ToDouble()), 1e-31);
+}
+
+TEST_F(DoubleDoubleTest, MulKeepsPrecisionBeyondDouble) {
+    // (1 + 1e-20)^2 = 1 + 2e-20 + 1e-40: в double результат округлился бы до 1
+    const DoubleDouble x = double_double::FromFixedPoint(FixedPoint::FromString("1.00000000000000000001"));
+    const DoubleDouble square = double_double::Square(x);
+    const DoubleDouble product = double_double::Mul(x, x);
+
+    const auto expected = FixedPoint::FromString("1.00000000000000000002");
+    EXPECT_LT(std::abs((ToFixedPoint(square) - expected).ToDouble()), 1e-30);
+    EXPECT_EQ(square.hi, product.hi);
+    EXPECT_EQ(square.lo, product.lo);
+}
+
+TEST_F(DoubleDoubleTest, AllIsa_MatchScalarReference) {
+    for (std::uint32_t max_iterations : {1u, 7u, 100u, 1000u}) {
+        std::vector<std::uint32_t> reference(points.size());
+        simd::CalculateIterationsScalar(points, reference, max_iterations, 2.0);
+
+        for (auto isa : {simd::Isa::SSE2, simd::Isa::AVX2, simd::Isa::AVX512}) {
+            if (!simd::IsSupported(isa)) {
+                continue;
+            }
+
+            std::vector<std::uint32_t> iterations(points.size());
+            simd::CalculateIterations(points, iterations, max_iterations, 2.0, isa);
+
+            EXPECT_EQ(iterations, reference) << simd::IsaName(isa) << ", max_iterations = " << max_iterations;
+        }
+    }
+}
+
+TEST_F(DoubleDoubleTest, MatchesExactIterationsAtIntermediateDepth) {
+    const std::uint32_t size = 16;
+    const std::uint32_t max_iterations = 2000;
+
+    for (const double width : {1e-15, 1e-20, 1e-24}) {
+        const ViewPort view = MakeViewPort(center, width, width);
+        ASSERT_EQ(SelectPrecision(view, size, size), Precision::DOUBLE_DOUBLE);
+
+        bool found_difference = false;
+        std::uint32_t first = 0;
+        for (std::uint32_t y = 0; y < size; ++y) {
+            for (std::uint32_t x = 0; x < size; ++x) {
+                const auto offset = Pixel2DToComplex(x, y, view, size, size);
+                const FixedPointComplex c{center.real + FixedPoint{offset.real()},
+                                          center.imag + FixedPoint{offset.imag()}};
+                const auto iterations =
+                    CalculateIterationsForPoint(Pixel2DToDoubleDouble(x, y, view, size, size), max_iterations, 2.0);
+
+                EXPECT_EQ(iterations, CalculateIterationsExact(c, max_iterations, 2.0))
+                    << "width=" << width << " x=" << x << " y=" << y;
+                if (x == 0 && y == 0) {
+                    first = iterations;
+                }
+                found_difference |= iterations != first;
+            }
+        }
+        EXPECT_TRUE(found_difference) << "width=" << width;
+    }
+}
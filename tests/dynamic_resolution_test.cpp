@@ -0,0 +1,68 @@
+#include "dynamic_resolution.hpp"
+#include "types.hpp"
+#include <chrono>
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+class DynamicResolutionTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        settings = RenderSettings{.width = 800, .height = 600, .max_iterations = 100, .escape_radius = 2.0};
+    }
+
+    RenderSettings settings;
+};
+
+TEST_F(DynamicResolutionTest, ScaledSettings_DividesEachSide) {
+    const auto half = ScaledSettings(settings, 2);
+    EXPECT_EQ(half.width, 400);
+    EXPECT_EQ(half.height, 300);
+    EXPECT_EQ(half.max_iterations, settings.max_iterations);
+
+    const auto full = ScaledSettings(settings, 1);
+    EXPECT_EQ(full.width, settings.width);
+    EXPECT_EQ(full.height, settings.height);
+
+    // Размер не становится нулевым
+    settings.width = 3;
+    EXPECT_EQ(ScaledSettings(settings, 4).width, 1);
+}
+
+TEST_F(DynamicResolutionTest, Controller_FullResolutionUntilMeasured) {
+    ResolutionController controller{16ms};
+    EXPECT_EQ(controller.InteractiveDivisor(), 1);
+
+    // Быстрые кадры остаются в полном разрешении
+    controller.Observe(1, 10ms);
+    EXPECT_EQ(controller.InteractiveDivisor(), 1);
+}
+
+TEST_F(DynamicResolutionTest, Controller_DropsResolutionForSlowFrames) {
+    ResolutionController controller{16ms};
+
+    // 40 мс в полном разрешении: в 1/2 — 10 мс, укладывается в бюджет
+    controller.Observe(1, 40ms);
+    EXPECT_EQ(controller.InteractiveDivisor(), 2);
+
+    // Кадр в 1/2 занял 50 мс: оценка полного кадра растёт, нужно 1/4
+    controller.Observe(2, 50ms);
+    EXPECT_DOUBLE_EQ(controller.FullResolutionMs(), 120.0);
+    EXPECT_EQ(controller.InteractiveDivisor(), 4);
+
+    // Даже 1/4 не укладывается в бюджет: делитель не растёт дальше наибольшего
+    controller.Observe(4, 1s);
+    EXPECT_EQ(controller.InteractiveDivisor(), MAX_RESOLUTION_DIVISOR);
+}
+
+TEST_F(DynamicResolutionTest, Controller_RecoversAfterCheapFrames) {
+    ResolutionController controller{16ms};
+    controller.Observe(1, 200ms);
+    EXPECT_EQ(controller.InteractiveDivisor(), 4);
+
+    // Лёгкие кадры постепенно возвращают полное разрешение
+    for (int frame = 0; frame < 10; ++frame) {
+        controller.Observe(4, 0ms);
+    }
+    EXPECT_EQ(controller.InteractiveDivisor(), 1);
+}
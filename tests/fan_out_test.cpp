@@ -0,0 +1,35 @@
+#include "fan_out.hpp"
+#include <atomic>
+#include <exec/static_thread_pool.hpp>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <stdexec/execution.hpp>
+
+class FanOutTest : public ::testing::Test {
+protected:
+    exec::static_thread_pool pool{2};
+};
+
+TEST_F(FanOutTest, RunsEveryWorker) {
+    std::atomic<std::uint32_t> mask{0};
+    auto sender = MakeFanOutSender(pool.get_scheduler(), 4, [&mask](std::uint32_t worker, auto) {
+        mask.fetch_or(1u << worker);
+        return true;
+    });
+    EXPECT_TRUE(stdexec::sync_wait(std::move(sender)).has_value());
+    EXPECT_EQ(mask.load(), 0b1111u);
+}
+
+TEST_F(FanOutTest, WorkerExceptionCompletesWithError) {
+    // Исключение задачи не завершает программу, а доходит до вызывающего после завершения всех задач
+    std::atomic<std::uint32_t> finished{0};
+    auto sender = MakeFanOutSender(pool.get_scheduler(), 4, [&finished](std::uint32_t worker, auto) {
+        finished.fetch_add(1);
+        if (worker == 2) {
+            throw std::runtime_error{"worker failed"};
+        }
+        return true;
+    });
+    EXPECT_THROW(stdexec::sync_wait(std::move(sender)), std::runtime_error);
+    EXPECT_EQ(finished.load(), 4u);
+}
@@ -0,0 +1,54 @@
+#include "fixed_point.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+using namespace mandelbrot;
+
+class FixedPointTest : public ::testing::Test {};
+
+TEST_F(FixedPointTest, DoubleRoundTrip) {
+    for (const double value : {0.0, 1.0, -1.0, 0.1, -1.7548776662466927, 123456.789, 1e-100, -3e-110}) {
+        EXPECT_EQ(FixedPoint{value}.ToDouble(), value) << value;
+    }
+}
+
+TEST_F(FixedPointTest, Arithmetic) {
+    const FixedPoint a{1.5};
+    const FixedPoint b{-0.25};
+
+    EXPECT_EQ((a + b).ToDouble(), 1.25);
+    EXPECT_EQ((a - b).ToDouble(), 1.75);
+    EXPECT_EQ((a * b).ToDouble(), -0.375);
+    EXPECT_EQ((b * b).ToDouble(), 0.0625);
+    EXPECT_EQ((-a).ToDouble(), -1.5);
+}
+
+TEST_F(FixedPointTest, KeepsPrecisionBeyondDouble) {
+    // 1 + 1e-40 неотличимо от 1 в double, но не в FixedPoint
+    const FixedPoint one{1.0};
+    const FixedPoint tiny{1e-40};
+    const FixedPoint sum = one + tiny;
+
+    EXPECT_EQ(sum.ToDouble(), 1.0);
+    EXPECT_DOUBLE_EQ((sum - one).ToDouble(), 1e-40);
+    // Целая часть ограничена int64, поэтому умножаем на 1e40 по частям
+    const FixedPoint scale{1e10};
+    EXPECT_DOUBLE_EQ(((sum - one) * scale * scale * scale * scale).ToDouble(), 1.0);
+}
+
+TEST_F(FixedPointTest, FromString) {
+    EXPECT_EQ(FixedPoint::FromString("0").ToDouble(), 0.0);
+    EXPECT_EQ(FixedPoint::FromString("2.5").ToDouble(), 2.5);
+    EXPECT_EQ(FixedPoint::FromString("-0.75").ToDouble(), -0.75);
+    EXPECT_EQ(FixedPoint::FromString("+.5").ToDouble(), 0.5);
+    EXPECT_DOUBLE_EQ(FixedPoint::FromString("0.1").ToDouble(), 0.1);
+
+    // Разница чисел, совпадающих в первых 40 знаках
+    const auto a = FixedPoint::FromString("-0.7436438870371587047521915061147740000000003");
+    const auto b = FixedPoint::FromString("-0.7436438870371587047521915061147740000000001");
+    EXPECT_NEAR((a - b).ToDouble(), -2e-43, 1e-55);
+
+    EXPECT_THROW((void)FixedPoint::FromString(""), std::invalid_argument);
+    EXPECT_THROW((void)FixedPoint::FromString("1.2e5"), std::invalid_argument);
+}
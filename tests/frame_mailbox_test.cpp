@@ -0,0 +1,75 @@
+#include "frame_mailbox.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <thread>
+
+class FrameMailboxTest : public ::testing::Test {
+protected:
+    [[nodiscard]] static RenderResult FrameWithIterations(std::uint32_t iterations) {
+        RenderResult frame;
+        frame.pixel_data = PixelMatrix(2, 2, iterations);
+        return frame;
+    }
+
+    FrameMailbox mailbox;
+};
+
+TEST_F(FrameMailboxTest, KeepsLatestFrameUntilFinished) {
+    const auto render = mailbox.Begin();
+    mailbox.Post(render, FrameWithIterations(1));
+    mailbox.Post(render, FrameWithIterations(2));
+    mailbox.Finish(render);
+
+    // Непоказанный промежуточный кадр заменяется следующим; после завершения — конец
+    const auto frame = mailbox.Wait();
+    ASSERT_TRUE(frame.has_value());
+    EXPECT_EQ(frame->pixel_data[0][0], 2);
+    EXPECT_FALSE(mailbox.Wait().has_value());
+}
+
+TEST_F(FrameMailboxTest, WaitsForOtherThread) {
+    const auto render = mailbox.Begin();
+    std::thread producer{[this, render] {
+        mailbox.Post(render, FrameWithIterations(7));
+        mailbox.Finish(render);
+    }};
+
+    std::uint32_t last = 0;
+    while (const auto frame = mailbox.Wait()) {
+        last = frame->pixel_data[1][1];
+    }
+    producer.join();
+    EXPECT_EQ(last, 7);
+}
+
+TEST_F(FrameMailboxTest, RethrowsRenderError) {
+    const auto failed = mailbox.Begin();
+    mailbox.Finish(failed, std::make_exception_ptr(std::runtime_error{"render failed"}));
+    EXPECT_THROW((void)mailbox.TryTake(), std::runtime_error);
+
+    const auto render = mailbox.Begin();
+    EXPECT_FALSE(mailbox.TryTake().has_value());
+    mailbox.Post(render, FrameWithIterations(3));
+    EXPECT_TRUE(mailbox.TryTake().has_value());
+}
+
+TEST_F(FrameMailboxTest, DropsFramesOfSupersededRender) {
+    const auto stale = mailbox.Begin();
+    mailbox.Post(stale, FrameWithIterations(1));
+    const auto render = mailbox.Begin();
+
+    // Кадры и ошибка вытесненного рендеринга не доходят до окна
+    EXPECT_FALSE(mailbox.TryTake().has_value());
+    mailbox.Post(stale, FrameWithIterations(2));
+    mailbox.Finish(stale, std::make_exception_ptr(std::runtime_error{"cancelled"}));
+    EXPECT_FALSE(mailbox.TryTake().has_value());
+
+    mailbox.Post(render, FrameWithIterations(3));
+    mailbox.Finish(render);
+    const auto frame = mailbox.TryTake();
+    ASSERT_TRUE(frame.has_value());
+    EXPECT_EQ(frame->pixel_data[0][0], 3);
+
+    // Оба рендеринга завершены: ожидание не блокируется
+    mailbox.WaitIdle();
+}
@@ -0,0 +1,139 @@
+#include "frame_reuse.hpp"
+#include "mandelbrot_sender.hpp"
+#include "types.hpp"
+#include <gtest/gtest.h>
+
+using namespace mandelbrot;
+
+class FrameReuseTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Шаг пикселя 1/16 представим точно, поэтому сдвинутые пиксели совпадают с пересчитанными побитово
+        settings = RenderSettings{.width = 64, .height = 64, .max_iterations = 200, .escape_radius = 2.0};
+        viewport = ViewPort{-2.0, 2.0, -2.0, 2.0};
+    }
+
+    [[nodiscard]] RenderResult Render(const ViewPort &view) const {
+        RenderResult result{.pixel_data = PixelMatrix(settings.width, settings.height),
+                            .color_data = ColorMatrix(settings.width, settings.height),
+                            .viewport = view,
+                            .settings = settings};
+        RenderRegion(view, settings, Frame(), RenderTarget{result.pixel_data.View(), result.color_data.View()});
+        return result;
+    }
+
+    [[nodiscard]] PixelRegion Frame() const {
+        return PixelRegion{.start_row = 0, .end_row = settings.height, .start_col = 0, .end_col = settings.width};
+    }
+
+    [[nodiscard]] static ViewPort Shifted(const ViewPort &view, double dx, double dy) {
+        return ViewPort{view.x_min + dx, view.x_max + dx, view.y_min + dy, view.y_max + dy};
+    }
+
+    RenderSettings settings;
+    ViewPort viewport;
+};
+
+TEST_F(FrameReuseTest, FindFrameShift_WholePixelPan) {
+    const auto previous = Render(viewport);
+    const double pixel = viewport.width() / settings.width;
+
+    const auto shift = FindFrameShift(previous, Shifted(viewport, 5 * pixel, -3 * pixel), settings);
+    ASSERT_TRUE(shift.has_value());
+    EXPECT_EQ(shift->dx, 5);
+    EXPECT_EQ(shift->dy, -3);
+
+    // Тот же вид, дробный сдвиг, масштаб и другое число итераций пиксели не переносят
+    EXPECT_FALSE(FindFrameShift(previous, viewport, settings).has_value());
+    EXPECT_FALSE(FindFrameShift(previous, Shifted(viewport, 0.5 * pixel, 0.0), settings).has_value());
+    EXPECT_FALSE(FindFrameShift(previous, ViewPort{-1.6, 1.6, -1.6, 1.6}, settings).has_value());
+    auto more_iterations = settings;
+    more_iterations.max_iterations = 500;
+    EXPECT_FALSE(FindFrameShift(previous, Shifted(viewport, pixel, 0.0), more_iterations).has_value());
+}
+
+TEST_F(FrameReuseTest, FindFrameShift_RequiresSameClassificationSettings) {
+    // Пиксели, посчитанные с другими проверками внутренних точек или другим ядром, не переносятся
+    const auto previous = Render(viewport);
+    const auto panned = Shifted(viewport, viewport.width() / settings.width, 0.0);
+    ASSERT_TRUE(FindFrameShift(previous, panned, settings).has_value());
+
+    auto other = settings;
+    other.interior_checks.periodicity_tolerance = 1e-6;
+    EXPECT_FALSE(FindFrameShift(previous, panned, other).has_value());
+    other = settings;
+    other.interior_checks.cardioid_bulb = !settings.interior_checks.cardioid_bulb;
+    EXPECT_FALSE(FindFrameShift(previous, panned, other).has_value());
+    other = settings;
+    other.float_kernel = !settings.float_kernel;
+    EXPECT_FALSE(FindFrameShift(previous, panned, other).has_value());
+}
+
+TEST_F(FrameReuseTest, FindFrameShift_AcrossOrigins) {
+    // Сдвиг считается и тогда, когда центр вида перенесён в повышенную точность
+    const double pixel = viewport.width() / settings.width;
+    const auto previous = Render(viewport);
+    const ViewPort rebased = MakeViewPort(FixedPointComplex{FixedPoint{2 * pixel}, FixedPoint{0.0}}, 4.0, 4.0);
+
+    const auto shift = FindFrameShift(previous, rebased, settings);
+    ASSERT_TRUE(shift.has_value());
+    EXPECT_EQ(shift->dx, 2);
+    EXPECT_EQ(shift->dy, 0);
+}
+
+TEST_F(FrameReuseTest, ShiftPreviousFrame_MatchesFullRender) {
+    const double pixel = viewport.width() / settings.width;
+    const auto previous = Render(viewport);
+
+    for (const auto &[dx, dy] : {std::pair{7, 0}, std::pair{0, -9}, std::pair{-5, 11}, std::pair{20, 20}}) {
+        const ViewPort panned = Shifted(viewport, dx * pixel, dy * pixel);
+        const auto shift = FindFrameShift(previous, panned, settings);
+        ASSERT_TRUE(shift.has_value());
+
+        PixelMatrix pixels(settings.width, settings.height);
+        ColorMatrix colors(settings.width, settings.height);
+        const RenderTarget target{pixels.View(), colors.View()};
+        const auto exposed = ShiftPreviousFrame(previous, *shift, target);
+
+        // Пересчитываются только открывшиеся полосы
+        std::uint64_t exposed_area = 0;
+        for (const auto &region : exposed) {
+            exposed_area += static_cast<std::uint64_t>(region.width()) * region.height();
+            RenderRegion(panned, settings, region,
+                         RenderTarget{target.pixels.SubView(region), target.colors.SubView(region)});
+        }
+        const std::uint64_t kept = static_cast<std::uint64_t>(settings.width - std::abs(dx)) *
+                                   (settings.height - std::abs(dy));
+        EXPECT_EQ(exposed_area, static_cast<std::uint64_t>(settings.width) * settings.height - kept);
+
+        const auto expected = Render(panned);
+        for (std::uint32_t y = 0; y < settings.height; ++y) {
+            for (std::uint32_t x = 0; x < settings.width; ++x) {
+                EXPECT_EQ(pixels[y][x], expected.pixel_data[y][x])
+                    << "dx=" << dx << " dy=" << dy << " x=" << x << " y=" << y;
+                EXPECT_EQ(colors[y][x].g, expected.color_data[y][x].g);
+            }
+        }
+    }
+}
+
+TEST_F(FrameReuseTest, ResamplePreviousFrame_NearestNeighbour) {
+    const auto previous = Render(viewport);
+
+    // Приближение в 2 раза к центру: чётные пиксели превью попадают точно в пиксели предыдущего кадра
+    const ViewPort zoomed{-1.0, 1.0, -1.0, 1.0};
+    PixelMatrix pixels(settings.width, settings.height);
+    ColorMatrix colors(settings.width, settings.height);
+    ASSERT_TRUE(ResamplePreviousFrame(previous, zoomed, settings, RenderTarget{pixels.View(), colors.View()}));
+
+    for (std::uint32_t y = 0; y < settings.height; y += 2) {
+        for (std::uint32_t x = 0; x < settings.width; x += 2) {
+            EXPECT_EQ(pixels[y][x], previous.pixel_data[16 + y / 2][16 + x / 2]) << "x=" << x << " y=" << y;
+            EXPECT_EQ(colors[y][x].b, previous.color_data[16 + y / 2][16 + x / 2].b);
+        }
+    }
+
+    // Непересекающийся вид превью не даёт
+    EXPECT_FALSE(ResamplePreviousFrame(previous, ViewPort{10.0, 12.0, 10.0, 12.0}, settings,
+                                       RenderTarget{pixels.View(), colors.View()}));
+}
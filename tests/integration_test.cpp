@@ -28,7 +28,7 @@ TEST_F(IntegrationTest, MandelbrotSender_WithRenderer_Consistency) {
     auto sender1 = MakeMandelbrotSender(viewport, render_settings, full_region);
 
     // Создаем sender через MandelbrotRenderer с одним потоком
-    auto sender2 = renderer->RenderAsync<1>(viewport, render_settings);
+    auto sender2 = renderer->RenderAsync(viewport, render_settings, 1);
 
     auto result1 = stdexec::sync_wait(std::move(sender1));
     auto result2 = stdexec::sync_wait(std::move(sender2));
@@ -58,8 +58,8 @@ TEST_F(IntegrationTest, MandelbrotSender_WithRenderer_Consistency) {
 
 TEST_F(IntegrationTest, MultiThreadedRenderer_Consistency) {
     // Тестируем, что многопоточный рендеринг дает тот же результат, что и однопоточный
-    auto single_thread_sender = renderer->RenderAsync<1>(viewport, render_settings);
-    auto multi_thread_sender = renderer->RenderAsync<2>(viewport, render_settings);
+    auto single_thread_sender = renderer->RenderAsync(viewport, render_settings, 1);
+    auto multi_thread_sender = renderer->RenderAsync(viewport, render_settings, 2);
 
     auto result1 = stdexec::sync_wait(std::move(single_thread_sender));
     auto result2 = stdexec::sync_wait(std::move(multi_thread_sender));
@@ -132,9 +132,9 @@ TEST_F(IntegrationTest, DifferentViewports_Behavior) {
     auto viewport2 = mandelbrot::ViewPort{-1.0, 1.0, -1.0, 1.0};
     auto viewport3 = mandelbrot::ViewPort{0.0, 0.5, 0.0, 0.5};
 
-    auto sender1 = renderer->RenderAsync<1>(viewport1, render_settings);
-    auto sender2 = renderer->RenderAsync<1>(viewport2, render_settings);
-    auto sender3 = renderer->RenderAsync<1>(viewport3, render_settings);
+    auto sender1 = renderer->RenderAsync(viewport1, render_settings, 1);
+    auto sender2 = renderer->RenderAsync(viewport2, render_settings, 1);
+    auto sender3 = renderer->RenderAsync(viewport3, render_settings, 1);
 
     auto result1 = stdexec::sync_wait(std::move(sender1));
     auto result2 = stdexec::sync_wait(std::move(sender2));
@@ -193,12 +193,12 @@ TEST_F(IntegrationTest, Performance_Comparison) {
     // Простой тест производительности - проверяем, что многопоточность работает
     auto start_time = std::chrono::high_resolution_clock::now();
 
-    auto single_thread_sender = renderer->RenderAsync<1>(viewport, render_settings);
+    auto single_thread_sender = renderer->RenderAsync(viewport, render_settings, 1);
     auto single_result = stdexec::sync_wait(std::move(single_thread_sender));
 
     auto single_time = std::chrono::high_resolution_clock::now();
 
-    auto multi_thread_sender = renderer->RenderAsync<2>(viewport, render_settings);
+    auto multi_thread_sender = renderer->RenderAsync(viewport, render_settings, 2);
     auto multi_result = stdexec::sync_wait(std::move(multi_thread_sender));
 
     auto multi_time = std::chrono::high_resolution_clock::now();
@@ -213,3 +213,64 @@ TEST_F(IntegrationTest, Performance_Comparison) {
     // В реальных условиях многопоточность должна давать преимущество
     EXPECT_LE(multi_duration.count(), single_duration.count() + 100);  // +100ms допуск
 }
+
+TEST_F(IntegrationTest, MarianiSilver_MatchesBruteForce) {
+    // Режим деления прямоугольников должен давать тот же кадр, что и попиксельный расчёт
+    auto subdivision_settings = render_settings;
+    subdivision_settings.mode = RenderMode::MARIANI_SILVER;
+
+    for (const auto &test_viewport : {mandelbrot::ViewPort{-2.0, 2.0, -2.0, 2.0},
+                                      mandelbrot::ViewPort{-1.0, 1.0, -1.0, 1.0},
+                                      mandelbrot::ViewPort{0.0, 0.5, 0.0, 0.5}}) {
+        auto brute_force = stdexec::sync_wait(renderer->RenderAsync(test_viewport, render_settings, 2));
+        auto subdivision = stdexec::sync_wait(renderer->RenderAsync(test_viewport, subdivision_settings, 2));
+
+        ASSERT_TRUE(brute_force.has_value());
+        ASSERT_TRUE(subdivision.has_value());
+
+        const auto &expected = std::get<0>(brute_force.value());
+        const auto &actual = std::get<0>(subdivision.value());
+
+        ASSERT_EQ(expected.pixel_data.size(), actual.pixel_data.size());
+        for (size_t y = 0; y < expected.pixel_data.size(); ++y) {
+            for (size_t x = 0; x < expected.pixel_data[y].size(); ++x) {
+                EXPECT_EQ(expected.pixel_data[y][x], actual.pixel_data[y][x]);
+                EXPECT_EQ(expected.color_data[y][x].r, actual.color_data[y][x].r);
+                EXPECT_EQ(expected.color_data[y][x].g, actual.color_data[y][x].g);
+                EXPECT_EQ(expected.color_data[y][x].b, actual.color_data[y][x].b);
+            }
+        }
+    }
+}
+
+TEST_F(IntegrationTest, MarianiSilver_AroundCachedTilesMatchesBruteForce) {
+    // Шаг пикселя 1/64 лежит на сетке кэша: левая половина вида берётся из плиток исходного вида,
+    // правая делится прямоугольниками
+    const RenderSettings settings{.width = 128, .height = 128, .max_iterations = 50, .escape_radius = 2.0};
+    auto subdivision_settings = settings;
+    subdivision_settings.mode = RenderMode::MARIANI_SILVER;
+    const mandelbrot::ViewPort home{-2.0, 0.0, -1.0, 1.0};
+    const mandelbrot::ViewPort shifted{-1.0, 1.0, -1.0, 1.0};
+
+    ASSERT_TRUE(stdexec::sync_wait(renderer->RenderAsync(home, settings, 2)).has_value());
+    // Другой масштаб между ними: сдвинутый вид не переносит пиксели из прошлого кадра
+    ASSERT_TRUE(stdexec::sync_wait(renderer->RenderAsync(mandelbrot::ViewPort{-1.0, -0.5, -0.25, 0.25}, settings, 2))
+                    .has_value());
+    auto subdivision = stdexec::sync_wait(renderer->RenderAsync(shifted, subdivision_settings, 2));
+    ASSERT_TRUE(subdivision.has_value());
+    const auto &actual = std::get<0>(subdivision.value());
+    EXPECT_EQ(renderer->Cache().Stats().hits, 2u);
+    EXPECT_EQ(actual.stats.reused_pixels, 64u * 128u);
+
+    MandelbrotRenderer fresh_renderer{2};
+    auto brute_force = stdexec::sync_wait(fresh_renderer.RenderAsync(shifted, settings, 2));
+    ASSERT_TRUE(brute_force.has_value());
+    const auto &expected = std::get<0>(brute_force.value());
+
+    for (size_t y = 0; y < settings.height; ++y) {
+        for (size_t x = 0; x < settings.width; ++x) {
+            EXPECT_EQ(expected.pixel_data[y][x], actual.pixel_data[y][x]) << "x=" << x << " y=" << y;
+            EXPECT_EQ(expected.color_data[y][x].g, actual.color_data[y][x].g);
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#include "mandelbrot_perturbation.hpp"
+#include "mandelbrot_sender.hpp"
+#include "types.hpp"
+#include <gtest/gtest.h>
+
+using namespace mandelbrot;
+
+class MandelbrotPerturbationTest : public ::testing::Test {
+protected:
+    struct Frame {
+        PixelMatrix pixels;
+        ColorMatrix colors;
+
+        explicit Frame(const RenderSettings &settings)
+            : pixels(settings.width, settings.height), colors(settings.width, settings.height) {}
+        [[nodiscard]] RenderTarget Target() { return RenderTarget{pixels.View(), colors.View()}; }
+    };
+
+    // Эталон: итерации целиком в повышенной точности
+    static std::uint32_t CalculateIterationsExact(const FixedPointComplex &c, std::uint32_t max_iterations,
+                                                  double escape_radius) {
+        FixedPoint z_real;
+        FixedPoint z_imag;
+        for (std::uint32_t i = 0; i < max_iterations; ++i) {
+            const double real = z_real.ToDouble();
+            const double imag = z_imag.ToDouble();
+            if (real * real + imag * imag > escape_radius * escape_radius) {
+                return i;
+            }
+            const FixedPoint real_squared = z_real * z_real;
+            const FixedPoint imag_squared = z_imag * z_imag;
+            const FixedPoint real_imag = z_real * z_imag;
+            z_real = real_squared - imag_squared + c.real;
+            z_imag = real_imag + real_imag + c.imag;
+        }
+        return max_iterations;
+    }
+};
+
+TEST_F(MandelbrotPerturbationTest, MatchesDoubleAtShallowDepth) {
+    // Окрестность миниброта периода 3: опорная точка в центре даёт глитчи, которые пересчитываются
+    const RenderSettings settings{.width = 200, .height = 200, .max_iterations = 1000};
+    const ViewPort viewport{-1.755, -1.745, -0.005, 0.005};
+    Frame expected{settings};
+    Frame actual{settings};
+
+    RenderRegion(viewport, settings, PixelRegion{0, settings.height, 0, settings.width}, expected.Target());
+    PerturbationRenderer{viewport, settings, actual.Target()}.Render();
+
+    for (std::uint32_t y = 0; y < settings.height; ++y) {
+        for (std::uint32_t x = 0; x < settings.width; ++x) {
+            EXPECT_EQ(expected.pixels[y][x], actual.pixels[y][x]) << "x=" << x << " y=" << y;
+            EXPECT_EQ(expected.colors[y][x].r, actual.colors[y][x].r);
+        }
+    }
+}
+
+TEST_F(MandelbrotPerturbationTest, MatchesExactIterationsAtDeepZoom) {
+    // Точка Мисюревича c = i лежит на границе множества, детали есть на любой глубине
+    const RenderSettings settings{.width = 16, .height = 16, .max_iterations = 2000};
+    const FixedPointComplex center{FixedPoint{0.0}, FixedPoint{1.0}};
+
+    // Обе ширины глубже предела double-double: шаг пикселя меньше DOUBLE_DOUBLE_MIN_PIXEL_SPACING
+    for (const double width : {1e-30, 1e-60}) {
+        const ViewPort viewport = MakeViewPort(center, width, width);
+        ASSERT_EQ(SelectPrecision(viewport, settings.width, settings.height), Precision::PERTURBATION);
+
+        Frame frame{settings};
+        PerturbationRenderer{viewport, settings, frame.Target()}.Render();
+
+        for (std::uint32_t y = 0; y < settings.height; ++y) {
+            for (std::uint32_t x = 0; x < settings.width; ++x) {
+                const auto offset = Pixel2DToComplex(x, y, viewport, settings.width, settings.height);
+                const FixedPointComplex c{center.real + FixedPoint{offset.real()},
+                                          center.imag + FixedPoint{offset.imag()}};
+                EXPECT_EQ(frame.pixels[y][x], CalculateIterationsExact(c, settings.max_iterations, 2.0))
+                    << "width=" << width << " x=" << x << " y=" << y;
+            }
+        }
+    }
+}
+
+TEST_F(MandelbrotPerturbationTest, ReferenceOrbitStopsAfterEscape) {
+    const auto orbit = CalculateReferenceOrbit(FixedPointComplex{}, Complex{1.0, 0.0}, 100, 2.0);
+
+    // 0 -> 1 -> 2 -> 5: точка 5 уже за радиусом убегания
+    ASSERT_EQ(orbit.points.size(), 4);
+    EXPECT_EQ(orbit.points.back(), Complex(5.0, 0.0));
+
+    // Пиксель, который переживает опорную точку, помечается глитчем
+    const auto result = CalculateIterationsPerturbed(orbit, Complex{-1.0, 0.0}, 100, 2.0);
+    EXPECT_TRUE(result.glitched);
+}
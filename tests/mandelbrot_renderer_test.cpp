@@ -1,8 +1,12 @@
 #include "mandelbrot_renderer.hpp"
 #include "types.hpp"
 #include <gtest/gtest.h>
+#include <latch>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <stdexec/execution.hpp>
+#include <vector>
 
 class MandelbrotRendererTest : public ::testing::Test {
 protected:
@@ -19,7 +23,7 @@ protected:
 
 TEST_F(MandelbrotRendererTest, RenderAsync_SingleThread) {
     // Тестируем рендеринг с одним потоком
-    auto sender = renderer->RenderAsync<1>(viewport, render_settings);
+    auto sender = renderer->RenderAsync(viewport, render_settings, 1);
 
     auto result = stdexec::sync_wait(std::move(sender));
     ASSERT_TRUE(result.has_value());
@@ -46,7 +50,7 @@ TEST_F(MandelbrotRendererTest, RenderAsync_SingleThread) {
 
 TEST_F(MandelbrotRendererTest, RenderAsync_TwoThreads) {
     // Тестируем рендеринг с двумя потоками
-    auto sender = renderer->RenderAsync<2>(viewport, render_settings);
+    auto sender = renderer->RenderAsync(viewport, render_settings, 2);
 
     auto result = stdexec::sync_wait(std::move(sender));
     ASSERT_TRUE(result.has_value());
@@ -65,8 +69,8 @@ TEST_F(MandelbrotRendererTest, RenderAsync_TwoThreads) {
 
 TEST_F(MandelbrotRendererTest, RenderAsync_Consistency) {
     // Тестируем, что результаты одинаковы при разных количествах потоков
-    auto sender1 = renderer->RenderAsync<1>(viewport, render_settings);
-    auto sender2 = renderer->RenderAsync<2>(viewport, render_settings);
+    auto sender1 = renderer->RenderAsync(viewport, render_settings, 1);
+    auto sender2 = renderer->RenderAsync(viewport, render_settings, 2);
 
     auto result1 = stdexec::sync_wait(std::move(sender1));
     auto result2 = stdexec::sync_wait(std::move(sender2));
@@ -100,8 +104,8 @@ TEST_F(MandelbrotRendererTest, RenderAsync_DifferentViewports) {
     auto viewport1 = mandelbrot::ViewPort{-2.0, 2.0, -2.0, 2.0};
     auto viewport2 = mandelbrot::ViewPort{-1.0, 1.0, -1.0, 1.0};
 
-    auto sender1 = renderer->RenderAsync<1>(viewport1, render_settings);
-    auto sender2 = renderer->RenderAsync<1>(viewport2, render_settings);
+    auto sender1 = renderer->RenderAsync(viewport1, render_settings, 1);
+    auto sender2 = renderer->RenderAsync(viewport2, render_settings, 1);
 
     auto result1 = stdexec::sync_wait(std::move(sender1));
     auto result2 = stdexec::sync_wait(std::move(sender2));
@@ -135,7 +139,7 @@ TEST_F(MandelbrotRendererTest, RenderAsync_EmptyRegion) {
     auto small_viewport = mandelbrot::ViewPort{0.0, 0.1, 0.0, 0.1};
     auto small_settings = RenderSettings{.width = 10, .height = 10, .max_iterations = 10, .escape_radius = 2.0};
 
-    auto sender = renderer->RenderAsync<1>(small_viewport, small_settings);
+    auto sender = renderer->RenderAsync(small_viewport, small_settings, 1);
     auto result = stdexec::sync_wait(std::move(sender));
 
     ASSERT_TRUE(result.has_value());
@@ -144,3 +148,403 @@ TEST_F(MandelbrotRendererTest, RenderAsync_EmptyRegion) {
     EXPECT_EQ(render_result.pixel_data.size(), small_settings.height);
     EXPECT_EQ(render_result.color_data.size(), small_settings.height);
 }
+
+TEST_F(MandelbrotRendererTest, RenderAsync_TileSizeDoesNotChangeResult) {
+    // Разбиение на плитки влияет только на распределение работы, но не на результат
+    auto small_tiles = render_settings;
+    small_tiles.tile_size = 7;
+    auto large_tiles = render_settings;
+    large_tiles.tile_size = 1000;
+
+    auto result1 = stdexec::sync_wait(renderer->RenderAsync(viewport, small_tiles, 2));
+    auto result2 = stdexec::sync_wait(renderer->RenderAsync(viewport, large_tiles, 2));
+
+    ASSERT_TRUE(result1.has_value());
+    ASSERT_TRUE(result2.has_value());
+
+    auto render_result1 = std::get<0>(result1.value());
+    auto render_result2 = std::get<0>(result2.value());
+
+    ASSERT_EQ(render_result1.pixel_data.size(), render_settings.height);
+    ASSERT_EQ(render_result2.pixel_data.size(), render_settings.height);
+
+    for (size_t y = 0; y < render_settings.height; ++y) {
+        for (size_t x = 0; x < render_settings.width; ++x) {
+            EXPECT_EQ(render_result1.pixel_data[y][x], render_result2.pixel_data[y][x]);
+        }
+    }
+}
+
+TEST_F(MandelbrotRendererTest, RenderAsync_InteriorChecksDoNotChangeResult) {
+    // A/B: ускорения для внутренних точек не меняют изображение
+    auto with_checks = render_settings;
+    with_checks.interior_checks = mandelbrot::InteriorChecks{.cardioid_bulb = true, .periodicity = true};
+    auto without_checks = render_settings;
+    without_checks.interior_checks = mandelbrot::InteriorChecks{};
+
+    auto result1 = stdexec::sync_wait(renderer->RenderAsync(viewport, with_checks, 2));
+    auto result2 = stdexec::sync_wait(renderer->RenderAsync(viewport, without_checks, 2));
+
+    ASSERT_TRUE(result1.has_value());
+    ASSERT_TRUE(result2.has_value());
+
+    auto render_result1 = std::get<0>(result1.value());
+    auto render_result2 = std::get<0>(result2.value());
+
+    for (size_t y = 0; y < render_settings.height; ++y) {
+        for (size_t x = 0; x < render_settings.width; ++x) {
+            EXPECT_EQ(render_result1.pixel_data[y][x], render_result2.pixel_data[y][x]);
+        }
+    }
+}
+
+TEST_F(MandelbrotRendererTest, RenderAsync_DeepZoomUsesPerturbation) {
+    // На глубине, недоступной double, рендерер сам переключается на метод возмущений
+    const mandelbrot::FixedPointComplex center{mandelbrot::FixedPoint{0.0}, mandelbrot::FixedPoint{1.0}};
+    const auto deep_viewport = mandelbrot::MakeViewPort(center, 1e-30, 1e-30);
+    auto settings = render_settings;
+    settings.max_iterations = 1000;
+
+    auto result = stdexec::sync_wait(renderer->RenderAsync(deep_viewport, settings, 2));
+    ASSERT_TRUE(result.has_value());
+    auto render_result = std::get<0>(result.value());
+
+    PixelMatrix expected_pixels(settings.width, settings.height);
+    ColorMatrix expected_colors(settings.width, settings.height);
+    const RenderTarget expected_target{expected_pixels.View(), expected_colors.View()};
+    PerturbationRenderer{deep_viewport, settings, expected_target}.Render();
+
+    // Изображение не вырождается в один цвет и совпадает с последовательным расчётом
+    bool found_difference = false;
+    for (size_t y = 0; y < settings.height; ++y) {
+        for (size_t x = 0; x < settings.width; ++x) {
+            EXPECT_EQ(render_result.pixel_data[y][x], expected_pixels[y][x]);
+            found_difference |= render_result.pixel_data[y][x] != render_result.pixel_data[0][0];
+        }
+    }
+    EXPECT_TRUE(found_difference);
+}
+
+TEST_F(MandelbrotRendererTest, RenderAsync_IntermediateZoomUsesDoubleDouble) {
+    // Между пределом double и глубиной возмущений кадр считается ядром double-double;
+    // подразбиение в этом диапазоне не применяется
+    const mandelbrot::FixedPointComplex center{mandelbrot::FixedPoint{0.0}, mandelbrot::FixedPoint{1.0}};
+    const auto viewport = mandelbrot::MakeViewPort(center, 1e-20, 1e-20);
+    auto settings = render_settings;
+    settings.max_iterations = 1000;
+    settings.mode = RenderMode::MARIANI_SILVER;
+    ASSERT_EQ(mandelbrot::SelectPrecision(viewport, settings.width, settings.height),
+              mandelbrot::Precision::DOUBLE_DOUBLE);
+
+    auto result = stdexec::sync_wait(renderer->RenderAsync(viewport, settings, 2));
+    ASSERT_TRUE(result.has_value());
+    auto render_result = std::get<0>(result.value());
+
+    PixelMatrix expected_pixels(settings.width, settings.height);
+    ColorMatrix expected_colors(settings.width, settings.height);
+    RenderRegion(viewport, settings, PixelRegion{0, settings.height, 0, settings.width},
+                 RenderTarget{expected_pixels.View(), expected_colors.View()}, mandelbrot::Precision::DOUBLE_DOUBLE);
+
+    bool found_difference = false;
+    for (size_t y = 0; y < settings.height; ++y) {
+        for (size_t x = 0; x < settings.width; ++x) {
+            EXPECT_EQ(render_result.pixel_data[y][x], expected_pixels[y][x]);
+            found_difference |= render_result.pixel_data[y][x] != render_result.pixel_data[0][0];
+        }
+    }
+    EXPECT_TRUE(found_difference);
+}
+
+TEST_F(MandelbrotRendererTest, RenderAsync_PanReusesPreviousFrame) {
+    // Сдвиг на целое число пикселей: результат совпадает с полным расчётом нового вида
+    const double pixel = viewport.width() / render_settings.width;
+    const mandelbrot::ViewPort panned{viewport.x_min + 10 * pixel, viewport.x_max + 10 * pixel,
+                                      viewport.y_min - 4 * pixel, viewport.y_max - 4 * pixel};
+
+    ASSERT_TRUE(stdexec::sync_wait(renderer->RenderAsync(viewport, render_settings, 2)).has_value());
+    auto reused = stdexec::sync_wait(renderer->RenderAsync(panned, render_settings, 2));
+    ASSERT_TRUE(reused.has_value());
+
+    MandelbrotRenderer fresh_renderer{2};
+    auto expected = stdexec::sync_wait(fresh_renderer.RenderAsync(panned, render_settings, 2));
+    ASSERT_TRUE(expected.has_value());
+
+    const auto &reused_pixels = std::get<0>(reused.value()).pixel_data;
+    const auto &expected_pixels = std::get<0>(expected.value()).pixel_data;
+    for (size_t y = 0; y < render_settings.height; ++y) {
+        for (size_t x = 0; x < render_settings.width; ++x) {
+            EXPECT_EQ(reused_pixels[y][x], expected_pixels[y][x]) << "x=" << x << " y=" << y;
+        }
+    }
+}
+
+TEST_F(MandelbrotRendererTest, Preview_ResamplesLastFrame) {
+    EXPECT_FALSE(renderer->Preview(viewport, render_settings).has_value());
+
+    auto result = stdexec::sync_wait(renderer->RenderAsync(viewport, render_settings, 2));
+    ASSERT_TRUE(result.has_value());
+
+    // Превью того же вида повторяет последний кадр
+    const auto preview = renderer->Preview(viewport, render_settings);
+    ASSERT_TRUE(preview.has_value());
+    const auto &frame = std::get<0>(result.value());
+    for (size_t y = 0; y < render_settings.height; ++y) {
+        for (size_t x = 0; x < render_settings.width; ++x) {
+            EXPECT_EQ(preview->pixel_data[y][x], frame.pixel_data[y][x]);
+        }
+    }
+
+    EXPECT_TRUE(renderer->Preview(mandelbrot::ViewPort{-1.6, 1.6, -1.6, 1.6}, render_settings).has_value());
+}
+
+TEST_F(MandelbrotRendererTest, RenderProgressiveAsync_EmitsEachPass) {
+    std::mutex passes_mutex;
+    std::vector<RenderResult> passes;
+    auto on_pass = [&](const RenderResult &pass) {
+        const std::lock_guard lock{passes_mutex};
+        passes.push_back(pass);
+    };
+
+    auto result = stdexec::sync_wait(renderer->RenderProgressiveAsync(viewport, render_settings, on_pass, 2));
+    ASSERT_TRUE(result.has_value());
+    const auto &frame = std::get<0>(result.value());
+    ASSERT_EQ(passes.size(), PROGRESSIVE_PASS_STEPS.size());
+
+    // Последний проход — полный кадр, совпадающий с обычным рендерингом
+    MandelbrotRenderer full_renderer{2};
+    auto expected = stdexec::sync_wait(full_renderer.RenderAsync(viewport, render_settings, 2));
+    ASSERT_TRUE(expected.has_value());
+    const auto &expected_pixels = std::get<0>(expected.value()).pixel_data;
+    for (size_t y = 0; y < render_settings.height; ++y) {
+        for (size_t x = 0; x < render_settings.width; ++x) {
+            EXPECT_EQ(frame.pixel_data[y][x], expected_pixels[y][x]);
+            EXPECT_EQ(passes.back().pixel_data[y][x], expected_pixels[y][x]);
+        }
+    }
+}
+
+TEST_F(MandelbrotRendererTest, CancelFrame_StopsProgressiveRender) {
+    std::size_t passes = 0;
+    auto on_pass = [&](const RenderResult &) {
+        ++passes;
+        renderer->CancelFrame();
+    };
+
+    // Отмена после первого прохода: следующие проходы не запускаются, кадр не отдаётся
+    auto result = stdexec::sync_wait(renderer->RenderProgressiveAsync(viewport, render_settings, on_pass, 2));
+    EXPECT_FALSE(result.has_value());
+    EXPECT_EQ(passes, 1);
+
+    // Отмена относится только к тому кадру: следующий считается полностью
+    EXPECT_TRUE(stdexec::sync_wait(renderer->RenderAsync(viewport, render_settings, 2)).has_value());
+}
+
+TEST_F(MandelbrotRendererTest, NewFrameSupersedesRunningFrame) {
+    const mandelbrot::ViewPort zoomed{-1.0, 0.0, -0.5, 0.5};
+    std::latch superseding_done{1};
+    std::optional<RenderResult> superseding;
+
+    // Кадр нового вида запускается, пока старый ещё между проходами, и вытесняет его
+    auto on_pass = [&](const RenderResult &) {
+        stdexec::start_detached(renderer->RenderAsync(zoomed, render_settings, 1) |
+                                stdexec::then([&](RenderResult frame) {
+                                    superseding = std::move(frame);
+                                    superseding_done.count_down();
+                                }));
+    };
+
+    auto result = stdexec::sync_wait(renderer->RenderProgressiveAsync(viewport, render_settings, on_pass, 2));
+    superseding_done.wait();
+    EXPECT_FALSE(result.has_value());
+    ASSERT_TRUE(superseding.has_value());
+
+    auto expected = stdexec::sync_wait(renderer->RenderAsync(zoomed, render_settings, 2));
+    ASSERT_TRUE(expected.has_value());
+    const auto &expected_pixels = std::get<0>(expected.value()).pixel_data;
+    for (size_t y = 0; y < render_settings.height; ++y) {
+        for (size_t x = 0; x < render_settings.width; ++x) {
+            EXPECT_EQ(superseding->pixel_data[y][x], expected_pixels[y][x]);
+        }
+    }
+}
+
+TEST_F(MandelbrotRendererTest, RenderAsync_PartitionsSetAtRuntime) {
+    // По умолчанию кадр делится по числу потоков пула; число задач можно задать для вызова
+    EXPECT_EQ(renderer->ThreadCount(), 2);
+    auto by_default = stdexec::sync_wait(renderer->RenderAsync(viewport, render_settings));
+    ASSERT_TRUE(by_default.has_value());
+
+    for (const std::uint32_t partitions : {1U, 3U, 16U}) {
+        auto result = stdexec::sync_wait(renderer->RenderAsync(viewport, render_settings, partitions));
+        ASSERT_TRUE(result.has_value());
+        const auto &expected = std::get<0>(by_default.value()).pixel_data;
+        const auto &pixels = std::get<0>(result.value()).pixel_data;
+        for (size_t y = 0; y < render_settings.height; ++y) {
+            for (size_t x = 0; x < render_settings.width; ++x) {
+                EXPECT_EQ(pixels[y][x], expected[y][x]) << "partitions=" << partitions;
+            }
+        }
+    }
+}
+
+TEST_F(MandelbrotRendererTest, RenderAsync_WithoutColorizeSkipsColors) {
+    auto colored = stdexec::sync_wait(renderer->RenderAsync(viewport, render_settings, 2));
+    ASSERT_TRUE(colored.has_value());
+
+    // Кадр только с итерациями: буфер цветов не выделяется, итерации те же
+    RenderSettings iterations_only = render_settings;
+    iterations_only.colorize = false;
+    MandelbrotRenderer fresh_renderer{2};
+    auto result = stdexec::sync_wait(fresh_renderer.RenderAsync(viewport, iterations_only, 2));
+    ASSERT_TRUE(result.has_value());
+
+    const auto &frame = std::get<0>(result.value());
+    EXPECT_TRUE(frame.color_data.empty());
+    const auto &expected = std::get<0>(colored.value()).pixel_data;
+    for (size_t y = 0; y < render_settings.height; ++y) {
+        for (size_t x = 0; x < render_settings.width; ++x) {
+            EXPECT_EQ(frame.pixel_data[y][x], expected[y][x]);
+        }
+    }
+}
+
+TEST_F(MandelbrotRendererTest, RecolorLastFrame_MatchesRenderWithNewColoring) {
+    const ColorSettings fire{.palette = PaletteKind::FIRE, .mode = ColoringMode::CYCLIC, .cycle_offset = 7};
+    EXPECT_FALSE(renderer->RecolorLastFrame(fire).has_value());
+
+    ASSERT_TRUE(stdexec::sync_wait(renderer->RenderAsync(viewport, render_settings, 2)).has_value());
+    const auto recolored = renderer->RecolorLastFrame(fire);
+    ASSERT_TRUE(recolored.has_value());
+    EXPECT_EQ(recolored->settings.coloring, fire);
+
+    // Перекраска без пересчёта совпадает с рендерингом в новой раскраске
+    RenderSettings fire_settings = render_settings;
+    fire_settings.coloring = fire;
+    MandelbrotRenderer fresh_renderer{2};
+    auto expected = stdexec::sync_wait(fresh_renderer.RenderAsync(viewport, fire_settings, 2));
+    ASSERT_TRUE(expected.has_value());
+    const auto &expected_colors = std::get<0>(expected.value()).color_data;
+    for (size_t y = 0; y < render_settings.height; ++y) {
+        for (size_t x = 0; x < render_settings.width; ++x) {
+            EXPECT_EQ(recolored->color_data[y][x].r, expected_colors[y][x].r);
+            EXPECT_EQ(recolored->color_data[y][x].g, expected_colors[y][x].g);
+            EXPECT_EQ(recolored->color_data[y][x].b, expected_colors[y][x].b);
+        }
+    }
+}
+
+TEST_F(MandelbrotRendererTest, RenderAsync_ReturnToViewUsesTileCache) {
+    // Шаг пикселя 1/64 лежит на сетке кэша: кадр 128x128 покрывает 2x2 плитки
+    const RenderSettings settings{.width = 128, .height = 128, .max_iterations = 50, .escape_radius = 2.0};
+    const mandelbrot::ViewPort home{-2.0, 0.0, -1.0, 1.0};
+
+    auto first = stdexec::sync_wait(renderer->RenderAsync(home, settings, 2));
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(renderer->Cache().Stats().tiles, 4u);
+
+    // Приближение и возврат: второй кадр исходного вида целиком берётся из кэша
+    ASSERT_TRUE(stdexec::sync_wait(renderer->RenderAsync(mandelbrot::ViewPort{-1.0, -0.5, -0.25, 0.25}, settings, 2))
+                    .has_value());
+    auto second = stdexec::sync_wait(renderer->RenderAsync(home, settings, 2));
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(renderer->Cache().Stats().hits, 4u);
+
+    const auto &expected = std::get<0>(first.value()).pixel_data;
+    const auto &cached = std::get<0>(second.value()).pixel_data;
+    for (size_t y = 0; y < settings.height; ++y) {
+        for (size_t x = 0; x < settings.width; ++x) {
+            EXPECT_EQ(cached[y][x], expected[y][x]) << "x=" << x << " y=" << y;
+        }
+    }
+}
+
+TEST_F(MandelbrotRendererTest, RenderAsync_CachedFrameMatchesFreshRenderWithOtherSettings) {
+    // Режим и размер плитки не входят в ключ кэша: кадр из плиток, посчитанных с другими значениями,
+    // должен совпасть с кадром, посчитанным заново
+    const RenderSettings settings{.width = 128, .height = 128, .max_iterations = 50, .escape_radius = 2.0};
+    auto other = settings;
+    other.mode = RenderMode::MARIANI_SILVER;
+    other.tile_size = 16;
+    const mandelbrot::ViewPort home{-2.0, 0.0, -1.0, 1.0};
+
+    ASSERT_TRUE(stdexec::sync_wait(renderer->RenderAsync(home, settings, 2)).has_value());
+    ASSERT_TRUE(stdexec::sync_wait(renderer->RenderAsync(mandelbrot::ViewPort{-1.0, -0.5, -0.25, 0.25}, other, 2))
+                    .has_value());
+    auto cached = stdexec::sync_wait(renderer->RenderAsync(home, other, 2));
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_EQ(renderer->Cache().Stats().hits, 4u);
+
+    MandelbrotRenderer fresh_renderer{2};
+    auto fresh = stdexec::sync_wait(fresh_renderer.RenderAsync(home, other, 2));
+    ASSERT_TRUE(fresh.has_value());
+
+    const auto &actual = std::get<0>(cached.value());
+    const auto &expected = std::get<0>(fresh.value());
+    for (size_t y = 0; y < settings.height; ++y) {
+        for (size_t x = 0; x < settings.width; ++x) {
+            EXPECT_EQ(actual.pixel_data[y][x], expected.pixel_data[y][x]) << "x=" << x << " y=" << y;
+            EXPECT_EQ(actual.color_data[y][x].r, expected.color_data[y][x].r);
+            EXPECT_EQ(actual.color_data[y][x].g, expected.color_data[y][x].g);
+            EXPECT_EQ(actual.color_data[y][x].b, expected.color_data[y][x].b);
+        }
+    }
+}
+
+TEST_F(MandelbrotRendererTest, RenderAsync_FillsRenderStats) {
+    auto result = stdexec::sync_wait(renderer->RenderAsync(viewport, render_settings, 3));
+    ASSERT_TRUE(result.has_value());
+    const auto &frame = std::get<0>(result.value());
+    const auto &stats = frame.stats;
+
+    // Каждый пиксель кадра либо убежал, либо внутренний; плитки покрывают весь кадр
+    EXPECT_EQ(stats.escaped_pixels + stats.interior_pixels, render_settings.width * render_settings.height);
+    EXPECT_EQ(stats.reused_pixels, 0u);
+    EXPECT_GT(stats.iterations, 0u);
+    EXPECT_EQ(stats.worker_busy.size(), 3u);
+    ASSERT_FALSE(stats.tiles.empty());
+    std::uint64_t tile_pixels = 0;
+    for (const auto &tile : stats.tiles) {
+        EXPECT_LT(tile.worker, 3u);
+        tile_pixels += std::uint64_t{tile.region.end_row - tile.region.start_row} *
+                       (tile.region.end_col - tile.region.start_col);
+    }
+    EXPECT_EQ(tile_pixels, render_settings.width * render_settings.height);
+
+    // Сдвинутый вид: часть пикселей берётся из предыдущего кадра
+    const double step = viewport.width() / render_settings.width;
+    const mandelbrot::ViewPort shifted{viewport.x_min + 10 * step, viewport.x_max + 10 * step, viewport.y_min,
+                                       viewport.y_max};
+    auto panned = stdexec::sync_wait(renderer->RenderAsync(shifted, render_settings, 3));
+    ASSERT_TRUE(panned.has_value());
+    EXPECT_EQ(std::get<0>(panned.value()).stats.reused_pixels, (render_settings.width - 10) * render_settings.height);
+}
+
+TEST_F(MandelbrotRendererTest, RenderAsync_SupersamplesOnlyEdgePixels) {
+    auto plain = stdexec::sync_wait(renderer->RenderAsync(viewport, render_settings, 3, FrameKind::INDEPENDENT));
+    auto smooth_settings = render_settings;
+    smooth_settings.supersampling.grid = 4;
+    auto smooth = stdexec::sync_wait(renderer->RenderAsync(viewport, smooth_settings, 3, FrameKind::INDEPENDENT));
+    ASSERT_TRUE(plain.has_value());
+    ASSERT_TRUE(smooth.has_value());
+    const auto &expected = std::get<0>(plain.value());
+    const auto &frame = std::get<0>(smooth.value());
+
+    // Итерации не меняются; цвета меняются только у пикселей-границ, и их столько, сколько насчитала статистика
+    std::uint64_t edges = 0;
+    const auto pixels = std::as_const(frame.pixel_data).View();
+    for (std::uint32_t y = 0; y < render_settings.height; ++y) {
+        for (std::uint32_t x = 0; x < render_settings.width; ++x) {
+            EXPECT_EQ(frame.pixel_data[y][x], expected.pixel_data[y][x]) << "x=" << x << " y=" << y;
+            if (IsEdgePixel(pixels, x, y, smooth_settings.supersampling.threshold)) {
+                ++edges;
+            } else {
+                EXPECT_EQ(frame.color_data[y][x].r, expected.color_data[y][x].r) << "x=" << x << " y=" << y;
+                EXPECT_EQ(frame.color_data[y][x].g, expected.color_data[y][x].g) << "x=" << x << " y=" << y;
+                EXPECT_EQ(frame.color_data[y][x].b, expected.color_data[y][x].b) << "x=" << x << " y=" << y;
+            }
+        }
+    }
+    EXPECT_GT(edges, 0u);
+    EXPECT_EQ(frame.stats.supersampled_pixels, edges);
+    EXPECT_EQ(expected.stats.supersampled_pixels, 0u);
+}
@@ -1,5 +1,7 @@
+#include "fan_out.hpp"
 #include "mandelbrot_sender.hpp"
 #include "types.hpp"
+#include <exec/static_thread_pool.hpp>
 #include <gtest/gtest.h>
 #include <stdexec/execution.hpp>
 
@@ -187,3 +189,61 @@ TEST_F(MandelbrotSenderTest, MandelbrotSender_Consistency) {
         }
     }
 }
+
+TEST_F(MandelbrotSenderTest, FanOut_WritesIntoSharedBuffer) {
+    // Рабочая задача пишет область напрямую в общий буфер кадра
+    PixelMatrix pixels(settings.width, settings.height);
+    ColorMatrix colors(settings.width, settings.height);
+    PixelRegion sub_region{.start_row = 10, .end_row = 20, .start_col = 5, .end_col = 30};
+    const RenderTarget target{pixels.View(sub_region), colors.View(sub_region)};
+
+    exec::static_thread_pool pool{1};
+    auto sender =
+        MakeFanOutSender(pool.get_scheduler(), 1, [this, sub_region, target](std::uint32_t, auto should_stop) {
+            return RenderRegionRows(mandelbrot::Flattened(viewport), settings, sub_region, target, should_stop);
+        });
+    ASSERT_TRUE(stdexec::sync_wait(std::move(sender)).has_value());
+
+    auto reference = stdexec::sync_wait(MakeMandelbrotSender(viewport, settings, sub_region));
+    ASSERT_TRUE(reference.has_value());
+    auto reference_result = std::get<0>(reference.value());
+
+    for (std::uint32_t y = sub_region.start_row; y < sub_region.end_row; ++y) {
+        for (std::uint32_t x = sub_region.start_col; x < sub_region.end_col; ++x) {
+            const auto local_y = y - sub_region.start_row;
+            const auto local_x = x - sub_region.start_col;
+            EXPECT_EQ(pixels[y][x], reference_result.pixel_data[local_y][local_x]);
+            EXPECT_EQ(colors[y][x].g, reference_result.color_data[local_y][local_x].g);
+        }
+    }
+
+    // Пиксели вне области не затронуты
+    EXPECT_EQ(pixels[0][0], 0);
+    EXPECT_EQ(pixels[sub_region.end_row][sub_region.start_col], 0);
+}
+
+TEST_F(MandelbrotSenderTest, FanOut_RenderTilesStopsOnFrameToken) {
+    PixelMatrix pixels(settings.width, settings.height);
+    ColorMatrix colors(settings.width, settings.height);
+    TileQueue tiles{settings.width, settings.height, 10};
+    const RenderTarget target{pixels.View(), colors.View()};
+
+    // Отмена запрошена до запуска: рабочие задачи не считают ни одной плитки, и операция завершается set_stopped
+    stdexec::inplace_stop_source frame_stop;
+    frame_stop.request_stop();
+    exec::static_thread_pool pool{2};
+    auto sender = MakeFanOutSender(
+        pool.get_scheduler(), 2,
+        [this, &tiles, target](std::uint32_t, auto should_stop) {
+            return RenderTiles(mandelbrot::Flattened(viewport), settings, tiles, target, mandelbrot::Precision::DOUBLE,
+                               should_stop);
+        },
+        frame_stop.get_token());
+
+    EXPECT_FALSE(stdexec::sync_wait(std::move(sender)).has_value());
+    for (std::uint32_t y = 0; y < settings.height; ++y) {
+        for (std::uint32_t x = 0; x < settings.width; ++x) {
+            EXPECT_EQ(pixels[y][x], 0);
+        }
+    }
+}
@@ -0,0 +1,162 @@
+#include "mandelbrot_simd.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace mandelbrot;
+
+class MandelbrotSimdTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        viewport = ViewPort{-2.5, 1.5, -2.0, 2.0};
+        // Нечётная ширина, чтобы последняя порция не делилась на число дорожек
+        for (std::uint32_t y = 0; y < 61; ++y) {
+            for (std::uint32_t x = 0; x < 83; ++x) {
+                points.push_back(Pixel2DToComplex(x, y, viewport, 83, 61));
+            }
+        }
+    }
+
+    ViewPort viewport;
+    std::vector<Complex> points;
+};
+
+TEST_F(MandelbrotSimdTest, AllIsa_MatchScalarReference) {
+    for (std::uint32_t max_iterations : {1u, 7u, 100u, 500u}) {
+        std::vector<std::uint32_t> reference(points.size());
+        simd::CalculateIterationsScalar(points, reference, max_iterations, 2.0);
+
+        for (auto isa : {simd::Isa::SSE2, simd::Isa::AVX2, simd::Isa::AVX512}) {
+            if (!simd::IsSupported(isa)) {
+                continue;
+            }
+
+            std::vector<std::uint32_t> iterations(points.size());
+            simd::CalculateIterations(points, iterations, max_iterations, 2.0, isa);
+
+            EXPECT_EQ(iterations, reference) << simd::IsaName(isa) << ", max_iterations = " << max_iterations;
+        }
+    }
+}
+
+TEST_F(MandelbrotSimdTest, AllIsa_InteriorChecksMatchScalarReference) {
+    for (const auto checks : {InteriorChecks{.cardioid_bulb = true, .periodicity = false},
+                              InteriorChecks{.cardioid_bulb = false, .periodicity = true},
+                              InteriorChecks{.cardioid_bulb = true, .periodicity = true}}) {
+        std::vector<std::uint32_t> reference(points.size());
+        simd::CalculateIterationsScalar(points, reference, 500, 2.0, checks);
+
+        for (auto isa : {simd::Isa::SSE2, simd::Isa::AVX2, simd::Isa::AVX512}) {
+            if (!simd::IsSupported(isa)) {
+                continue;
+            }
+
+            std::vector<std::uint32_t> iterations(points.size());
+            simd::CalculateIterations(points, iterations, 500, 2.0, isa, checks);
+
+            EXPECT_EQ(iterations, reference) << simd::IsaName(isa) << ", cardioid_bulb = " << checks.cardioid_bulb
+                                             << ", periodicity = " << checks.periodicity;
+        }
+    }
+}
+
+TEST_F(MandelbrotSimdTest, ScalarReference_MatchesCalculateIterationsForPoint) {
+    std::vector<std::uint32_t> iterations(points.size());
+    simd::CalculateIterationsScalar(points, iterations, 100, 2.0);
+
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        EXPECT_EQ(iterations[i], CalculateIterationsForPoint(points[i], 100, 2.0));
+    }
+}
+
+TEST_F(MandelbrotSimdTest, DefaultDispatch_MatchesScalar) {
+    std::vector<std::uint32_t> reference(points.size());
+    std::vector<std::uint32_t> iterations(points.size());
+
+    simd::CalculateIterationsScalar(points, reference, 100, 2.0);
+    simd::CalculateIterations(points, iterations, 100, 2.0);
+
+    EXPECT_EQ(iterations, reference);
+}
+
+TEST_F(MandelbrotSimdTest, FewerPointsThanLanes) {
+    // Точек меньше, чем дорожек в векторе: свободные дорожки не должны ничего записывать
+    std::vector<Complex> few{{0.0, 0.0}, {2.0, 0.0}, {-0.75, 0.1}};
+    std::vector<std::uint32_t> iterations(few.size());
+
+    simd::CalculateIterations(few, iterations, 100, 2.0);
+
+    EXPECT_EQ(iterations[0], 100);
+    EXPECT_EQ(iterations[1], CalculateIterationsForPoint(few[1], 100, 2.0));
+    EXPECT_EQ(iterations[2], CalculateIterationsForPoint(few[2], 100, 2.0));
+}
+
+TEST_F(MandelbrotSimdTest, EmptyInput) {
+    std::vector<Complex> empty;
+    std::vector<std::uint32_t> iterations;
+
+    simd::CalculateIterations(empty, iterations, 100, 2.0);
+    EXPECT_TRUE(iterations.empty());
+}
+
+TEST_F(MandelbrotSimdTest, DetectIsa_IsSupported) {
+    EXPECT_TRUE(simd::IsSupported(simd::ActiveIsa()));
+    EXPECT_TRUE(simd::IsSupported(simd::Isa::SCALAR));
+}
+
+TEST_F(MandelbrotSimdTest, Float_AllIsaMatchDoubleReference) {
+    for (const auto checks : {InteriorChecks{.cardioid_bulb = false, .periodicity = false},
+                              InteriorChecks{.cardioid_bulb = true, .periodicity = false},
+                              InteriorChecks{.cardioid_bulb = true, .periodicity = true}}) {
+        for (std::uint32_t max_iterations : {1u, 7u, 100u, 500u}) {
+            std::vector<std::uint32_t> reference(points.size());
+            simd::CalculateIterationsScalar(points, reference, max_iterations, 2.0, checks);
+
+            for (auto isa : {simd::Isa::SCALAR, simd::Isa::SSE2, simd::Isa::AVX2, simd::Isa::AVX512}) {
+                if (!simd::IsSupported(isa)) {
+                    continue;
+                }
+
+                std::vector<std::uint32_t> iterations(points.size());
+                simd::CalculateIterationsFloat(points, iterations, max_iterations, 2.0, isa, checks);
+
+                EXPECT_EQ(iterations, reference)
+                    << simd::IsaName(isa) << ", max_iterations = " << max_iterations
+                    << ", cardioid_bulb = " << checks.cardioid_bulb << ", periodicity = " << checks.periodicity;
+            }
+        }
+    }
+}
+
+TEST_F(MandelbrotSimdTest, FloatPass_AllIsaMatchScalarFloat) {
+    // Векторный проход float повторяет скалярный операция в операцию, включая точки для пересчёта
+    for (const auto checks : {InteriorChecks{}, InteriorChecks{.cardioid_bulb = true, .periodicity = true}}) {
+        std::vector<std::uint32_t> reference(points.size());
+        simd::CalculateIterationsFloatScalar(points, reference, 500, 2.0, checks);
+
+        for (auto isa : {simd::Isa::SSE2, simd::Isa::AVX2, simd::Isa::AVX512}) {
+            if (!simd::IsSupported(isa)) {
+                continue;
+            }
+
+            std::vector<std::uint32_t> iterations(points.size());
+            simd::CalculateIterationsFloatPass(points, iterations, 500, 2.0, isa, checks);
+
+            EXPECT_EQ(iterations, reference) << simd::IsaName(isa) << ", periodicity = " << checks.periodicity;
+        }
+    }
+}
+
+TEST_F(MandelbrotSimdTest, FloatPass_FallsBackOnlyNearBoundary) {
+    // Точка далеко снаружи убегает за пару итераций с точным счётом; точка у границы множества
+    // накапливает ошибку float и уходит в double
+    EXPECT_EQ(CalculateIterationsForPointFloat(Complex{1.0, 1.0}, 100, 2.0, InteriorChecks{}),
+              CalculateIterationsForPoint(Complex{1.0, 1.0}, 100, 2.0));
+    EXPECT_EQ(CalculateIterationsForPointFloat(Complex{-0.75, 0.01}, 10000, 2.0, InteriorChecks{}), FLOAT_FALLBACK);
+
+    std::vector<std::uint32_t> iterations(points.size());
+    simd::CalculateIterationsFloatPass(points, iterations, 500, 2.0, simd::ActiveIsa());
+    const auto fallbacks = std::ranges::count(iterations, FLOAT_FALLBACK);
+    EXPECT_GT(fallbacks, 0);
+    EXPECT_LT(fallbacks, static_cast<std::ptrdiff_t>(points.size() / 2));
+}
@@ -42,6 +42,46 @@ TEST_F(MandelbrotUtilsTest, CalculateIterationsForPoint_EdgeCase) {
     EXPECT_LT(iterations, max_iterations);
 }
 
+TEST_F(MandelbrotUtilsTest, IsInMainCardioidOrBulb_KnownPoints) {
+    // Центр кардиоиды, её внутренняя точка и центр круга периода 2
+    EXPECT_TRUE(IsInMainCardioidOrBulb(Complex{0.0, 0.0}));
+    EXPECT_TRUE(IsInMainCardioidOrBulb(Complex{-0.5, 0.3}));
+    EXPECT_TRUE(IsInMainCardioidOrBulb(Complex{-1.0, 0.0}));
+
+    // Точки вне множества и внутри других компонент не распознаются
+    EXPECT_FALSE(IsInMainCardioidOrBulb(Complex{2.0, 0.0}));
+    EXPECT_FALSE(IsInMainCardioidOrBulb(Complex{0.3, 0.0}));
+    EXPECT_FALSE(IsInMainCardioidOrBulb(Complex{-1.75, 0.0}));
+}
+
+TEST_F(MandelbrotUtilsTest, InteriorChecks_MatchBruteForce) {
+    // Ускоренные проверки не меняют классификацию ни одной точки сетки
+    const InteriorChecks checks{.cardioid_bulb = true, .periodicity = true};
+
+    for (std::uint32_t y = 0; y < 60; ++y) {
+        for (std::uint32_t x = 0; x < 80; ++x) {
+            const auto c = Pixel2DToComplex(x, y, viewport, 80, 60);
+            EXPECT_EQ(CalculateIterationsForPoint(c, max_iterations, escape_radius, checks),
+                      CalculateIterationsForPoint(c, max_iterations, escape_radius));
+        }
+    }
+}
+
+TEST_F(MandelbrotUtilsTest, InteriorChecks_PeriodicityDetectsInteriorOutsideCardioid) {
+    // c = -1.75 лежит в компоненте периода 3, вне кардиоиды и круга периода 2
+    const InteriorChecks checks{.cardioid_bulb = false, .periodicity = true};
+    EXPECT_EQ(CalculateIterationsForPoint(Complex{-1.755, 0.0}, 10000, escape_radius, checks), 10000);
+}
+
+TEST_F(MandelbrotUtilsTest, InteriorChecks_DisabledForSmallEscapeRadius) {
+    // При радиусе убегания меньше 2 внутренние точки могут "убежать", проверки не применяются
+    const InteriorChecks checks{.cardioid_bulb = true, .periodicity = true};
+    const Complex c{-0.5, 0.3};
+
+    EXPECT_EQ(CalculateIterationsForPoint(c, max_iterations, 0.5, checks),
+              CalculateIterationsForPoint(c, max_iterations, 0.5));
+}
+
 TEST_F(MandelbrotUtilsTest, Pixel2DToComplex_CornerCases) {
     // Левый верхний угол
     auto complex1 = Pixel2DToComplex(0, 0, viewport, screen_width, screen_height);
@@ -91,3 +131,45 @@ TEST_F(MandelbrotUtilsTest, RgbColors_Constants) {
     EXPECT_EQ(RgbColors::BLACK.g, 0);
     EXPECT_EQ(RgbColors::BLACK.b, 0);
 }
+
+TEST_F(MandelbrotUtilsTest, Rebased_MovesCenterToOrigin) {
+    // Неглубокий вид не меняется
+    EXPECT_EQ(Rebased(viewport).x_min, viewport.x_min);
+    EXPECT_EQ(Rebased(viewport).origin, FixedPointComplex{});
+
+    // Узкий вид далеко от нуля: центр переносится, пиксели остаются на месте
+    const ViewPort narrow{-0.75 - 1e-9, -0.75 + 1e-9, 0.1 - 1e-9, 0.1 + 1e-9};
+    const ViewPort rebased = Rebased(narrow);
+
+    EXPECT_DOUBLE_EQ(rebased.origin.real.ToDouble(), -0.75);
+    EXPECT_DOUBLE_EQ(rebased.origin.imag.ToDouble(), 0.1);
+    EXPECT_NEAR(rebased.x_min, -1e-9, 1e-16);
+    EXPECT_NEAR(rebased.width(), narrow.width(), 1e-16);
+
+    const ViewPort flattened = Flattened(rebased);
+    EXPECT_EQ(flattened.origin, FixedPointComplex{});
+    EXPECT_DOUBLE_EQ(flattened.x_min, narrow.x_min);
+    EXPECT_DOUBLE_EQ(flattened.y_max, narrow.y_max);
+}
+
+TEST_F(MandelbrotUtilsTest, SelectPrecision_ByPixelSpacing) {
+    EXPECT_EQ(SelectPrecision(viewport, screen_width, screen_height), Precision::DOUBLE);
+
+    const FixedPointComplex center{FixedPoint{-0.75}, FixedPoint{0.1}};
+    EXPECT_EQ(SelectPrecision(MakeViewPort(center, 1e-9, 1e-9), screen_width, screen_height), Precision::DOUBLE);
+    EXPECT_EQ(SelectPrecision(MakeViewPort(center, 1e-13, 1e-13), screen_width, screen_height),
+              Precision::DOUBLE_DOUBLE);
+    EXPECT_EQ(SelectPrecision(MakeViewPort(center, 1e-24, 1e-24), screen_width, screen_height),
+              Precision::DOUBLE_DOUBLE);
+    EXPECT_EQ(SelectPrecision(MakeViewPort(center, 1e-27, 1e-27), screen_width, screen_height),
+              Precision::PERTURBATION);
+}
+
+TEST_F(MandelbrotUtilsTest, FloatPrecisionSuffices_OnlyForShallowViews) {
+    EXPECT_TRUE(FloatPrecisionSuffices(viewport, screen_width, screen_height, 1000));
+    EXPECT_FALSE(FloatPrecisionSuffices(viewport, screen_width, screen_height, FLOAT_MAX_ITERATIONS));
+
+    const FixedPointComplex center{FixedPoint{-0.75}, FixedPoint{0.1}};
+    EXPECT_TRUE(FloatPrecisionSuffices(MakeViewPort(center, 1e-2, 1e-2), screen_width, screen_height, 1000));
+    EXPECT_FALSE(FloatPrecisionSuffices(MakeViewPort(center, 1e-4, 1e-4), screen_width, screen_height, 1000));
+}
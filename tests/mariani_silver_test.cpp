@@ -0,0 +1,80 @@
+#include "mandelbrot_sender.hpp"
+#include "mariani_silver.hpp"
+#include "types.hpp"
+#include <gtest/gtest.h>
+
+class MarianiSilverTest : public ::testing::Test {
+protected:
+    struct Frame {
+        PixelMatrix pixels;
+        ColorMatrix colors;
+
+        Frame(std::uint32_t width, std::uint32_t height) : pixels(width, height), colors(width, height) {}
+        [[nodiscard]] RenderTarget Target() { return RenderTarget{pixels.View(), colors.View()}; }
+    };
+
+    static PixelRegion FullRegion(const RenderSettings &settings) {
+        return PixelRegion{0, settings.height, 0, settings.width};
+    }
+
+    static void ExpectSameFrames(const Frame &expected, const Frame &actual) {
+        ASSERT_EQ(expected.pixels.size(), actual.pixels.size());
+        for (std::size_t y = 0; y < expected.pixels.size(); ++y) {
+            for (std::size_t x = 0; x < expected.pixels[y].size(); ++x) {
+                EXPECT_EQ(expected.pixels[y][x], actual.pixels[y][x]) << "x=" << x << " y=" << y;
+                EXPECT_EQ(expected.colors[y][x].r, actual.colors[y][x].r);
+                EXPECT_EQ(expected.colors[y][x].g, actual.colors[y][x].g);
+                EXPECT_EQ(expected.colors[y][x].b, actual.colors[y][x].b);
+            }
+        }
+    }
+};
+
+TEST_F(MarianiSilverTest, MatchesBruteForce) {
+    // Обзорный вид и приближение к границе множества, где деление доходит до мелких прямоугольников
+    const RenderSettings settings{.width = 320, .height = 240, .max_iterations = 200};
+    for (const auto &viewport : {mandelbrot::ViewPort{-2.5, 1.0, -1.5, 1.5},
+                                 mandelbrot::ViewPort{-0.75, -0.73, 0.1, 0.12}}) {
+        Frame expected{settings.width, settings.height};
+        Frame actual{settings.width, settings.height};
+
+        RenderRegion(viewport, settings, FullRegion(settings), expected.Target());
+        MarianiSilver{viewport, settings, actual.Target()}.Render(FullRegion(settings));
+
+        ExpectSameFrames(expected, actual);
+    }
+}
+
+TEST_F(MarianiSilverTest, UniformBorderIsFilled) {
+    // Область целиком внутри главной кардиоиды: граница однородна, внутренность заливается
+    const RenderSettings settings{.width = 64, .height = 64, .max_iterations = 100};
+    const mandelbrot::ViewPort viewport{-0.2, 0.0, -0.1, 0.1};
+    Frame frame{settings.width, settings.height};
+
+    MarianiSilver{viewport, settings, frame.Target()}.Render(FullRegion(settings));
+
+    for (std::size_t y = 0; y < frame.pixels.size(); ++y) {
+        for (const auto iterations : frame.pixels[y]) {
+            EXPECT_EQ(iterations, settings.max_iterations);
+        }
+    }
+}
+
+TEST_F(MarianiSilverTest, LargeHalvesAreSpawned) {
+    // Половины площадью не меньше MARIANI_SILVER_TASK_AREA передаются в spawn, мелкие обрабатываются на месте
+    const RenderSettings settings{.width = 256, .height = 256, .max_iterations = 50};
+    const mandelbrot::ViewPort viewport{-2.0, 2.0, -2.0, 2.0};
+    Frame frame{settings.width, settings.height};
+    const MarianiSilver renderer{viewport, settings, frame.Target()};
+
+    std::vector<PixelRegion> spawned;
+    renderer.ComputeBorder(FullRegion(settings));
+    renderer.Subdivide(FullRegion(settings), [&](const PixelRegion &half) { spawned.push_back(half); });
+
+    ASSERT_EQ(spawned.size(), 2);
+    for (const auto &half : spawned) {
+        EXPECT_GE(half.width() * half.height(), MARIANI_SILVER_TASK_AREA);
+    }
+    // Линия раздела принадлежит обеим половинам
+    EXPECT_EQ(spawned[0].end_col - 1, spawned[1].start_col);
+}
@@ -0,0 +1,88 @@
+#include "palette.hpp"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace mandelbrot;
+
+class PaletteTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Нечётная длина, чтобы хвост строки не делился на число дорожек; есть значения больше max_iterations
+        for (std::uint32_t i = 0; i < 203; ++i) {
+            iterations.push_back((i * 37) % (MAX_ITERATIONS + 20));
+        }
+    }
+
+    static constexpr std::uint32_t MAX_ITERATIONS = 150;
+    std::vector<std::uint32_t> iterations;
+};
+
+TEST_F(PaletteTest, MatchesIterationsToColor) {
+    const Palette palette{MAX_ITERATIONS};
+    ASSERT_EQ(palette.Colors().size(), MAX_ITERATIONS + 1);
+
+    for (std::uint32_t i = 0; i <= MAX_ITERATIONS; ++i) {
+        const auto expected = IterationsToColor(i, MAX_ITERATIONS);
+        EXPECT_EQ(palette[i].r, expected.r) << "iterations=" << i;
+        EXPECT_EQ(palette[i].g, expected.g) << "iterations=" << i;
+        EXPECT_EQ(palette[i].b, expected.b) << "iterations=" << i;
+        EXPECT_EQ(palette[i].a, 255);
+    }
+    // Значения за пределами таблицы раскрашиваются как точки множества
+    EXPECT_EQ(palette[MAX_ITERATIONS + 5].r, RgbColors::BLACK.r);
+}
+
+TEST_F(PaletteTest, AllIsa_ColorizeMatchesLookup) {
+    const Palette palette{MAX_ITERATIONS};
+
+    for (auto isa : {simd::Isa::SCALAR, simd::Isa::SSE2, simd::Isa::AVX2, simd::Isa::AVX512}) {
+        if (!simd::IsSupported(isa)) {
+            continue;
+        }
+        std::vector<RgbColor> colors(iterations.size(), RgbColor{1, 2, 3, 4});
+        simd::Colorize(iterations, palette.Colors(), colors, isa);
+
+        for (std::size_t i = 0; i < iterations.size(); ++i) {
+            const auto expected = palette[iterations[i]];
+            EXPECT_EQ(colors[i].r, expected.r) << simd::IsaName(isa) << ", i=" << i;
+            EXPECT_EQ(colors[i].g, expected.g) << simd::IsaName(isa) << ", i=" << i;
+            EXPECT_EQ(colors[i].b, expected.b) << simd::IsaName(isa) << ", i=" << i;
+            EXPECT_EQ(colors[i].a, expected.a) << simd::IsaName(isa) << ", i=" << i;
+        }
+    }
+}
+
+TEST_F(PaletteTest, CachedPalette_RebuiltOnMaxIterationsChange) {
+    EXPECT_EQ(CachedPalette(100).MaxIterations(), 100);
+    EXPECT_EQ(&CachedPalette(100), &CachedPalette(100));
+    EXPECT_EQ(CachedPalette(300).MaxIterations(), 300);
+    EXPECT_EQ(CachedPalette(300)[300].r, RgbColors::BLACK.r);
+}
+
+TEST_F(PaletteTest, Coloring_OffsetAndCycle) {
+    const Palette normalized{MAX_ITERATIONS};
+    const Palette shifted{MAX_ITERATIONS, ColorSettings{.cycle_offset = 10}};
+    const Palette cyclic{MAX_ITERATIONS, ColorSettings{.mode = ColoringMode::CYCLIC}};
+
+    for (std::uint32_t i = 0; i + 10 < MAX_ITERATIONS; ++i) {
+        EXPECT_EQ(shifted[i].g, normalized[i + 10].g) << "iterations=" << i;
+    }
+    for (std::uint32_t i = 0; i + PALETTE_CYCLE_LENGTH < MAX_ITERATIONS; ++i) {
+        EXPECT_EQ(cyclic[i].r, cyclic[i + PALETTE_CYCLE_LENGTH].r) << "iterations=" << i;
+        EXPECT_EQ(cyclic[i].b, cyclic[i + PALETTE_CYCLE_LENGTH].b) << "iterations=" << i;
+    }
+
+    // Точки множества чёрные при любой палитре и сдвиге
+    for (const auto kind : {PaletteKind::RAINBOW, PaletteKind::FIRE, PaletteKind::GRAYSCALE}) {
+        const Palette palette{MAX_ITERATIONS, ColorSettings{.palette = kind, .cycle_offset = -3}};
+        EXPECT_EQ(palette[MAX_ITERATIONS].r, RgbColors::BLACK.r);
+        EXPECT_EQ(palette[MAX_ITERATIONS].g, RgbColors::BLACK.g);
+        EXPECT_EQ(palette[MAX_ITERATIONS].b, RgbColors::BLACK.b);
+    }
+}
+
+TEST_F(PaletteTest, CachedPalette_RebuiltOnColoringChange) {
+    const ColorSettings fire{.palette = PaletteKind::FIRE};
+    EXPECT_EQ(CachedPalette(100, fire).Coloring(), fire);
+    EXPECT_EQ(CachedPalette(100).Coloring(), ColorSettings{});
+}
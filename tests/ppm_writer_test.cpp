@@ -0,0 +1,59 @@
+#include "ppm_writer.hpp"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+class PpmWriterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = std::filesystem::temp_directory_path() /
+               (std::string{::testing::UnitTest::GetInstance()->current_test_info()->name()} + ".ppm");
+    }
+
+    void TearDown() override { std::filesystem::remove(path); }
+
+    [[nodiscard]] std::string ReadFile() const {
+        std::ifstream file{path, std::ios::binary};
+        return std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    }
+
+    // Полоса rows x 2, цвет пикселя кодирует его координаты в изображении
+    [[nodiscard]] static ColorMatrix Band(std::uint32_t start_row, std::uint32_t rows) {
+        ColorMatrix colors(2, rows);
+        for (std::uint32_t y = 0; y < rows; ++y) {
+            for (std::uint32_t x = 0; x < 2; ++x) {
+                colors[y][x] = mandelbrot::RgbColor{static_cast<std::uint8_t>(start_row + y),
+                                                    static_cast<std::uint8_t>(x), 7, 0};
+            }
+        }
+        return colors;
+    }
+
+    std::filesystem::path path;
+};
+
+TEST_F(PpmWriterTest, WritesBandsInOrder) {
+    PpmWriter writer{path, 2, 3};
+    writer.WriteRows(Band(0, 2));
+    writer.WriteRows(Band(2, 1));
+    EXPECT_EQ(writer.RowsWritten(), 3);
+    writer.Close();
+
+    // Заголовок, затем строки сверху вниз по 3 байта на пиксель без альфа-канала
+    const std::string expected = std::string{"P6\n2 3\n255\n"} +
+                                 std::string{"\x00\x00\x07\x00\x01\x07\x01\x00\x07\x01\x01\x07\x02\x00\x07\x02\x01\x07",
+                                             18};
+    EXPECT_EQ(ReadFile(), expected);
+}
+
+TEST_F(PpmWriterTest, RejectsMismatchedBands) {
+    PpmWriter writer{path, 2, 3};
+    EXPECT_THROW(writer.WriteRows(ColorMatrix(3, 1)), std::runtime_error);
+    writer.WriteRows(Band(0, 2));
+    EXPECT_THROW(writer.WriteRows(Band(2, 2)), std::runtime_error);
+    // Файл без всех строк не считается законченным
+    EXPECT_THROW(writer.Close(), std::runtime_error);
+}
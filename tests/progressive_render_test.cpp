@@ -0,0 +1,108 @@
+#include "mandelbrot_sender.hpp"
+#include "progressive_render.hpp"
+#include "types.hpp"
+#include <gtest/gtest.h>
+
+using namespace mandelbrot;
+
+class ProgressiveRenderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Размеры не кратны шагу грубого прохода и стороне плитки
+        settings = RenderSettings{.width = 103, .height = 77, .max_iterations = 300, .escape_radius = 2.0};
+        settings.tile_size = 30;
+        viewport = ViewPort{-2.0, 1.0, -1.2, 1.2};
+    }
+
+    [[nodiscard]] PixelRegion Frame() const {
+        return PixelRegion{.start_row = 0, .end_row = settings.height, .start_col = 0, .end_col = settings.width};
+    }
+
+    void RunPass(const RenderTarget &target, std::uint32_t pass, Precision precision = Precision::DOUBLE) const {
+        TileQueue tiles{settings.width, settings.height, settings.tile_size};
+        const ProgressivePass progressive{viewport, settings, target, precision, pass};
+        while (const auto tile = tiles.Next()) {
+            progressive.Render(*tile);
+        }
+    }
+
+    RenderSettings settings;
+    ViewPort viewport;
+};
+
+TEST_F(ProgressiveRenderTest, LastPassMatchesFullRender) {
+    PixelMatrix expected_pixels(settings.width, settings.height);
+    ColorMatrix expected_colors(settings.width, settings.height);
+    RenderRegion(viewport, settings, Frame(), RenderTarget{expected_pixels.View(), expected_colors.View()});
+
+    PixelMatrix pixels(settings.width, settings.height);
+    ColorMatrix colors(settings.width, settings.height);
+    const RenderTarget target{pixels.View(), colors.View()};
+    for (std::uint32_t pass = 0; pass < PROGRESSIVE_PASS_STEPS.size(); ++pass) {
+        RunPass(target, pass);
+    }
+
+    for (std::uint32_t y = 0; y < settings.height; ++y) {
+        for (std::uint32_t x = 0; x < settings.width; ++x) {
+            EXPECT_EQ(pixels[y][x], expected_pixels[y][x]) << "x=" << x << " y=" << y;
+            EXPECT_EQ(colors[y][x].r, expected_colors[y][x].r);
+        }
+    }
+}
+
+TEST_F(ProgressiveRenderTest, CoarsePassFillsBlocks) {
+    PixelMatrix expected_pixels(settings.width, settings.height);
+    ColorMatrix expected_colors(settings.width, settings.height);
+    RenderRegion(viewport, settings, Frame(), RenderTarget{expected_pixels.View(), expected_colors.View()});
+
+    // Заглушка отличается от любого числа итераций: после прохода не должно остаться незаполненных пикселей
+    const std::uint32_t unset = settings.max_iterations + 1;
+    PixelMatrix pixels(settings.width, settings.height, unset);
+    ColorMatrix colors(settings.width, settings.height);
+    RunPass(RenderTarget{pixels.View(), colors.View()}, 0);
+
+    const std::uint32_t step = PROGRESSIVE_PASS_STEPS[0];
+    for (std::uint32_t y = 0; y < settings.height; ++y) {
+        for (std::uint32_t x = 0; x < settings.width; ++x) {
+            const std::uint32_t sample_x = x / step * step;
+            const std::uint32_t sample_y = y / step * step;
+            EXPECT_EQ(pixels[y][x], expected_pixels[sample_y][sample_x]) << "x=" << x << " y=" << y;
+        }
+    }
+}
+
+TEST_F(ProgressiveRenderTest, FinerPassesSkipKnownSamples) {
+    // Проход не пересчитывает пиксели грубой сетки: подменённое значение в них сохраняется
+    PixelMatrix pixels(settings.width, settings.height);
+    ColorMatrix colors(settings.width, settings.height);
+    const RenderTarget target{pixels.View(), colors.View()};
+    RunPass(target, 0);
+    pixels[8][12] = 12345;
+
+    RunPass(target, 1);
+    RunPass(target, 2);
+    EXPECT_EQ(pixels[8][12], 12345);
+}
+
+TEST_F(ProgressiveRenderTest, DoubleDoubleMatchesFullRender) {
+    viewport = MakeViewPort(FixedPointComplex{FixedPoint{0.0}, FixedPoint{1.0}}, 1e-18, 1e-18);
+    settings.max_iterations = 1000;
+
+    PixelMatrix expected_pixels(settings.width, settings.height);
+    ColorMatrix expected_colors(settings.width, settings.height);
+    RenderRegion(viewport, settings, Frame(), RenderTarget{expected_pixels.View(), expected_colors.View()},
+                 Precision::DOUBLE_DOUBLE);
+
+    PixelMatrix pixels(settings.width, settings.height);
+    ColorMatrix colors(settings.width, settings.height);
+    const RenderTarget target{pixels.View(), colors.View()};
+    for (std::uint32_t pass = 0; pass < PROGRESSIVE_PASS_STEPS.size(); ++pass) {
+        RunPass(target, pass, Precision::DOUBLE_DOUBLE);
+    }
+
+    for (std::uint32_t y = 0; y < settings.height; ++y) {
+        for (std::uint32_t x = 0; x < settings.width; ++x) {
+            EXPECT_EQ(pixels[y][x], expected_pixels[y][x]) << "x=" << x << " y=" << y;
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#include "render_stats.hpp"
+#include "types.hpp"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace std::chrono_literals;
+
+class RenderStatsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        frame.settings = RenderSettings{.width = 4, .height = 2, .max_iterations = 10, .escape_radius = 2.0};
+        frame.viewport = mandelbrot::ViewPort{-2.0, 2.0, -1.0, 1.0};
+        frame.pixel_data = PixelMatrix(4, 2);
+        // Три внутренних пикселя (max_iterations) и пять убежавших
+        const std::uint32_t iterations[2][4] = {{1, 2, 10, 3}, {10, 10, 4, 5}};
+        for (std::uint32_t y = 0; y < 2; ++y) {
+            for (std::uint32_t x = 0; x < 4; ++x) {
+                frame.pixel_data[y][x] = iterations[y][x];
+            }
+        }
+    }
+
+    RenderResult frame;
+};
+
+TEST_F(RenderStatsTest, CountPixels_SplitsEscapedAndInterior) {
+    CountPixels(frame.stats, frame.pixel_data, frame.settings.max_iterations);
+    EXPECT_EQ(frame.stats.iterations, 45);
+    EXPECT_EQ(frame.stats.escaped_pixels, 5);
+    EXPECT_EQ(frame.stats.interior_pixels, 3);
+    // Убежавшие не раньше max_iterations / 2 = 5: итерации 5; самое долгое убегание — 5 итераций
+    EXPECT_EQ(frame.stats.late_escaped_pixels, 1);
+    EXPECT_EQ(frame.stats.max_escape_iterations, 5);
+    EXPECT_TRUE(HasRenderStats(frame));
+
+    // У кадра без пикселей статистики нет
+    EXPECT_FALSE(HasRenderStats(RenderResult{}));
+}
+
+TEST_F(RenderStatsTest, Collector_MergesTilesAndBusyTimePerWorker) {
+    RenderStatsCollector collector{2};
+    const PixelRegion region{.start_row = 0, .end_row = 1, .start_col = 0, .end_col = 4};
+    collector.TileRecorder(0)(region, 3us);
+    collector.TileRecorder(1)(region, 1us);
+    collector.AddTile(1, region, 2us);
+    collector.AddBusy(0, 4us);
+    collector.AddBusy(1, 2us);
+    collector.AddSupersampled(0, 5);
+    collector.AddSupersampled(1, 7);
+    {
+        const auto timer = collector.TrackBusy(1);
+    }
+
+    RenderStats stats;
+    collector.MergeInto(stats);
+    ASSERT_EQ(stats.tiles.size(), 3);
+    ASSERT_EQ(stats.worker_busy.size(), 2);
+    EXPECT_EQ(stats.tiles[0].worker, 0);
+    EXPECT_EQ(stats.tiles[2].worker, 1);
+    EXPECT_EQ(stats.worker_busy[0], 4us);
+    EXPECT_GE(stats.worker_busy[1], 2us);
+    EXPECT_EQ(stats.supersampled_pixels, 12);
+
+    const auto summary = SummarizeTiles(stats);
+    EXPECT_EQ(summary.min, 1us);
+    EXPECT_EQ(summary.mean, 2us);
+    EXPECT_EQ(summary.max, 3us);
+}
+
+TEST_F(RenderStatsTest, WorkerImbalance_BusiestOverMean) {
+    RenderStats stats;
+    EXPECT_DOUBLE_EQ(WorkerImbalance(stats), 0.0);
+
+    stats.worker_busy = {3ms, 1ms};
+    EXPECT_DOUBLE_EQ(WorkerImbalance(stats), 1.5);
+
+    stats.worker_busy = {2ms, 2ms};
+    EXPECT_DOUBLE_EQ(WorkerImbalance(stats), 1.0);
+}
+
+TEST_F(RenderStatsTest, RenderStatsJson_SingleLineWithAllFields) {
+    CountPixels(frame.stats, frame.pixel_data, frame.settings.max_iterations);
+    frame.render_time = std::chrono::milliseconds{12};
+    frame.stats.worker_busy = {5ms, 7ms};
+
+    const auto json = RenderStatsJson(frame);
+    EXPECT_EQ(json.find('\n'), std::string::npos);
+    EXPECT_EQ(json.front(), '{');
+    EXPECT_EQ(json.back(), '}');
+    for (const char *field : {R"("width":4)", R"("height":2)", R"("render_ms":12)", R"("iterations":45)",
+                              R"("escaped_pixels":5)", R"("interior_pixels":3)", R"("supersampled_pixels":0)",
+                              R"("tiles":0)", R"("worker_busy_us":[5000.0,7000.0])", R"("imbalance":)"}) {
+        EXPECT_NE(json.find(field), std::string::npos) << field;
+    }
+
+    const auto text = FormatRenderStats(frame);
+    EXPECT_NE(text.find("render 12 ms"), std::string::npos);
+    EXPECT_NE(text.find("workers 5.0 7.0 ms"), std::string::npos);
+}
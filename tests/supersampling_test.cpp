@@ -0,0 +1,193 @@
+#include "mandelbrot_sender.hpp"
+#include "supersampling.hpp"
+#include <gtest/gtest.h>
+
+using namespace mandelbrot;
+
+class SupersamplingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        settings = RenderSettings{.width = 48, .height = 32, .max_iterations = 150, .escape_radius = 2.0};
+        settings.supersampling = SupersamplingSettings{.grid = 4, .threshold = 2};
+        viewport = ViewPort{-2.0, 1.0, -1.0, 1.0};
+        frame = RenderResult{.pixel_data = PixelMatrix(settings.width, settings.height),
+                             .color_data = ColorMatrix(settings.width, settings.height),
+                             .viewport = viewport,
+                             .settings = settings};
+        RenderRegion(viewport, settings, Frame(), RenderTarget{frame.pixel_data.View(), frame.color_data.View()});
+    }
+
+    [[nodiscard]] PixelRegion Frame() const {
+        return PixelRegion{.start_row = 0, .end_row = settings.height, .start_col = 0, .end_col = settings.width};
+    }
+
+    [[nodiscard]] AdaptiveSupersampler Supersampler() {
+        return AdaptiveSupersampler{viewport, settings, Precision::DOUBLE, std::as_const(frame.pixel_data).View(),
+                                    frame.color_data.View()};
+    }
+
+    static bool SameColor(const RgbColor &a, const RgbColor &b) { return a.r == b.r && a.g == b.g && a.b == b.b; }
+
+    RenderSettings settings;
+    ViewPort viewport;
+    RenderResult frame;
+};
+
+TEST_F(SupersamplingTest, SrgbLinear_RoundTrip) {
+    for (std::uint32_t value = 0; value < 256; ++value) {
+        EXPECT_EQ(LinearToSrgb(SrgbToLinear(static_cast<std::uint8_t>(value))), value);
+    }
+    EXPECT_FLOAT_EQ(SrgbToLinear(0), 0.0F);
+    EXPECT_FLOAT_EQ(SrgbToLinear(255), 1.0F);
+}
+
+TEST_F(SupersamplingTest, AverageColors_InLinearSpace) {
+    const std::array colors{RgbColor{0, 0, 0}, RgbColor{255, 255, 255}};
+    const auto average = AverageColors(colors);
+
+    // Середина между чёрным и белым по яркости светлее среднего значений sRGB (128)
+    EXPECT_NEAR(average.r, 188, 1);
+    EXPECT_EQ(average.r, average.g);
+    EXPECT_EQ(average.g, average.b);
+    EXPECT_EQ(average.a, 255);
+
+    const std::array same{RgbColor{10, 200, 90}, RgbColor{10, 200, 90}};
+    EXPECT_TRUE(SameColor(AverageColors(same), same[0]));
+}
+
+TEST_F(SupersamplingTest, IsEdgePixel_ComparesSideNeighbours) {
+    PixelMatrix pixels(4, 3, 10);
+    pixels[1][2] = 13;
+    const auto view = std::as_const(pixels).View();
+
+    EXPECT_TRUE(IsEdgePixel(view, 2, 1, 2));
+    EXPECT_TRUE(IsEdgePixel(view, 1, 1, 2));
+    EXPECT_TRUE(IsEdgePixel(view, 3, 1, 2));
+    EXPECT_TRUE(IsEdgePixel(view, 2, 0, 2));
+    EXPECT_TRUE(IsEdgePixel(view, 2, 2, 2));
+    // Сосед по диагонали и разница не выше порога не считаются
+    EXPECT_FALSE(IsEdgePixel(view, 1, 0, 2));
+    EXPECT_FALSE(IsEdgePixel(view, 0, 1, 2));
+    EXPECT_FALSE(IsEdgePixel(view, 2, 1, 3));
+}
+
+TEST_F(SupersamplingTest, JitteredSampleOffset_OneSamplePerCell) {
+    const std::uint32_t grid = 4;
+    for (std::uint32_t sample = 0; sample < grid * grid; ++sample) {
+        const auto offset = JitteredSampleOffset(7, 5, sample, grid);
+        EXPECT_GE(offset.x * grid, sample % grid);
+        EXPECT_LT(offset.x * grid, sample % grid + 1);
+        EXPECT_GE(offset.y * grid, sample / grid);
+        EXPECT_LT(offset.y * grid, sample / grid + 1);
+
+        const auto again = JitteredSampleOffset(7, 5, sample, grid);
+        EXPECT_EQ(offset.x, again.x);
+        EXPECT_EQ(offset.y, again.y);
+    }
+    const auto neighbour = JitteredSampleOffset(8, 5, 0, grid);
+    EXPECT_NE(JitteredSampleOffset(7, 5, 0, grid).x, neighbour.x);
+}
+
+TEST_F(SupersamplingTest, SupersamplingApplies_OnlyWithGridAndColors) {
+    EXPECT_TRUE(SupersamplingApplies(settings, Precision::DOUBLE));
+    EXPECT_TRUE(SupersamplingApplies(settings, Precision::DOUBLE_DOUBLE));
+    EXPECT_FALSE(SupersamplingApplies(settings, Precision::PERTURBATION));
+
+    auto off = settings;
+    off.supersampling.grid = 1;
+    EXPECT_FALSE(SupersamplingApplies(off, Precision::DOUBLE));
+    off.supersampling.grid = 0;
+    EXPECT_FALSE(SupersamplingApplies(off, Precision::DOUBLE));
+
+    auto iterations_only = settings;
+    iterations_only.colorize = false;
+    EXPECT_FALSE(SupersamplingApplies(iterations_only, Precision::DOUBLE));
+}
+
+TEST_F(SupersamplingTest, Render_ChangesOnlyEdgePixels) {
+    const PixelMatrix pixels = frame.pixel_data;
+    const ColorMatrix colors = frame.color_data;
+    const auto view = std::as_const(frame.pixel_data).View();
+
+    const auto supersampled = Supersampler().Render(Frame());
+
+    std::uint64_t edges = 0;
+    bool changed = false;
+    for (std::uint32_t y = 0; y < settings.height; ++y) {
+        for (std::uint32_t x = 0; x < settings.width; ++x) {
+            // Итерации остаются в одну выборку на пиксель
+            EXPECT_EQ(frame.pixel_data[y][x], pixels[y][x]);
+            if (IsEdgePixel(view, x, y, settings.supersampling.threshold)) {
+                ++edges;
+                changed = changed || !SameColor(frame.color_data[y][x], colors[y][x]);
+            } else {
+                EXPECT_TRUE(SameColor(frame.color_data[y][x], colors[y][x])) << "x=" << x << " y=" << y;
+            }
+        }
+    }
+    EXPECT_GT(edges, 0u);
+    EXPECT_LT(edges, std::uint64_t{settings.width} * settings.height);
+    EXPECT_EQ(supersampled, edges);
+    EXPECT_TRUE(changed);
+}
+
+TEST_F(SupersamplingTest, Render_EdgePixelIsLinearAverageOfJitteredSamples) {
+    const auto view = std::as_const(frame.pixel_data).View();
+    std::optional<std::pair<std::uint32_t, std::uint32_t>> edge;
+    for (std::uint32_t y = 0; y < settings.height && !edge; ++y) {
+        for (std::uint32_t x = 0; x < settings.width && !edge; ++x) {
+            if (IsEdgePixel(view, x, y, settings.supersampling.threshold)) {
+                edge = {x, y};
+            }
+        }
+    }
+    ASSERT_TRUE(edge.has_value());
+    const auto [x, y] = *edge;
+
+    std::vector<RgbColor> samples;
+    const auto &palette = CachedPalette(settings);
+    for (std::uint32_t sample = 0; sample < 16; ++sample) {
+        const auto offset = JitteredSampleOffset(x, y, sample, 4);
+        const std::array point{Subpixel2DToComplex(x + offset.x, y + offset.y, viewport, settings.width,
+                                                   settings.height)};
+        std::array<std::uint32_t, 1> iterations{};
+        simd::CalculateIterations(point, iterations, settings.max_iterations, settings.escape_radius,
+                                  settings.interior_checks);
+        samples.push_back(palette[iterations[0]]);
+    }
+
+    (void)Supersampler().Render(Frame());
+    EXPECT_TRUE(SameColor(frame.color_data[y][x], AverageColors(samples)));
+}
+
+TEST_F(SupersamplingTest, Render_UniformRegionUntouched) {
+    // Внутренность главной кардиоиды: все пиксели — точки множества
+    viewport = ViewPort{-0.3, -0.1, -0.1, 0.1};
+    RenderRegion(viewport, settings, Frame(), RenderTarget{frame.pixel_data.View(), frame.color_data.View()});
+    const ColorMatrix colors = frame.color_data;
+
+    EXPECT_EQ(Supersampler().Render(Frame()), 0u);
+    for (std::uint32_t y = 0; y < settings.height; ++y) {
+        for (std::uint32_t x = 0; x < settings.width; ++x) {
+            EXPECT_TRUE(SameColor(frame.color_data[y][x], colors[y][x]));
+        }
+    }
+}
+
+TEST_F(SupersamplingTest, Render_Deterministic) {
+    const RenderResult copy = frame;
+    (void)Supersampler().Render(Frame());
+    const ColorMatrix first = frame.color_data;
+
+    frame = copy;
+    const PixelRegion top{.start_row = 0, .end_row = 16, .start_col = 0, .end_col = settings.width};
+    const PixelRegion bottom{.start_row = 16, .end_row = settings.height, .start_col = 0, .end_col = settings.width};
+    // Порядок плиток не влияет на результат
+    (void)Supersampler().Render(bottom);
+    (void)Supersampler().Render(top);
+    for (std::uint32_t y = 0; y < settings.height; ++y) {
+        for (std::uint32_t x = 0; x < settings.width; ++x) {
+            EXPECT_TRUE(SameColor(frame.color_data[y][x], first[y][x])) << "x=" << x << " y=" << y;
+        }
+    }
+}
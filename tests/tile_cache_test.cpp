@@ -0,0 +1,173 @@
+#include "mandelbrot_sender.hpp"
+#include "tile_cache.hpp"
+#include "types.hpp"
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace mandelbrot;
+
+class TileCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Шаг пикселя 1/64 — точный уровень сетки; кадр 128x128 покрывает ровно 2x2 плитки
+        settings = RenderSettings{.width = 128, .height = 128, .max_iterations = 100, .escape_radius = 2.0};
+        viewport = ViewPort{-2.0, 0.0, -1.0, 1.0};
+        spill_directory = std::filesystem::temp_directory_path() /
+                          ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        std::filesystem::remove_all(spill_directory);
+    }
+
+    void TearDown() override { std::filesystem::remove_all(spill_directory); }
+
+    [[nodiscard]] PixelMatrix Render(const ViewPort &view) const {
+        PixelMatrix pixels(settings.width, settings.height);
+        RenderRegion(view, settings, Frame(), RenderTarget{pixels.View(), {}});
+        return pixels;
+    }
+
+    [[nodiscard]] PixelRegion Frame() const {
+        return PixelRegion{.start_row = 0, .end_row = settings.height, .start_col = 0, .end_col = settings.width};
+    }
+
+    // Кадры соседних видов по горизонтали: каждый со своими 2x2 плитками
+    [[nodiscard]] static ViewPort Neighbour(int index) {
+        return ViewPort{-2.0 + 2.0 * index, 2.0 * index, -1.0, 1.0};
+    }
+
+    RenderSettings settings;
+    ViewPort viewport;
+    std::filesystem::path spill_directory;
+};
+
+TEST_F(TileCacheTest, PlaceOnTileGrid_AlignedViewsOnly) {
+    const auto placement = PlaceOnTileGrid(viewport, settings);
+    ASSERT_TRUE(placement.has_value());
+    EXPECT_EQ(placement->level_x, TileLevel(1.0 / 64));
+    EXPECT_EQ(placement->level_y, TileLevel(1.0 / 64));
+    EXPECT_EQ(placement->x0, -128);
+    EXPECT_EQ(placement->y0, -64);
+
+    // Сдвиг на полпикселя и ненулевой origin кэш не используют
+    const double half_pixel = 0.5 / 64;
+    EXPECT_FALSE(PlaceOnTileGrid(ViewPort{-2.0 + half_pixel, half_pixel, -1.0, 1.0}, settings).has_value());
+    auto rebased = viewport;
+    rebased.origin = FixedPointComplex{FixedPoint{0.25}, FixedPoint{0.0}};
+    EXPECT_FALSE(PlaceOnTileGrid(rebased, settings).has_value());
+}
+
+TEST_F(TileCacheTest, SnapToTileGrid_MovesLessThanPixel) {
+    const ViewPort view{-0.7371, -0.1234, 0.2011, 0.6789};
+    const auto snapped = SnapToTileGrid(view, settings.width, settings.height);
+
+    ASSERT_TRUE(PlaceOnTileGrid(snapped, settings).has_value());
+    const double pixel_width = view.width() / settings.width;
+    const double pixel_height = view.height() / settings.height;
+    EXPECT_LT(std::abs(snapped.x_min - view.x_min), pixel_width);
+    EXPECT_LT(std::abs(snapped.y_min - view.y_min), pixel_height);
+    EXPECT_NEAR(snapped.width(), view.width(), 1e-6 * view.width());
+    EXPECT_NEAR(snapped.height(), view.height(), 1e-6 * view.height());
+}
+
+TEST_F(TileCacheTest, Fill_CopiesCachedTilesAndSplitsRegions) {
+    TileCache cache;
+    const auto pixels = Render(viewport);
+    cache.Store(*PlaceOnTileGrid(viewport, settings), settings, pixels.View());
+    EXPECT_EQ(cache.Stats().tiles, 4u);
+
+    // Вид сдвинут на плитку вправо: левая половина — из кэша, правая считается
+    const ViewPort shifted{-1.0, 1.0, -1.0, 1.0};
+    PixelMatrix frame(settings.width, settings.height);
+    std::vector<PixelRegion> regions{Frame()};
+    EXPECT_EQ(cache.Fill(*PlaceOnTileGrid(shifted, settings), settings, frame.View(), regions), 2u);
+
+    std::uint64_t remaining = 0;
+    for (const auto &region : regions) {
+        EXPECT_GE(region.start_col, 64u);
+        remaining += std::uint64_t{region.width()} * region.height();
+    }
+    EXPECT_EQ(remaining, 64u * 128u);
+
+    const auto expected = Render(shifted);
+    for (std::uint32_t y = 0; y < settings.height; ++y) {
+        for (std::uint32_t x = 0; x < 64; ++x) {
+            EXPECT_EQ(frame[y][x], expected[y][x]) << "x=" << x << " y=" << y;
+        }
+    }
+
+    const auto stats = cache.Stats();
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.misses, 2u);
+
+    // Другое число итераций — другие плитки
+    auto other = settings;
+    other.max_iterations = 50;
+    regions = {Frame()};
+    EXPECT_EQ(cache.Fill(*PlaceOnTileGrid(viewport, other), other, frame.View(), regions), 0u);
+
+    // Другие проверки внутренних точек — тоже другие плитки
+    other = settings;
+    other.interior_checks.periodicity_tolerance = 1e-6;
+    regions = {Frame()};
+    EXPECT_EQ(cache.Fill(*PlaceOnTileGrid(viewport, other), other, frame.View(), regions), 0u);
+    other = settings;
+    other.interior_checks.periodicity = !settings.interior_checks.periodicity;
+    regions = {Frame()};
+    EXPECT_EQ(cache.Fill(*PlaceOnTileGrid(viewport, other), other, frame.View(), regions), 0u);
+}
+
+TEST_F(TileCacheTest, Store_EvictsLeastRecentlyUsedUnderMemoryCap) {
+    TileCache cache{4 * TileCache::TILE_BYTES};
+    const auto first = Render(Neighbour(0));
+    cache.Store(*PlaceOnTileGrid(Neighbour(0), settings), settings, first.View());
+    const auto second = Render(Neighbour(1));
+    cache.Store(*PlaceOnTileGrid(Neighbour(1), settings), settings, second.View());
+
+    const auto stats = cache.Stats();
+    EXPECT_EQ(stats.tiles, 4u);
+    EXPECT_EQ(stats.bytes, 4 * TileCache::TILE_BYTES);
+    EXPECT_EQ(stats.evictions, 4u);
+
+    // Плитки первого кадра вытеснены, второго — на месте
+    PixelMatrix frame(settings.width, settings.height);
+    std::vector<PixelRegion> regions{Frame()};
+    EXPECT_EQ(cache.Fill(*PlaceOnTileGrid(Neighbour(0), settings), settings, frame.View(), regions), 0u);
+    regions = {Frame()};
+    EXPECT_EQ(cache.Fill(*PlaceOnTileGrid(Neighbour(1), settings), settings, frame.View(), regions), 4u);
+    EXPECT_TRUE(regions.empty());
+}
+
+TEST_F(TileCacheTest, EnableSpill_RestoresEvictedTilesFromDisk) {
+    TileCache cache{TileCache::TILE_BYTES};
+    cache.EnableSpill(spill_directory, 64 * TileCache::TILE_BYTES);
+    const auto pixels = Render(viewport);
+    cache.Store(*PlaceOnTileGrid(viewport, settings), settings, pixels.View());
+    EXPECT_EQ(cache.Stats().tiles, 1u);
+
+    PixelMatrix frame(settings.width, settings.height);
+    std::vector<PixelRegion> regions{Frame()};
+    EXPECT_EQ(cache.Fill(*PlaceOnTileGrid(viewport, settings), settings, frame.View(), regions), 4u);
+    EXPECT_TRUE(regions.empty());
+    EXPECT_GE(cache.Stats().disk_hits, 3u);
+    for (std::uint32_t y = 0; y < settings.height; ++y) {
+        for (std::uint32_t x = 0; x < settings.width; ++x) {
+            EXPECT_EQ(frame[y][x], pixels[y][x]) << "x=" << x << " y=" << y;
+        }
+    }
+}
+
+TEST_F(TileCacheTest, SetMaxBytes_ZeroDisablesCache) {
+    TileCache cache;
+    const auto pixels = Render(viewport);
+    const auto placement = *PlaceOnTileGrid(viewport, settings);
+    cache.Store(placement, settings, pixels.View());
+    cache.SetMaxBytes(0);
+    EXPECT_EQ(cache.Stats().tiles, 0u);
+
+    cache.Store(placement, settings, pixels.View());
+    PixelMatrix frame(settings.width, settings.height);
+    std::vector<PixelRegion> regions{Frame()};
+    EXPECT_FALSE(cache.ContainsAny(placement, settings));
+    EXPECT_EQ(cache.Fill(placement, settings, frame.View(), regions), 0u);
+    EXPECT_EQ(regions.size(), 1u);
+}
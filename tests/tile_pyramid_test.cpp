@@ -0,0 +1,122 @@
+#include "tile_pyramid.hpp"
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+
+class TilePyramidTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory = std::filesystem::temp_directory_path() /
+                    ("pyramid_" + std::string{::testing::UnitTest::GetInstance()->current_test_info()->name()});
+        std::filesystem::remove_all(directory);
+        spec = PyramidSpec{.region = mandelbrot::ViewPort{-2.0, 2.0, -2.0, 2.0},
+                           .levels = 3,
+                           .tile_size = 16,
+                           .settings = RenderSettings{.max_iterations = 60, .escape_radius = 2.0}};
+    }
+
+    void TearDown() override { std::filesystem::remove_all(directory); }
+
+    std::filesystem::path directory;
+    PyramidSpec spec;
+};
+
+TEST_F(TilePyramidTest, Manifest_ResumesAndRejectsOtherSpec) {
+    {
+        PyramidManifest manifest{directory, spec};
+        EXPECT_EQ(manifest.Size(), 0);
+        manifest.Add({2, 1, 3});
+        manifest.Add({0, 0, 0});
+    }
+
+    // Повторное открытие восстанавливает отмеченные плитки
+    const PyramidManifest resumed{directory, spec};
+    EXPECT_EQ(resumed.Size(), 2);
+    EXPECT_TRUE(resumed.Contains({2, 1, 3}));
+    EXPECT_FALSE(resumed.Contains({2, 3, 1}));
+
+    PyramidSpec other = spec;
+    other.settings.max_iterations = 61;
+    EXPECT_THROW((PyramidManifest{directory, other}), std::runtime_error);
+
+    other = spec;
+    other.settings.interior_checks.periodicity_tolerance = 1e-10;
+    EXPECT_THROW((PyramidManifest{directory, other}), std::runtime_error);
+
+    other = spec;
+    other.settings.float_kernel = !spec.settings.float_kernel;
+    EXPECT_THROW((PyramidManifest{directory, other}), std::runtime_error);
+}
+
+TEST_F(TilePyramidTest, DownsampleAveragesChildren) {
+    // Четыре однотонные дочерние плитки дают четыре однотонных квадранта
+    for (std::uint32_t y = 0; y < 2; ++y) {
+        for (std::uint32_t x = 0; x < 2; ++x) {
+            const auto value = static_cast<std::uint8_t>(40 * (2 * y + x));
+            const ColorMatrix child(spec.tile_size, spec.tile_size, mandelbrot::RgbColor{value, 1, 2});
+            detail::WritePyramidTile(directory, {1, x, y}, child);
+        }
+    }
+
+    const auto colors = detail::DownsamplePyramidTile(spec, directory, {0, 0, 0});
+    const std::uint32_t half = spec.tile_size / 2;
+    EXPECT_EQ(colors[0][0].r, 0);
+    EXPECT_EQ(colors[0][half].r, 40);
+    EXPECT_EQ(colors[half][0].r, 80);
+    EXPECT_EQ(colors[spec.tile_size - 1][spec.tile_size - 1].r, 120);
+    EXPECT_EQ(colors[3][5].g, 1);
+}
+
+TEST_F(TilePyramidTest, RenderedTileMatchesFullLevel) {
+    // Плитка уровня совпадает с соответствующей частью кадра всего уровня
+    RenderSettings settings = spec.settings;
+    settings.width = 4 * spec.tile_size;
+    settings.height = 4 * spec.tile_size;
+    PixelMatrix pixels(settings.width, settings.height);
+    ColorMatrix colors(settings.width, settings.height);
+    RenderRegion(spec.region, settings,
+                 PixelRegion{.start_row = 0, .end_row = settings.height, .start_col = 0, .end_col = settings.width},
+                 RenderTarget{pixels.View(), colors.View()});
+
+    const auto tile = detail::RenderPyramidTile(spec, {2, 3, 1});
+    for (std::uint32_t y = 0; y < spec.tile_size; ++y) {
+        for (std::uint32_t x = 0; x < spec.tile_size; ++x) {
+            EXPECT_EQ(tile[y][x].g, colors[spec.tile_size + y][3 * spec.tile_size + x].g);
+        }
+    }
+}
+
+TEST_F(TilePyramidTest, GeneratePyramid_WritesAllLevelsAndResumes) {
+    MandelbrotRenderer renderer{2};
+    EXPECT_EQ(GeneratePyramid(renderer, spec, directory), 1 + 4 + 16);
+    for (std::uint32_t level = 0; level < spec.levels; ++level) {
+        for (std::uint32_t y = 0; y < (1U << level); ++y) {
+            for (std::uint32_t x = 0; x < (1U << level); ++x) {
+                EXPECT_TRUE(std::filesystem::exists(PyramidTilePath(directory, {level, x, y})));
+            }
+        }
+    }
+
+    // Повторный запуск: все плитки отмечены в манифесте, ничего не пересчитывается
+    EXPECT_EQ(GeneratePyramid(renderer, spec, directory), 0);
+
+    PyramidSpec too_deep = spec;
+    too_deep.levels = 40;
+    EXPECT_THROW((void)GeneratePyramid(renderer, too_deep, directory), std::invalid_argument);
+}
+
+TEST_F(TilePyramidTest, GeneratePyramid_RejectsLevelsBeyondDoubleDouble) {
+    // Уровень 0 ещё считается в double-double, уровень 2 (64 x 64) требует метода возмущений
+    MandelbrotRenderer renderer{2};
+    spec.region = mandelbrot::ViewPort{-2e-27, 2e-27, -2e-27, 2e-27};
+    ASSERT_EQ(mandelbrot::SelectPrecision(spec.region, spec.tile_size, spec.tile_size),
+              mandelbrot::Precision::DOUBLE_DOUBLE);
+    try {
+        (void)GeneratePyramid(renderer, spec, directory);
+        FAIL() << "expected std::invalid_argument";
+    } catch (const std::invalid_argument &error) {
+        EXPECT_STREQ(error.what(), "pyramid too deep for double-double");
+    }
+    EXPECT_FALSE(std::filesystem::exists(directory / "manifest.txt"));
+}
@@ -0,0 +1,95 @@
+#include "tile_queue.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+class TileQueueTest : public ::testing::Test {
+protected:
+    // Количество выдач каждого пикселя кадра
+    static std::vector<int> Coverage(TileQueue &queue, std::uint32_t width, std::uint32_t height) {
+        std::vector<int> coverage(static_cast<std::size_t>(width) * height, 0);
+        while (const auto tile = queue.Next()) {
+            for (std::uint32_t y = tile->start_row; y < tile->end_row; ++y) {
+                for (std::uint32_t x = tile->start_col; x < tile->end_col; ++x) {
+                    ++coverage[y * width + x];
+                }
+            }
+        }
+        return coverage;
+    }
+};
+
+TEST_F(TileQueueTest, CoversFrameExactlyOnce) {
+    // Размеры не кратны стороне плитки: крайние плитки обрезаются
+    TileQueue queue{100, 70, 32};
+
+    EXPECT_EQ(queue.size(), 4 * 3);
+
+    const auto coverage = Coverage(queue, 100, 70);
+    for (const auto count : coverage) {
+        EXPECT_EQ(count, 1);
+    }
+    EXPECT_FALSE(queue.Next().has_value());
+}
+
+TEST_F(TileQueueTest, EdgeTilesAreClipped) {
+    TileQueue queue{100, 70, 32};
+
+    const auto last = queue.Tile(queue.size() - 1);
+    EXPECT_EQ(last.start_row, 64);
+    EXPECT_EQ(last.end_row, 70);
+    EXPECT_EQ(last.start_col, 96);
+    EXPECT_EQ(last.end_col, 100);
+}
+
+TEST_F(TileQueueTest, Regions_CoverOnlyGivenAreas) {
+    // L-образная область, как после сдвига вида вправо и вниз; пустая область плиток не даёт
+    const PixelRegion bottom{.start_row = 60, .end_row = 70, .start_col = 0, .end_col = 100};
+    const PixelRegion right{.start_row = 0, .end_row = 60, .start_col = 90, .end_col = 100};
+    const PixelRegion empty{.start_row = 10, .end_row = 10, .start_col = 0, .end_col = 100};
+    TileQueue queue{{bottom, empty, right}, 32};
+
+    EXPECT_EQ(queue.size(), 4 + 2);
+    EXPECT_EQ(queue.Tile(4).start_col, 90);
+
+    const auto coverage = Coverage(queue, 100, 70);
+    for (std::uint32_t y = 0; y < 70; ++y) {
+        for (std::uint32_t x = 0; x < 100; ++x) {
+            EXPECT_EQ(coverage[y * 100 + x], y >= 60 || x >= 90 ? 1 : 0) << "x=" << x << " y=" << y;
+        }
+    }
+}
+
+TEST_F(TileQueueTest, ZeroTileSize_TreatedAsOne) {
+    TileQueue queue{3, 2, 0};
+    EXPECT_EQ(queue.size(), 6);
+}
+
+TEST_F(TileQueueTest, EmptyFrame_HasNoTiles) {
+    TileQueue queue{0, 0, 16};
+    EXPECT_EQ(queue.size(), 0);
+    EXPECT_FALSE(queue.Next().has_value());
+}
+
+TEST_F(TileQueueTest, ConcurrentWorkers_EachTileOnce) {
+    TileQueue queue{256, 256, 8};
+    std::vector<std::vector<PixelRegion>> taken(4);
+
+    std::vector<std::thread> workers;
+    for (auto &worker_tiles : taken) {
+        workers.emplace_back([&queue, &worker_tiles] {
+            while (const auto tile = queue.Next()) {
+                worker_tiles.push_back(*tile);
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    std::size_t total = 0;
+    for (const auto &worker_tiles : taken) {
+        total += worker_tiles.size();
+    }
+    EXPECT_EQ(total, queue.size());
+}
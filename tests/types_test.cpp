@@ -24,6 +24,19 @@ TEST_F(TypesTest, RenderSettings_CustomValues) {
     EXPECT_DOUBLE_EQ(settings.escape_radius, 3.0);
 }
 
+TEST_F(TypesTest, UseFloatKernel_FollowsSettingAndDepth) {
+    RenderSettings settings;
+    const mandelbrot::ViewPort home{-2.5, 1.5, -2.0, 2.0};
+    const mandelbrot::ViewPort deep{-0.75, -0.75 + 1e-6, 0.1, 0.1 + 1e-6};
+
+    EXPECT_TRUE(settings.float_kernel);
+    EXPECT_TRUE(UseFloatKernel(home, settings));
+    EXPECT_FALSE(UseFloatKernel(deep, settings));
+
+    settings.float_kernel = false;
+    EXPECT_FALSE(UseFloatKernel(home, settings));
+}
+
 TEST_F(TypesTest, PixelRegion_DefaultValues) {
     PixelRegion region;
 
@@ -43,8 +56,8 @@ TEST_F(TypesTest, PixelRegion_CustomValues) {
 }
 
 TEST_F(TypesTest, RenderResult_Structure) {
-    PixelMatrix pixel_data(2, std::vector<std::uint32_t>(3));
-    ColorMatrix color_data(2, std::vector<mandelbrot::RgbColor>(3));
+    PixelMatrix pixel_data(3, 2);
+    ColorMatrix color_data(3, 2);
     mandelbrot::ViewPort viewport{-1.0, 1.0, -1.0, 1.0};
     RenderSettings settings{100, 100, 50, 2.0};
     std::chrono::milliseconds render_time{100};
@@ -101,10 +114,8 @@ TEST_F(TypesTest, AppState_CustomValues) {
     EXPECT_FALSE(state.should_exit);
 }
 
-TEST_F(TypesTest, ThreadPoolSize_Constant) { EXPECT_EQ(THREAD_POOL_SIZE, 8); }
-
 TEST_F(TypesTest, PixelMatrix_Type) {
-    PixelMatrix matrix(2, std::vector<std::uint32_t>(3, 42));
+    PixelMatrix matrix(3, 2, 42);
 
     EXPECT_EQ(matrix.size(), 2);
     EXPECT_EQ(matrix[0].size(), 3);
@@ -114,7 +125,7 @@ TEST_F(TypesTest, PixelMatrix_Type) {
 
 TEST_F(TypesTest, ColorMatrix_Type) {
     mandelbrot::RgbColor test_color{255, 128, 64};
-    ColorMatrix matrix(2, std::vector<mandelbrot::RgbColor>(3, test_color));
+    ColorMatrix matrix(3, 2, test_color);
 
     EXPECT_EQ(matrix.size(), 2);
     EXPECT_EQ(matrix[0].size(), 3);
@@ -122,3 +133,32 @@ TEST_F(TypesTest, ColorMatrix_Type) {
     EXPECT_EQ(matrix[0][0].g, 128);
     EXPECT_EQ(matrix[0][0].b, 64);
 }
+
+TEST_F(TypesTest, FrameBuffer_ContiguousRows) {
+    PixelMatrix matrix(4, 3);
+
+    // Строки лежат в одной непрерывной аллокации с шагом width
+    EXPECT_EQ(matrix.stride(), 4);
+    EXPECT_EQ(matrix[1].data(), matrix.data() + 4);
+    EXPECT_EQ(matrix[2].data(), matrix.data() + 8);
+    EXPECT_FALSE(matrix.empty());
+    EXPECT_TRUE(PixelMatrix{}.empty());
+}
+
+TEST_F(TypesTest, FrameView_SubViewWritesToParent) {
+    PixelMatrix matrix(4, 3);
+    PixelRegion region{.start_row = 1, .end_row = 3, .start_col = 2, .end_col = 4};
+
+    auto view = matrix.View(region);
+    EXPECT_EQ(view.width(), 2);
+    EXPECT_EQ(view.height(), 2);
+    EXPECT_EQ(view.stride(), matrix.stride());
+
+    view(0, 0) = 7;
+    view[1][1] = 9;
+
+    // Запись через представление попадает в родительский буфер без копирования
+    EXPECT_EQ(matrix[1][2], 7);
+    EXPECT_EQ(matrix[2][3], 9);
+    EXPECT_EQ(matrix[0][0], 0);
+}
@@ -0,0 +1,80 @@
+#include "video_writer.hpp"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+class VideoWriterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = std::filesystem::temp_directory_path() /
+               (std::string{::testing::UnitTest::GetInstance()->current_test_info()->name()} + ".video");
+    }
+
+    void TearDown() override { std::filesystem::remove(path); }
+
+    [[nodiscard]] std::string ReadFile() const {
+        std::ifstream file{path, std::ios::binary};
+        return std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    }
+
+    // Кадр 2x1 из двух цветов
+    [[nodiscard]] static ColorMatrix Frame(mandelbrot::RgbColor left, mandelbrot::RgbColor right) {
+        ColorMatrix colors(2, 1);
+        colors[0][0] = left;
+        colors[0][1] = right;
+        return colors;
+    }
+
+    std::filesystem::path path;
+};
+
+TEST_F(VideoWriterTest, RgbToYCbCr_KnownColors) {
+    const auto black = RgbToYCbCr({0, 0, 0});
+    EXPECT_EQ(black.y, 0);
+    EXPECT_EQ(black.cb, 128);
+    EXPECT_EQ(black.cr, 128);
+
+    const auto white = RgbToYCbCr({255, 255, 255});
+    EXPECT_EQ(white.y, 255);
+    EXPECT_EQ(white.cb, 128);
+    EXPECT_EQ(white.cr, 128);
+
+    // Насыщенные цвета: 0,5 * 255 + 128 округляется до 256 и обрезается
+    const auto blue = RgbToYCbCr({0, 0, 255});
+    EXPECT_EQ(blue.y, 29);
+    EXPECT_EQ(blue.cb, 255);
+    const auto red = RgbToYCbCr({255, 0, 0});
+    EXPECT_EQ(red.y, 76);
+    EXPECT_EQ(red.cr, 255);
+    EXPECT_EQ(red.cb, 85);
+}
+
+TEST_F(VideoWriterTest, Y4m_HeaderAndPlanes) {
+    VideoWriter writer{path, VideoFormat::Y4M, 2, 1, 25};
+    writer.WriteFrame(Frame({0, 0, 0}, {255, 255, 255}));
+    writer.WriteFrame(Frame({255, 255, 255}, {0, 0, 0}));
+    writer.Close();
+    EXPECT_EQ(writer.FramesWritten(), 2);
+
+    const std::string header = "YUV4MPEG2 W2 H1 F25:1 Ip A1:1 C444 XCOLORRANGE=FULL\n";
+    const std::string first = std::string{"FRAME\n"} + std::string{'\x00', '\xff', '\x80', '\x80', '\x80', '\x80'};
+    const std::string second = std::string{"FRAME\n"} + std::string{'\xff', '\x00', '\x80', '\x80', '\x80', '\x80'};
+    EXPECT_EQ(ReadFile(), header + first + second);
+}
+
+TEST_F(VideoWriterTest, RawRgb_FramesWithoutHeaders) {
+    VideoWriter writer{path, VideoFormat::RAW_RGB, 2, 1, 30};
+    writer.WriteFrame(Frame({1, 2, 3}, {4, 5, 6}));
+    writer.Close();
+
+    EXPECT_EQ(ReadFile(), (std::string{'\x01', '\x02', '\x03', '\x04', '\x05', '\x06'}));
+}
+
+TEST_F(VideoWriterTest, WrongFrameSize_Throws) {
+    VideoWriter writer{path, VideoFormat::Y4M, 2, 1, 30};
+    EXPECT_THROW(writer.WriteFrame(ColorMatrix(3, 1)), std::runtime_error);
+    EXPECT_THROW((VideoWriter{"/nonexistent/video.y4m", VideoFormat::Y4M, 2, 1, 30}), std::runtime_error);
+}
@@ -0,0 +1,97 @@
+#include "zoom_animation.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <stdexec/execution.hpp>
+#include <vector>
+
+using namespace mandelbrot;
+
+class ZoomAnimationTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        animation.settings = RenderSettings{.width = 48, .height = 32, .max_iterations = 100, .escape_radius = 2.0};
+        animation.frames_in_flight = 3;
+    }
+
+    [[nodiscard]] static ZoomPath Path(std::uint32_t frames) {
+        return ZoomPath::Between(ZoomView{.center = {FixedPoint{-0.5}, FixedPoint{0.0}}, .span = 4.0},
+                                 ZoomView{.center = {FixedPoint{-0.75}, FixedPoint{0.1}}, .span = 0.01}, frames);
+    }
+
+    AnimationSettings animation;
+};
+
+TEST_F(ZoomAnimationTest, MakeAnimationFrame_FollowsPath) {
+    const auto path = Path(5);
+    const auto first = MakeAnimationFrame(path, animation, 0);
+    EXPECT_EQ(first.viewport.origin, path.At(0).center);
+    EXPECT_DOUBLE_EQ(first.viewport.width(), 4.0);
+    EXPECT_DOUBLE_EQ(first.viewport.height(), 4.0 * 32 / 48);
+    EXPECT_EQ(first.settings.max_iterations, 100);
+
+    const auto last = MakeAnimationFrame(path, animation, 4);
+    EXPECT_DOUBLE_EQ(last.viewport.width(), 0.01);
+    EXPECT_EQ(last.settings.max_iterations, 100);
+}
+
+TEST_F(ZoomAnimationTest, MakeAnimationFrame_AutoIterationsGrowWithDepth) {
+    animation.auto_iterations = true;
+    const auto path = Path(5);
+
+    EXPECT_EQ(MakeAnimationFrame(path, animation, 0).settings.max_iterations, 100);
+    EXPECT_GT(MakeAnimationFrame(path, animation, 4).settings.max_iterations,
+              MakeAnimationFrame(path, animation, 2).settings.max_iterations);
+}
+
+TEST_F(ZoomAnimationTest, RenderZoomAnimation_FramesInOrderMatchSingleFrames) {
+    const auto path = Path(7);
+    MandelbrotRenderer renderer{4};
+
+    std::vector<std::uint32_t> indices;
+    RenderZoomAnimation(renderer, path, animation, [&](const RenderResult &frame, std::uint32_t index) {
+        indices.push_back(index);
+
+        // Тот же кадр, посчитанный отдельно, совпадает побитово
+        const auto expected = MakeAnimationFrame(path, animation, index);
+        MandelbrotRenderer single{1};
+        auto result = stdexec::sync_wait(single.RenderAsync(expected.viewport, expected.settings));
+        ASSERT_TRUE(result.has_value());
+        const auto &reference = std::get<0>(result.value());
+        ASSERT_EQ(frame.color_data.width(), 48);
+        ASSERT_EQ(frame.color_data.height(), 32);
+        for (std::uint32_t y = 0; y < 32; ++y) {
+            for (std::uint32_t x = 0; x < 48; ++x) {
+                EXPECT_EQ(frame.pixel_data[y][x], reference.pixel_data[y][x]);
+            }
+        }
+    });
+    EXPECT_EQ(indices, (std::vector<std::uint32_t>{0, 1, 2, 3, 4, 5, 6}));
+}
+
+TEST_F(ZoomAnimationTest, RenderZoomAnimation_SinkErrorStopsAnimation) {
+    MandelbrotRenderer renderer{2};
+    std::uint32_t written = 0;
+    EXPECT_THROW(RenderZoomAnimation(renderer, Path(10), animation,
+                                     [&](const RenderResult &, std::uint32_t index) {
+                                         if (index == 2) {
+                                             throw std::runtime_error{"disk full"};
+                                         }
+                                         ++written;
+                                     }),
+                 std::runtime_error);
+    EXPECT_EQ(written, 2);
+}
+
+TEST_F(ZoomAnimationTest, RenderAsync_IndependentFramesDoNotCancelEachOther) {
+    MandelbrotRenderer renderer{2};
+    const auto path = Path(2);
+    const auto first = MakeAnimationFrame(path, animation, 0);
+    const auto second = MakeAnimationFrame(path, animation, 1);
+
+    auto result = stdexec::sync_wait(
+        stdexec::when_all(renderer.RenderAsync(first.viewport, first.settings, 0, FrameKind::INDEPENDENT),
+                          renderer.RenderAsync(second.viewport, second.settings, 0, FrameKind::INDEPENDENT)));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_DOUBLE_EQ(std::get<0>(result.value()).viewport.width(), 4.0);
+    EXPECT_DOUBLE_EQ(std::get<1>(result.value()).viewport.width(), 0.01);
+}
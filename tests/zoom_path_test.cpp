@@ -0,0 +1,138 @@
+#include "zoom_path.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+using namespace mandelbrot;
+
+class ZoomPathTest : public ::testing::Test {
+protected:
+    [[nodiscard]] static ZoomView View(double real, double imag, double span) {
+        return ZoomView{.center = {FixedPoint{real}, FixedPoint{imag}}, .span = span};
+    }
+
+    [[nodiscard]] static double Real(const ZoomView &view) { return view.center.real.ToDouble(); }
+    [[nodiscard]] static double Imag(const ZoomView &view) { return view.center.imag.ToDouble(); }
+};
+
+TEST_F(ZoomPathTest, InterpolateZoom_Endpoints) {
+    const auto from = View(-0.5, 0.0, 4.0);
+    const auto to = View(-0.75, 0.1, 1e-3);
+
+    const auto start = InterpolateZoom(from, to, 0.0);
+    EXPECT_DOUBLE_EQ(start.span, 4.0);
+    EXPECT_DOUBLE_EQ(Real(start), -0.5);
+    EXPECT_DOUBLE_EQ(Imag(start), 0.0);
+
+    const auto end = InterpolateZoom(from, to, 1.0);
+    EXPECT_NEAR(end.span, 1e-3, 1e-15);
+    EXPECT_DOUBLE_EQ(Real(end), -0.75);
+    EXPECT_DOUBLE_EQ(Imag(end), 0.1);
+}
+
+TEST_F(ZoomPathTest, InterpolateZoom_SpanIsExponential) {
+    const auto from = View(0.0, 0.0, 4.0);
+    const auto to = View(0.0, 0.0, 4e-4);
+
+    // Середина пути по времени — среднее геометрическое ширин
+    EXPECT_NEAR(InterpolateZoom(from, to, 0.5).span, 4e-2, 1e-15);
+    EXPECT_NEAR(InterpolateZoom(from, to, 0.25).span, 0.4, 1e-14);
+}
+
+TEST_F(ZoomPathTest, InterpolateZoom_CenterMovesAtConstantScreenSpeed) {
+    const auto from = View(0.0, 0.0, 1.0);
+    const auto to = View(1.0, 0.0, 1e-6);
+
+    // Сдвиг центра за шаг в ширинах вида одинаков на всём пути
+    constexpr int STEPS = 10;
+    std::vector<double> speeds;
+    for (int step = 0; step < STEPS; ++step) {
+        const auto a = InterpolateZoom(from, to, static_cast<double>(step) / STEPS);
+        const auto b = InterpolateZoom(from, to, static_cast<double>(step + 1) / STEPS);
+        // Сдвиг относительно ширины в середине шага
+        speeds.push_back((Real(b) - Real(a)) / std::sqrt(a.span * b.span));
+    }
+    for (const double speed : speeds) {
+        EXPECT_NEAR(speed / speeds.front(), 1.0, 1e-6);
+    }
+}
+
+TEST_F(ZoomPathTest, InterpolateZoom_DeepEndKeepsPrecision) {
+    // К концу глубокого приближения центр отличается от конечного меньше, чем на ширину вида
+    const auto from = View(-0.5, 0.0, 4.0);
+    ZoomView to{.center = {FixedPoint::FromString("-0.743643887037158704752191506114774"),
+                           FixedPoint::FromString("0.131825904205311970493132056385139")},
+                .span = 1e-30};
+
+    const auto view = InterpolateZoom(from, to, 0.999);
+    const FixedPoint offset = view.center.real - to.center.real;
+    EXPECT_LT(std::abs(offset.ToDouble()), view.span);
+    EXPECT_GT(view.span, to.span);
+}
+
+TEST_F(ZoomPathTest, InterpolateZoom_EqualSpansMoveLinearly) {
+    const auto view = InterpolateZoom(View(0.0, 0.0, 2.0), View(1.0, -1.0, 2.0), 0.25);
+    EXPECT_DOUBLE_EQ(view.span, 2.0);
+    EXPECT_DOUBLE_EQ(Real(view), 0.25);
+    EXPECT_DOUBLE_EQ(Imag(view), -0.25);
+}
+
+TEST_F(ZoomPathTest, ZoomPath_FramesAndKeyframes) {
+    const ZoomPath path{{ZoomKeyframe{.frame = 0, .view = View(0.0, 0.0, 4.0)},
+                         ZoomKeyframe{.frame = 10, .view = View(-1.0, 0.0, 0.4)},
+                         ZoomKeyframe{.frame = 20, .view = View(-1.0, 0.0, 0.4)}}};
+
+    EXPECT_EQ(path.FrameCount(), 21);
+    EXPECT_DOUBLE_EQ(path.At(0).span, 4.0);
+    EXPECT_NEAR(path.At(5).span, 4.0 / std::sqrt(10.0), 1e-12);
+    EXPECT_DOUBLE_EQ(Real(path.At(10)), -1.0);
+    EXPECT_DOUBLE_EQ(path.At(15).span, 0.4);
+    EXPECT_DOUBLE_EQ(path.At(100).span, 0.4);
+}
+
+TEST_F(ZoomPathTest, ZoomPath_Between) {
+    const auto path = ZoomPath::Between(View(0.0, 0.0, 4.0), View(1.0, 0.0, 1.0), 3);
+    EXPECT_EQ(path.FrameCount(), 3);
+    EXPECT_DOUBLE_EQ(path.At(1).span, 2.0);
+
+    EXPECT_EQ(ZoomPath::Between(View(0.0, 0.0, 4.0), View(1.0, 0.0, 1.0), 1).FrameCount(), 1);
+    EXPECT_THROW((void)ZoomPath::Between(View(0.0, 0.0, 4.0), View(1.0, 0.0, 1.0), 0), std::invalid_argument);
+}
+
+TEST_F(ZoomPathTest, ZoomPath_InvalidKeyframes) {
+    EXPECT_THROW(ZoomPath{{}}, std::invalid_argument);
+    EXPECT_THROW((ZoomPath{{ZoomKeyframe{.frame = 1, .view = View(0.0, 0.0, 4.0)}}}), std::invalid_argument);
+    EXPECT_THROW((ZoomPath{{ZoomKeyframe{.frame = 0, .view = View(0.0, 0.0, 4.0)},
+                            ZoomKeyframe{.frame = 0, .view = View(0.0, 0.0, 1.0)}}}),
+                 std::invalid_argument);
+    EXPECT_THROW((ZoomPath{{ZoomKeyframe{.frame = 0, .view = View(0.0, 0.0, 0.0)}}}), std::invalid_argument);
+}
+
+TEST_F(ZoomPathTest, ParseKeyframes_SkipsCommentsAndBlankLines) {
+    std::istringstream input{"# frame re im span\n"
+                             "0 -0.5 0 4\n"
+                             "\n"
+                             "120 -0.743643887037158704752191506114774 0.131825904205311970493132056385139 1e-20\n"};
+    const auto path = ParseKeyframes(input);
+
+    ASSERT_EQ(path.Keyframes().size(), 2);
+    EXPECT_EQ(path.FrameCount(), 121);
+    EXPECT_DOUBLE_EQ(path.Keyframes()[1].view.span, 1e-20);
+    EXPECT_EQ(path.Keyframes()[1].view.center.real,
+              FixedPoint::FromString("-0.743643887037158704752191506114774"));
+}
+
+TEST_F(ZoomPathTest, ParseKeyframes_Errors) {
+    auto parse = [](const char *text) {
+        std::istringstream input{text};
+        return ParseKeyframes(input);
+    };
+    EXPECT_THROW((void)parse("0 -0.5 0\n"), std::invalid_argument);
+    EXPECT_THROW((void)parse("0 -0.5 0 4 extra\n"), std::invalid_argument);
+    EXPECT_THROW((void)parse("first -0.5 0 4\n"), std::invalid_argument);
+    EXPECT_THROW((void)parse("0 -0.5 0 4\n10 x 0 1\n"), std::invalid_argument);
+    EXPECT_THROW((void)parse(""), std::invalid_argument);
+    EXPECT_THROW((void)ReadKeyframes("/nonexistent/keyframes.txt"), std::runtime_error);
+}